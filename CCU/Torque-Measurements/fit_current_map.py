@@ -0,0 +1,118 @@
+"""
+Fit per-wheel speed -> current maps for TorqueControl from logged runs.
+
+Rows from speed control runs (mode 0 and 3, MUxvalue in m/s) and RPM runs (mode 2,
+converted to m/s) are binned by each wheel's measured speed. The mean current of every
+bin becomes a breakpoint, bins without enough samples are interpolated from their
+neighbours. The output is one line per wheel, as read by TorqueControl::loadMaps():
+
+    wheel,v_min,v_max,c0,c1,...,cN-1
+
+Usage:
+    python fit_current_map.py "Torque-Measurements/*.csv" --points 8 --out TQMAP.TXT
+
+Copy TQMAP.TXT to the SD card of the CCU, or send each line prefixed with TQMAP: over TCP.
+"""
+
+import argparse
+import glob
+import os
+
+import numpy as np
+import pandas as pd
+
+WHEEL_DIAMETER = 0.068  # m, d_wheel in CCU/src/kinematic.h
+MAX_POINTS = 16         # TORQUE_MAP_POINTS in CCU/src/torqueControl.h
+
+
+def load_samples(patterns, skip_rows):
+    """Return (speed, current) arrays per wheel in m/s and A."""
+    speeds = [[] for _ in range(4)]
+    currents = [[] for _ in range(4)]
+    files = sorted(f for pattern in patterns for f in glob.glob(pattern))
+    for file in files:
+        try:
+            df = pd.read_csv(file)
+        except Exception as e:
+            print(f"{os.path.basename(file)}: {e}, skipping.")
+            continue
+        df.columns = df.columns.str.strip()
+        needed = ['mode'] + [f'MU{i}value' for i in range(4)] + [f'MU{i}current' for i in range(4)]
+        if not all(col in df.columns for col in needed):
+            print(f"{os.path.basename(file)}: missing required columns, skipping.")
+            continue
+
+        df = df.iloc[skip_rows:]  # Start-up transient
+        for mode, scale in ((0, 1.0), (3, 1.0), (2, np.pi * WHEEL_DIAMETER / 60.0)):
+            rows = df[df['mode'] == mode]
+            for i in range(4):
+                speeds[i].append(rows[f'MU{i}value'].to_numpy(dtype=float) * scale)
+                currents[i].append(rows[f'MU{i}current'].to_numpy(dtype=float))
+        print(f"{os.path.basename(file)}: {len(df)} rows")
+
+    return ([np.concatenate(s) if s else np.array([]) for s in speeds],
+            [np.concatenate(c) if c else np.array([]) for c in currents])
+
+
+def fit_wheel(speed, current, v_min, v_max, points, min_samples):
+    """Mean current at uniformly spaced breakpoints, None if there is too little data."""
+    breakpoints = np.linspace(v_min, v_max, points)
+    half_bin = (breakpoints[1] - breakpoints[0]) / 2
+    values = np.full(points, np.nan)
+    for k, v in enumerate(breakpoints):
+        in_bin = np.abs(speed - v) <= half_bin
+        if np.count_nonzero(in_bin) >= min_samples:
+            values[k] = current[in_bin].mean()
+
+    known = ~np.isnan(values)
+    if np.count_nonzero(known) < 2:
+        return None
+    # np.interp holds the end values outside the known bins
+    return np.interp(breakpoints, breakpoints[known], values[known])
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Fit TorqueControl current maps from CCU logs")
+    parser.add_argument('patterns', nargs='+', help="CSV files or glob patterns")
+    parser.add_argument('--points', type=int, default=8, help=f"Breakpoints per wheel (2..{MAX_POINTS})")
+    parser.add_argument('--vmin', type=float, help="First breakpoint (m/s), default 5th percentile")
+    parser.add_argument('--vmax', type=float, help="Last breakpoint (m/s), default 95th percentile")
+    parser.add_argument('--min-samples', type=int, default=20, help="Samples needed for a breakpoint")
+    parser.add_argument('--skip-rows', type=int, default=20, help="Rows skipped at the start of each log")
+    parser.add_argument('--out', default='TQMAP.TXT', help="Output file for the SD card")
+    args = parser.parse_args()
+
+    if not 2 <= args.points <= MAX_POINTS:
+        parser.error(f"--points must be between 2 and {MAX_POINTS}")
+
+    speeds, currents = load_samples(args.patterns, args.skip_rows)
+    all_speeds = np.concatenate(speeds)
+    moving = all_speeds[all_speeds > 0]
+    if moving.size == 0:
+        print("No speed or RPM mode rows found.")
+        return
+    v_min = args.vmin if args.vmin is not None else float(np.percentile(moving, 5))
+    v_max = args.vmax if args.vmax is not None else float(np.percentile(moving, 95))
+    if v_max <= v_min:
+        print(f"Speed range {v_min:.3f}..{v_max:.3f} m/s is empty.")
+        return
+
+    lines = ["# wheel,v_min,v_max,currents... fitted by fit_current_map.py"]
+    for i in range(4):
+        fit = fit_wheel(speeds[i], currents[i], v_min, v_max, args.points, args.min_samples)
+        if fit is None:
+            print(f"MU{i}: not enough samples, wheel keeps the linear fit")
+            continue
+        line = f"{i},{v_min:.3f},{v_max:.3f}," + ",".join(f"{c:.3f}" for c in fit)
+        lines.append(line)
+        print(f"MU{i}: {' '.join(f'{c:.3f}' for c in fit)} A")
+
+    with open(args.out, 'w') as f:
+        f.write("\n".join(lines) + "\n")
+    print(f"\nWrote {args.out}, TCP commands:")
+    for line in lines[1:]:
+        print(f"TQMAP:{line}")
+
+
+if __name__ == '__main__':
+    main()
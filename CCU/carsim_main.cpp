@@ -0,0 +1,536 @@
+/*
+ * carsim - closed-loop simulation of the car: the CCU firmware (src/) and the MUs' control loop
+ * (MU/src) against a model of the body, wheels, motors and BMX160, in randomised batches.
+ *
+ * Usage: carsim [options]
+ *   --runs N               Scenarios                             (default 64)
+ *   --jobs N               Scenarios run at once                 (default all cores)
+ *   --seed N               Seed of the first scenario, run k uses seed + k (default 1)
+ *   --seconds S            Driving time after START, at most AUTO_STOP_TIME (default 15)
+ *   --settle S             Start of the metrics after START      (default 3)
+ *   --mode M               0 ICO yaw, 2 wheel rpm, 3 velocity    (default 0)
+ *   --setpoint X           m/s (mode 0, 3) or rpm (mode 2)       (default 0.3)
+ *   --radius R             setpoint_radius (m)                   (default 0.5)
+ *   --pid kp,ki,kd         MU gains sent with PID:               (default 1,10,0.01)
+ *   --mass A[:B]           kg                                    (default 1.2:1.8)
+ *   --friction A[:B]       Tyre-road friction coefficient        (default 0.6:1.0)
+ *   --gyro-noise A[:B]     dps RMS per sample                    (default 0.05:0.2)
+ *   --omega0 A[:B]         ICO reflex weight                     (default 0.2)
+ *   --omega1 A[:B]         ICO predictive start weight           (default 0.4)
+ *   --eta A[:B]            ICO learning rate, drawn log-uniform  (default 1e-4)
+ *   --mu-latency A[:B]     us added to every MU transaction      (default 0)
+ *   --mu-nack A[:B]        Share of MU transactions not acknowledged (default 0)
+ *   --mu-bit-error A[:B]   Probability of a flipped bit on the MU wire (default 0)
+ *   --csv FILE             One row per run
+ *   --logs DIR             SD card of run k in DIR/run_k (data.csv), default no card
+ *   --top N                Best runs to list                     (default 5)
+ *
+ * Every scenario runs in its own process, the firmware keeps its state in globals. A run boots
+ * the CCU, waits for the IMU calibration of the standing car, sends SET:/PID: and START like
+ * the control client and drives for --seconds. The plant and the MUs step at 1 ms, the CCU's
+ * control tick fires at its AGTimer period and its I2C transactions take their time on the bus.
+ * The MU faults act from power-up; a run stalls if loop() does not get a pass for
+ * CARSIM_STALL_MS, e.g. because the tick no longer ends or the bus queue never drains.
+ *
+ * Example: ./carsim --runs 256 --eta 1e-5:1e-3 --csv eta.csv
+ *          ./carsim --runs 64 --mode 3 --mu-nack 0:0.3 --mu-bit-error 0:1e-3 --csv faults.csv
+ */
+
+#include <Arduino.h>
+#include <SD.h>
+#include <Wire.h>
+#include <WiFiS3.h>
+#include "host/hostTimer.h"
+#include "host/vehicleSim.h"
+#include "src/i2cBus.h"
+#include "src/imuCalibration.h"
+#include "src/ICO_algo.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// From src/main.cpp
+void setup();
+void loop();
+void handleClientCommunication(WiFiClient &client);
+extern I2CBus i2cBus;
+extern ImuCalibration imuCalibration;
+extern ICOAlgo ico_yaw;
+
+#define CARSIM_MAX_SECONDS 20       // AUTO_STOP_TIME of main.cpp
+#define CARSIM_CAL_TIMEOUT_MS 40000 // IMU_CAL_TIMEOUT plus the boot
+#define CARSIM_COMMAND_MS 100       // Time for queued MU writes before the next command
+#define CARSIM_MAX_SPEED 10.0f      // m/s, beyond this the run counts as diverged
+#define CARSIM_MAX_YAW_RATE 3000.0f // dps
+#define CARSIM_STALL_MS 500         // Longest time loop() may go without a pass
+
+struct Range {
+    double low;
+    double high;
+};
+
+enum RunStatus : int32_t {
+    RUN_PENDING, RUN_OK, RUN_DIVERGED, RUN_NO_CALIBRATION, RUN_STALLED, RUN_CRASHED, RUN_STATUSES
+};
+static const char *const run_status_names[RUN_STATUSES] = {"PENDING", "OK", "DIVERGED", "NO_CAL", "STALLED", "CRASHED"};
+
+struct Scenario {
+    uint32_t seed;
+    float mass;
+    float friction;
+    float gyro_noise;
+    float omega0;
+    float omega1;
+    float eta;
+    HostWireFaults mu_faults;
+};
+
+// Written by the run's process into shared memory, plain data only
+struct RunResult {
+    int32_t status;
+    float yaw_rms;              // dps, true yaw rate against the commanded one
+    float speed_rms;            // m/s
+    float curvature_error;      // 1/m, mean path curvature against the commanded one
+    float max_slip;             // m/s
+    float ico_weight;           // First predictive weight of ico_yaw at the end
+    float residual_bias;        // dps of gyro z offset the calibration left
+    uint32_t tick_max_us;       // Longest control tick
+    uint32_t tick_p99_us;
+    uint32_t ticks_late;        // Ticks that started late because the previous one overran
+    uint32_t loop_gap_max_us;   // Longest time without a pass of loop()
+    uint32_t i2c_errors;        // Failed transactions as I2CBus counts them
+    uint32_t corrupted;         // MU transactions with flipped bits, which I2C does not detect
+    float wall_ms;
+};
+
+struct Options {
+    int runs = 64;
+    int jobs = 0;
+    uint32_t seed = 1;
+    float seconds = 15;
+    float settle = 3;
+    int mode = 0;
+    float setpoint = 0.3f;
+    float radius = 0.5f;
+    float kp = 1, ki = 10, kd = 0.01f;
+    Range mass = {1.2, 1.8};
+    Range friction = {0.6, 1.0};
+    Range gyro_noise = {0.05, 0.2};
+    Range omega0 = {0.2, 0.2};
+    Range omega1 = {0.4, 0.4};
+    Range eta = {1e-4, 1e-4};
+    Range mu_latency = {0, 0};
+    Range mu_nack = {0, 0};
+    Range mu_bit_error = {0, 0};
+    const char *csv = nullptr;
+    const char *logs = nullptr;
+    size_t top = 5;
+};
+
+static bool parseRange(const char *arg, Range &range) {
+    char *end;
+    range.low = strtod(arg, &end);
+    if (end == arg) return false;
+    range.high = range.low;
+    if (*end == ':') {
+        const char *high = end + 1;
+        range.high = strtod(high, &end);
+        if (end == high) return false;
+    }
+    return *end == '\0' && range.high >= range.low;
+}
+
+static float draw(const Range &range, std::mt19937 &rng, bool logarithmic = false) {
+    if (range.high == range.low) return range.low;
+    std::uniform_real_distribution<double> u(0, 1);
+    if (logarithmic && range.low > 0) {
+        return exp(log(range.low) + u(rng) * (log(range.high) - log(range.low)));
+    }
+    return range.low + u(rng) * (range.high - range.low);
+}
+
+// What the CCU commands in each mode: rear axle speed and curvature of the path
+static void commanded(const Options &options, float &speed, float &curvature) {
+    switch (options.mode) {
+        case 0: // ICO turns the yaw setpoint into a speed, on the fixed 0.5 m table radius
+            curvature = 1 / 0.5f;
+            speed = options.radius != 0 ? options.setpoint / options.radius * 0.5f : 0;
+            break;
+        case 3:
+            curvature = 1 / 0.5f;
+            speed = options.setpoint;
+            break;
+        default: // 2: wheel rpm at setpoint_radius
+            curvature = options.radius != 0 ? 1 / options.radius : 0;
+            speed = options.setpoint * PI * d_wheel / 60;
+            break;
+    }
+}
+
+// The run's process: one car, one firmware
+static VehicleSim *sim_car = nullptr;
+static uint64_t sim_now_us = 0;
+static uint64_t sim_next_tick_us = 0;
+static uint64_t sim_busy_until_us = 0;
+static std::vector<uint32_t> sim_tick_us;  // Duration of every tick
+static uint32_t sim_ticks_late = 0;
+static uint64_t sim_last_loop_us = 0;
+static uint32_t sim_loop_gap_max_us = 0;
+static bool sim_in_loop = false;
+
+// 1 ms of the car: plant and MUs, the control ticks due by then, one pass of loop()
+static void simStep() {
+    sim_now_us += VEHICLE_SIM_STEP_US;
+    sim_car->step(sim_now_us);
+
+    const uint32_t period = hostTimerPeriod();
+    if (period == 0) {
+        sim_next_tick_us = 0;
+    } else if (sim_next_tick_us == 0) {
+        sim_next_tick_us = sim_now_us + period;
+    }
+    while (sim_next_tick_us != 0 && sim_next_tick_us <= sim_now_us) {
+        // A tick that is still on the bus delays the next one, like a pending interrupt
+        const uint64_t start_us = std::max(sim_next_tick_us, sim_busy_until_us);
+        hostClockSet((uint32_t)start_us, (uint32_t)(start_us / 1000));
+        hostTimerFire();
+        const uint32_t duration = micros() - (uint32_t)start_us;
+        sim_tick_us.push_back(duration);
+        if (start_us > sim_next_tick_us) sim_ticks_late++;
+        sim_busy_until_us = start_us + duration;
+        sim_next_tick_us += period;
+    }
+
+    if (!sim_in_loop && sim_now_us >= sim_busy_until_us) {
+        hostClockSet((uint32_t)sim_now_us, (uint32_t)(sim_now_us / 1000));
+        sim_loop_gap_max_us = std::max(sim_loop_gap_max_us, (uint32_t)(sim_now_us - sim_last_loop_us));
+        sim_last_loop_us = sim_now_us;
+        sim_in_loop = true;
+        loop();
+        sim_in_loop = false;
+        sim_busy_until_us = std::max(sim_busy_until_us, (uint64_t)micros());
+    }
+}
+
+// loop() waits for the tick to drain the bus queue: the car moves on meanwhile
+static void simWait() {
+    simStep();
+}
+
+static void simCommand(const char *text) {
+    WiFiClient link;
+    link.feed((const uint8_t *)text, strlen(text));
+    hostClockSet((uint32_t)sim_now_us, (uint32_t)(sim_now_us / 1000));
+    handleClientCommunication(link);
+    for (int i = 0; i < CARSIM_COMMAND_MS; i++) simStep();
+}
+
+static bool diverged(const VehicleSim &car) {
+    return !(fabsf(car.speed()) < CARSIM_MAX_SPEED) || !(fabsf(car.yawRate()) < CARSIM_MAX_YAW_RATE) ||
+           !std::isfinite((float)ico_yaw.getOmega1());
+}
+
+static void runScenario(const Options &options, int index, const Scenario &scenario, RunResult &result) {
+    const auto wall_start = std::chrono::steady_clock::now();
+    std::mt19937 rng(scenario.seed);
+    std::uniform_real_distribution<float> spread(-1, 1);
+
+    VehicleParams params;
+    params.mass = scenario.mass;
+    params.friction = scenario.friction;
+    params.rolling = 0.02f;
+    for (int i = 0; i < 4; i++) {
+        params.motor[i] = {1000 * (1 + 0.05f * spread(rng)), 0.2f * (1 + 0.05f * spread(rng)), 2.5f, 0.03f};
+    }
+    params.imu.gyro_noise = scenario.gyro_noise;
+    params.imu.gyro_bias_walk = 0.005f;
+    params.imu.accel_noise = 0.02f;
+    for (int i = 0; i < 3; i++) {
+        params.imu.gyro_bias[i] = 2.0f * spread(rng);
+        params.imu.accel_bias[i] = 0.1f * spread(rng);
+    }
+
+    Serial.quiet = true;
+    if (options.logs) {
+        const std::string dir = std::string(options.logs) + "/run_" + std::to_string(index);
+        mkdir(dir.c_str(), 0755);
+        SD.setRoot(dir);
+    } else {
+        SD.setRoot(""); // No card
+    }
+
+    VehicleSim car(params, scenario.seed);
+    sim_car = &car;
+    car.attach(Wire);
+    Wire.seedFaults(scenario.seed);
+    for (int i = 0; i < 4; i++) {
+        Wire.setFaults(VEHICLE_SIM_MU_ADDRESS + i, scenario.mu_faults);
+    }
+    hostClockSet(0, 0);
+    setup();
+    i2cBus.setWaitHook(simWait);
+
+    // Boot and the calibration of the standing car
+    while (imuCalibration.state() != IMU_CAL_DONE && imuCalibration.state() != IMU_CAL_FAILED &&
+           sim_now_us < CARSIM_CAL_TIMEOUT_MS * 1000ULL) {
+        simStep();
+    }
+    if (imuCalibration.state() != IMU_CAL_DONE) {
+        result.status = RUN_NO_CALIBRATION;
+        return;
+    }
+
+    char command[160];
+    snprintf(command, sizeof(command), "SET:setpoint_radius=%g,omega0=%g,omega1=%g,eta=%g\n",
+             options.radius, scenario.omega0, scenario.omega1, scenario.eta);
+    simCommand(command);
+    snprintf(command, sizeof(command), "PID:%g,%g,%g,%g,%d\n", options.kp, options.ki, options.kd,
+             options.setpoint, options.mode);
+    simCommand(command);
+    simCommand("START\n");
+    sim_tick_us.clear();
+    sim_loop_gap_max_us = 0;
+
+    float speed_target, curvature_target;
+    commanded(options, speed_target, curvature_target);
+    const float yaw_target = speed_target * curvature_target * RAD_TO_DEG;
+    const uint32_t steps = (uint32_t)(options.seconds * 1000);
+    const uint32_t settle = (uint32_t)(options.settle * 1000);
+    double yaw_sq = 0, speed_sq = 0, speed_sum = 0, yaw_sum = 0;
+    uint32_t samples = 0;
+    result.status = RUN_OK;
+    for (uint32_t i = 0; i < steps; i++) {
+        simStep();
+        if (diverged(car)) {
+            result.status = RUN_DIVERGED;
+            break;
+        }
+        if (sim_now_us - sim_last_loop_us > CARSIM_STALL_MS * 1000ULL) {
+            result.status = RUN_STALLED;
+            break;
+        }
+        if (i < settle) continue;
+        const double yaw_error = car.yawRate() - yaw_target;
+        const double speed_error = car.speed() - speed_target;
+        yaw_sq += yaw_error * yaw_error;
+        speed_sq += speed_error * speed_error;
+        speed_sum += car.speed();
+        yaw_sum += car.yawRate() * DEG_TO_RAD;
+        samples++;
+    }
+    simCommand("STOP\n");
+
+    if (samples > 0) {
+        result.yaw_rms = sqrt(yaw_sq / samples);
+        result.speed_rms = sqrt(speed_sq / samples);
+        const double curvature = fabs(speed_sum) > 1e-6 ? yaw_sum / speed_sum : 0;
+        result.curvature_error = fabs(curvature - curvature_target);
+    }
+    result.max_slip = car.maxSlip();
+    result.ico_weight = ico_yaw.getOmega1();
+    result.residual_bias = car.imu().residualGyroBias(2);
+    if (!sim_tick_us.empty()) {
+        std::sort(sim_tick_us.begin(), sim_tick_us.end());
+        result.tick_max_us = sim_tick_us.back();
+        result.tick_p99_us = sim_tick_us[(sim_tick_us.size() - 1) * 99 / 100];
+    }
+    result.ticks_late = sim_ticks_late;
+    result.loop_gap_max_us = std::max(sim_loop_gap_max_us, (uint32_t)(sim_now_us - sim_last_loop_us));
+    for (uint8_t i = 0; i < i2cBus.deviceCount(); i++) {
+        result.i2c_errors += i2cBus.getStats(i).errors;
+    }
+    for (int i = 0; i < 4; i++) {
+        result.corrupted += Wire.getStats(VEHICLE_SIM_MU_ADDRESS + i).corrupted;
+    }
+    result.wall_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - wall_start).count();
+}
+
+static float percentile(std::vector<float> values, float p) {
+    if (values.empty()) return NAN;
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, (size_t)(p * (values.size() - 1) + 0.5f))];
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    bool usage = false;
+    for (int i = 1; i < argc; i++) {
+        const bool value = i + 1 < argc;
+        if (!strcmp(argv[i], "--runs") && value) options.runs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--jobs") && value) options.jobs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && value) options.seed = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--seconds") && value) options.seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--settle") && value) options.settle = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--mode") && value) options.mode = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--setpoint") && value) options.setpoint = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--radius") && value) options.radius = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--pid") && value)
+            usage |= sscanf(argv[++i], "%f,%f,%f", &options.kp, &options.ki, &options.kd) != 3;
+        else if (!strcmp(argv[i], "--mass") && value) usage |= !parseRange(argv[++i], options.mass);
+        else if (!strcmp(argv[i], "--friction") && value) usage |= !parseRange(argv[++i], options.friction);
+        else if (!strcmp(argv[i], "--gyro-noise") && value) usage |= !parseRange(argv[++i], options.gyro_noise);
+        else if (!strcmp(argv[i], "--omega0") && value) usage |= !parseRange(argv[++i], options.omega0);
+        else if (!strcmp(argv[i], "--omega1") && value) usage |= !parseRange(argv[++i], options.omega1);
+        else if (!strcmp(argv[i], "--eta") && value) usage |= !parseRange(argv[++i], options.eta);
+        else if (!strcmp(argv[i], "--mu-latency") && value) usage |= !parseRange(argv[++i], options.mu_latency);
+        else if (!strcmp(argv[i], "--mu-nack") && value) usage |= !parseRange(argv[++i], options.mu_nack);
+        else if (!strcmp(argv[i], "--mu-bit-error") && value) usage |= !parseRange(argv[++i], options.mu_bit_error);
+        else if (!strcmp(argv[i], "--csv") && value) options.csv = argv[++i];
+        else if (!strcmp(argv[i], "--logs") && value) options.logs = argv[++i];
+        else if (!strcmp(argv[i], "--top") && value) options.top = atoi(argv[++i]);
+        else usage = true;
+    }
+    if (options.mode != 0 && options.mode != 2 && options.mode != 3) usage = true;
+    if (options.mu_nack.high > 1 || options.mu_bit_error.high >= 1 || options.mu_latency.low < 0) usage = true;
+    if (usage || options.runs <= 0 || options.seconds <= options.settle || options.seconds > CARSIM_MAX_SECONDS) {
+        fprintf(stderr, "Usage: %s [--runs N] [--jobs N] [--seed N] [--seconds S (<= %d)] [--settle S] [--mode 0|2|3]\n"
+                        "       [--setpoint X] [--radius R] [--pid kp,ki,kd] [--mass A[:B]] [--friction A[:B]]\n"
+                        "       [--gyro-noise A[:B]] [--omega0 A[:B]] [--omega1 A[:B]] [--eta A[:B]]\n"
+                        "       [--mu-latency A[:B]] [--mu-nack A[:B]] [--mu-bit-error A[:B]] [--csv FILE]\n"
+                        "       [--logs DIR] [--top N]\n", argv[0], CARSIM_MAX_SECONDS);
+        return 1;
+    }
+    if (options.jobs <= 0) options.jobs = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+    if (options.logs) mkdir(options.logs, 0755);
+
+    std::vector<Scenario> scenarios(options.runs);
+    for (int k = 0; k < options.runs; k++) {
+        Scenario &scenario = scenarios[k];
+        scenario.seed = options.seed + k;
+        std::mt19937 rng(scenario.seed ^ 0x9E3779B9u); // Own stream, the run draws its own from seed
+        scenario.mass = draw(options.mass, rng);
+        scenario.friction = draw(options.friction, rng);
+        scenario.gyro_noise = draw(options.gyro_noise, rng);
+        scenario.omega0 = draw(options.omega0, rng);
+        scenario.omega1 = draw(options.omega1, rng);
+        scenario.eta = draw(options.eta, rng, true);
+        scenario.mu_faults.latency_us = (uint32_t)draw(options.mu_latency, rng);
+        scenario.mu_faults.nack = draw(options.mu_nack, rng);
+        scenario.mu_faults.bit_error = draw(options.mu_bit_error, rng, true);
+    }
+
+    RunResult *results = (RunResult *)mmap(nullptr, options.runs * sizeof(RunResult), PROT_READ | PROT_WRITE,
+                                           MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (results == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    memset(results, 0, options.runs * sizeof(RunResult));
+
+    const auto start = std::chrono::steady_clock::now();
+    fflush(stdout);
+    std::vector<pid_t> running(options.runs, 0);
+    int next = 0, active = 0;
+    while (next < options.runs || active > 0) {
+        if (next < options.runs && active < options.jobs) {
+            const pid_t pid = fork();
+            if (pid == 0) {
+                runScenario(options, next, scenarios[next], results[next]);
+                _exit(0);
+            }
+            if (pid < 0) {
+                perror("fork");
+                return 1;
+            }
+            running[next++] = pid;
+            active++;
+            continue;
+        }
+        int status;
+        const pid_t pid = wait(&status);
+        if (pid < 0) break;
+        active--;
+        const int k = std::find(running.begin(), running.end(), pid) - running.begin();
+        if (k < options.runs && (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || results[k].status == RUN_PENDING)) {
+            results[k].status = RUN_CRASHED;
+        }
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (options.csv) {
+        FILE *file = fopen(options.csv, "w");
+        if (!file) {
+            fprintf(stderr, "Cannot write %s\n", options.csv);
+            return 1;
+        }
+        fprintf(file, "run,seed,status,mass,friction,gyro_noise,omega0,omega1,eta,mu_latency_us,mu_nack,mu_bit_error,"
+                      "yaw_rms,speed_rms,curvature_error,max_slip,ico_weight,residual_bias,tick_max_us,tick_p99_us,"
+                      "ticks_late,loop_gap_max_us,i2c_errors,corrupted,wall_ms\n");
+        for (int k = 0; k < options.runs; k++) {
+            const Scenario &s = scenarios[k];
+            const RunResult &r = results[k];
+            fprintf(file, "%d,%u,%s,%.3f,%.3f,%.3f,%.4f,%.4f,%.3e,%u,%.4f,%.3e,%.3f,%.4f,%.4f,%.4f,%.6f,%.3f,"
+                          "%u,%u,%u,%u,%u,%u,%.0f\n",
+                    k, s.seed, run_status_names[r.status], s.mass, s.friction, s.gyro_noise, s.omega0, s.omega1, s.eta,
+                    s.mu_faults.latency_us, s.mu_faults.nack, s.mu_faults.bit_error,
+                    r.yaw_rms, r.speed_rms, r.curvature_error, r.max_slip, r.ico_weight, r.residual_bias,
+                    r.tick_max_us, r.tick_p99_us, r.ticks_late, r.loop_gap_max_us, r.i2c_errors, r.corrupted,
+                    r.wall_ms);
+        }
+        fclose(file);
+    }
+
+    int counts[RUN_STATUSES] = {0};
+    std::vector<float> yaw, speed, curvature, slip, bias, tick, tick_p99, late, loop_gap, errors, wall;
+    std::vector<int> ok;
+    int finished = 0;
+    for (int k = 0; k < options.runs; k++) {
+        const RunResult &r = results[k];
+        counts[r.status]++;
+        wall.push_back(r.wall_ms);
+        // The timing and bus metrics of a run that diverged or stalled are filled in too, a stall is what they explain
+        if (r.status != RUN_OK && r.status != RUN_DIVERGED && r.status != RUN_STALLED) continue;
+        finished++;
+        tick.push_back(r.tick_max_us);
+        tick_p99.push_back(r.tick_p99_us);
+        late.push_back(r.ticks_late);
+        loop_gap.push_back(r.loop_gap_max_us);
+        errors.push_back(r.i2c_errors);
+        if (r.status != RUN_OK) continue;
+        ok.push_back(k);
+        yaw.push_back(r.yaw_rms);
+        speed.push_back(r.speed_rms);
+        curvature.push_back(r.curvature_error);
+        slip.push_back(r.max_slip);
+        bias.push_back(fabsf(r.residual_bias));
+    }
+
+    printf("# %d runs of %.0f s in mode %d on %d jobs in %.1f s (%.1f simulated s per wall s)\n", options.runs,
+           options.seconds, options.mode, options.jobs, elapsed, options.runs * options.seconds / elapsed);
+    printf("# status:");
+    for (int s = RUN_OK; s < RUN_STATUSES; s++) printf(" %s %d", run_status_names[s], counts[s]);
+    printf("\n");
+    printf("# control metrics over the %zu OK runs, tick, loop and I2C metrics over the %d that ran (OK, DIVERGED, STALLED)\n",
+           ok.size(), finished);
+    printf("metric, p10, p50, p90, max\n");
+    const struct { const char *name; std::vector<float> *values; } metrics[] = {
+        {"yaw_rms_dps", &yaw}, {"speed_rms_mps", &speed}, {"curvature_error", &curvature},
+        {"max_slip_mps", &slip}, {"residual_bias_dps", &bias}, {"tick_max_us", &tick}, {"tick_p99_us", &tick_p99},
+        {"ticks_late", &late}, {"loop_gap_max_us", &loop_gap}, {"i2c_errors", &errors}, {"wall_ms", &wall},
+    };
+    for (const auto &metric : metrics) {
+        printf("%s, %.4f, %.4f, %.4f, %.4f\n", metric.name, percentile(*metric.values, 0.1f),
+               percentile(*metric.values, 0.5f), percentile(*metric.values, 0.9f), percentile(*metric.values, 1.0f));
+    }
+
+    std::sort(ok.begin(), ok.end(), [&](int a, int b) { return results[a].yaw_rms < results[b].yaw_rms; });
+    printf("rank, run, mass, friction, gyro_noise, omega0, omega1, eta, yaw_rms, speed_rms, ico_weight\n");
+    for (size_t i = 0; i < ok.size() && i < options.top; i++) {
+        const Scenario &s = scenarios[ok[i]];
+        const RunResult &r = results[ok[i]];
+        printf("%zu, %d, %.3f, %.3f, %.3f, %.4f, %.4f, %.2e, %.3f, %.4f, %.6f\n", i + 1, ok[i], s.mass, s.friction,
+               s.gyro_noise, s.omega0, s.omega1, s.eta, r.yaw_rms, r.speed_rms, r.ico_weight);
+    }
+    munmap(results, options.runs * sizeof(RunResult));
+    return counts[RUN_OK] == options.runs ? 0 : 2;
+}
@@ -0,0 +1,143 @@
+/*
+ * ccureplay - run the CCU firmware on the host against an input capture (INPUT_CAPTURE in
+ * main.cpp) and check that it does exactly what it did on the car.
+ *
+ * Usage: ccureplay [options] <capture file>
+ *   --sd DIR       Directory that stands for the SD card (default .). Copy the card's torque
+ *                  maps, setpoint programs and ICO snapshots there, the replay writes its
+ *                  data.csv there as well.
+ *   --verbose      Show the firmware's Serial output
+ *
+ * setup() runs as at power-up (without devices), the capture starts where the control tick was
+ * armed. Ticks, the control client's bytes and its loss are then fed in recorded order; every
+ * I2C read and clock value comes from the capture. Every I2C write, logged row and ICO state is
+ * compared with the recorded one. Exit status 0 if the replay matched to the end.
+ *
+ * Build it with the configuration the capture was made with, INPUT_CAPTURE included: the replay
+ * takes over from the recording setup() opens. carsim built with INPUT_CAPTURE leaves a capture
+ * of every run in its --logs directory (test/Makefile, capture_roundtrip).
+ */
+
+#include <Arduino.h>
+#include <SD.h>
+#include <WiFiS3.h>
+#include "src/inputCapture.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// From src/main.cpp
+void setup();
+void timerISR();
+void startControl();
+void handleClientCommunication(WiFiClient &client);
+void controlClientLost();
+extern InputCapture inputCapture;
+
+static void replayTick(uint32_t now_us, uint32_t now_ms) {
+    hostClockSet(now_us, now_ms);
+    timerISR();
+}
+
+static bool loadFile(const char *filename, std::vector<uint8_t> &data) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) return false;
+    uint8_t buffer[4096];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + length);
+    }
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    const char *filename = nullptr;
+    const char *sd_root = ".";
+    bool verbose = false;
+
+    bool usage = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--sd") && i + 1 < argc) sd_root = argv[++i];
+        else if (!strcmp(argv[i], "--verbose")) verbose = true;
+        else if (argv[i][0] != '-' && !filename) filename = argv[i];
+        else usage = true;
+    }
+    if (usage || !filename) {
+        fprintf(stderr, "Usage: %s [--sd DIR] [--verbose] <capture file>\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<uint8_t> stream;
+    if (!loadFile(filename, stream)) {
+        fprintf(stderr, "Cannot read %s\n", filename);
+        return 1;
+    }
+
+    Serial.quiet = !verbose;
+    SD.setRoot(sd_root);
+    hostClockSet(0, 0);
+    // Before setup(): a build with INPUT_CAPTURE must not start recording over the card
+    if (!inputCapture.attach(stream.data(), stream.size())) {
+        fprintf(stderr, "%s is not a capture of this build: %s\n", filename,
+                inputCapture.getError()[0] ? inputCapture.getError() : "bad header");
+        return 1;
+    }
+    setup();
+    inputCapture.setTickHandler(replayTick);
+    startControl();
+
+    // The records loop() starts with, everything else is taken by the firmware's own hooks
+    WiFiClient client;
+    bool running = true;
+    while (running && !inputCapture.failed()) {
+        const uint8_t *payload;
+        uint8_t length;
+        uint32_t now_us, now_ms;
+        switch (inputCapture.peek(&payload, &length)) {
+            case CAPTURE_END:
+                running = false;
+                break;
+            case CAPTURE_TICK:
+                memcpy(&now_us, payload, 4);
+                memcpy(&now_ms, payload + 4, 4);
+                replayTick(now_us, now_ms);
+                break;
+            case CAPTURE_TCP:
+                memcpy(&now_us, payload, 4);
+                memcpy(&now_ms, payload + 4, 4);
+                hostClockSet(now_us, now_ms);
+                client.feed(payload + 8, length - 8);
+                handleClientCommunication(client);
+                break;
+            case CAPTURE_DISCONNECT:
+                controlClientLost();
+                client = WiFiClient();
+                break;
+            default: {
+                // Only a tick or the control client start a record in loop(), anything else
+                // means the firmware took fewer records than it did on the car
+                const char *error = inputCapture.getError();
+                fprintf(stderr, "Record %lu of type %u where loop() starts no record%s%s\n",
+                        (unsigned long)inputCapture.getRecords(), (unsigned)inputCapture.peek(),
+                        error[0] ? ", first difference: " : "", error);
+                return 1;
+            }
+        }
+    }
+
+    printf("Records: %lu, ticks: %lu, outputs compared: %lu, mismatches: %lu\n",
+           (unsigned long)inputCapture.getRecords(), (unsigned long)inputCapture.getTicks(),
+           (unsigned long)inputCapture.getCompared(), (unsigned long)inputCapture.getMismatches());
+    if (inputCapture.failed() || inputCapture.getMismatches() > 0) {
+        printf("Replay differs: %s\n", inputCapture.getError());
+        return 1;
+    }
+    if (inputCapture.ended()) {
+        printf("The capture ends within tick %lu, compared up to there\n",
+               (unsigned long)inputCapture.getTicks());
+    }
+    printf("Replay matches the capture\n");
+    return 0;
+}
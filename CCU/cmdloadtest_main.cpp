@@ -0,0 +1,170 @@
+/*
+ * cmdloadtest - feed a mixed stream of binary frames, text commands and corrupted input
+ * through CommandParser in random chunk sizes, as the TCP client hands them to loop().
+ *
+ * Usage: cmdloadtest [options]
+ *   --commands N   Commands in the stream     (default 200000)
+ *   --chunk N      Largest chunk per loop()   (default 64 bytes)
+ *   --corrupt P    Share of corrupted frames  (default 0.01)
+ *   --seed N       Random seed               (default 1)
+ *
+ * Every decoded command is checked against the one that was sent. Reports throughput,
+ * worst case time of one push() and of one chunk.
+ */
+
+#include "src/commandParser.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Expected {
+    uint8_t type;   // CMD_INVALID for corrupted frames
+    Command command;
+    std::string text;
+};
+
+static bool sameCommand(const Command &a, const Command &b) {
+    switch (a.type) {
+        case CMD_PID:
+            return a.pid.kp == b.pid.kp && a.pid.ki == b.pid.ki && a.pid.kd == b.pid.kd &&
+                   a.pid.setpoint == b.pid.setpoint && a.pid.mode == b.pid.mode;
+        case CMD_SETPOINT:
+            return a.setpoint.setpoint == b.setpoint.setpoint;
+        case CMD_ICO:
+            return a.ico.omega0 == b.ico.omega0 && a.ico.omega1 == b.ico.omega1 && a.ico.eta == b.ico.eta;
+        default:
+            return true;
+    }
+}
+
+int main(int argc, char **argv) {
+    unsigned count = 200000;
+    unsigned max_chunk = 64;
+    double corrupt = 0.01;
+    unsigned seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--commands") && i + 1 < argc) count = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--chunk") && i + 1 < argc) max_chunk = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--corrupt") && i + 1 < argc) corrupt = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Usage: %s [--commands N] [--chunk N] [--corrupt P] [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (max_chunk == 0) max_chunk = 1;
+
+    // Build the stream
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+    std::uniform_int_distribution<int> kind(0, 7);
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    std::vector<uint8_t> stream;
+    std::vector<Expected> expected;
+    char line[CMD_MAX_TEXT];
+
+    for (unsigned n = 0; n < count; n++) {
+        Expected e;
+        Command &c = e.command;
+        memset(&c, 0, sizeof(c));
+        int k = kind(rng);
+        switch (k % 4) {
+            case 0: c.type = (k < 4) ? CMD_START : CMD_STOP; break;
+            case 1: c.type = CMD_PID; c.pid = {value(rng), value(rng), value(rng), value(rng), (uint8_t)(k & 3)}; break;
+            case 2: c.type = CMD_SETPOINT; c.setpoint.setpoint = value(rng); break;
+            case 3: c.type = CMD_ICO; c.ico = {value(rng), value(rng), value(rng) * 1e-5f}; break;
+        }
+        e.type = c.type;
+
+        if (k >= 4) { // Binary frame
+            uint8_t frame[CMD_MAX_PAYLOAD + 4];
+            size_t length = CommandParser::encode(c, frame, sizeof(frame));
+            if (chance(rng) < corrupt) {
+                frame[length - 1] ^= 0x5A; // Break the checksum
+                e.type = CMD_INVALID;
+            }
+            stream.insert(stream.end(), frame, frame + length);
+        } else { // Text line, the exact float text round trips through strtod
+            switch (c.type) {
+                case CMD_START: snprintf(line, sizeof(line), "START\r\n"); break;
+                case CMD_PID:
+                    snprintf(line, sizeof(line), "PID:%.9g,%.9g,%.9g,%.9g,%d\n", c.pid.kp, c.pid.ki,
+                             c.pid.kd, c.pid.setpoint, c.pid.mode);
+                    break;
+                case CMD_SETPOINT: snprintf(line, sizeof(line), "SETPOINT:%.9g\n", c.setpoint.setpoint); break;
+                case CMD_ICO:
+                    snprintf(line, sizeof(line), "ICO:%.9g,%.9g,%.9g\n", c.ico.omega0, c.ico.omega1, c.ico.eta);
+                    break;
+            }
+            stream.insert(stream.end(), line, line + strlen(line));
+        }
+        expected.push_back(e);
+
+        if (n % 16 == 0) { // Text commands that are passed on to processClientMessage
+            Expected t;
+            t.type = CMD_TEXT;
+            t.text = "PROG_RUN:1";
+            stream.insert(stream.end(), t.text.begin(), t.text.end());
+            stream.push_back('\n');
+            expected.push_back(t);
+        }
+    }
+
+    // Feed it in chunks, as client.available() would hand it over
+    CommandParser parser;
+    Command command;
+    std::uniform_int_distribution<unsigned> chunk_size(1, max_chunk);
+    size_t next = 0;
+    size_t mismatches = 0;
+    double worst_push_us = 0;
+    double worst_chunk_us = 0;
+    unsigned chunks = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    size_t pos = 0;
+    while (pos < stream.size()) {
+        size_t end = std::min(stream.size(), pos + chunk_size(rng));
+        auto chunk_start = std::chrono::steady_clock::now();
+        for (; pos < end; pos++) {
+            auto t0 = std::chrono::steady_clock::now();
+            bool done = parser.push(stream[pos], command);
+            double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+            if (us > worst_push_us) worst_push_us = us;
+            if (!done) continue;
+
+            if (next >= expected.size()) {
+                mismatches++;
+                continue;
+            }
+            const Expected &e = expected[next++];
+            bool ok = command.type == e.type;
+            if (ok && e.type == CMD_TEXT) ok = e.text == command.text;
+            else if (ok && e.type != CMD_INVALID) ok = sameCommand(e.command, command);
+            if (!ok) mismatches++;
+        }
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - chunk_start).count();
+        if (us > worst_chunk_us) worst_chunk_us = us;
+        chunks++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("bytes,%zu\n", stream.size());
+    printf("commands,%zu\n", expected.size());
+    printf("decoded,%zu\n", next);
+    printf("mismatches,%zu\n", mismatches + (expected.size() - next));
+    printf("parser_errors,%u\n", (unsigned)parser.getErrors());
+    printf("commands_per_s,%.0f\n", expected.size() / seconds);
+    printf("mbytes_per_s,%.2f\n", stream.size() / seconds / 1e6);
+    printf("worst_push_us,%.3f\n", worst_push_us);
+    printf("worst_chunk_us,%.3f\n", worst_chunk_us);
+    printf("chunks,%u\n", chunks);
+
+    return (mismatches == 0 && next == expected.size()) ? 0 : 1;
+}
@@ -14,5 +14,9 @@ int main() {
     ExponentialDecayFilter expDecay(0.2);
     test_filter(expDecay, "Exponential Decay Filter",30);
 
+    // Resonator bank, 4 resonators at 1-8 Hz with Q = 0.6 sampled at 75 Hz
+    ResonatorBank bank({1.0, 2.0, 4.0, 8.0}, 0.6, 1.0 / 75.0);
+    test_filter(bank, "Resonator Bank (sum)",30);
+
     return 0;
 }
\ No newline at end of file
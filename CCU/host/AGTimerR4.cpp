@@ -0,0 +1,52 @@
+/*
+ * Host stand-in for AGTimerR4: the timer never fires by itself, hostTimerFire() runs the
+ * callback (the replay runs the tick itself).
+ */
+
+#include "../src/AGTimerR4.h"
+#include "hostTimer.h"
+
+AGTimerR4 AGTimer;
+
+void (*AGTimerR4::callback_func)();
+
+static uint32_t host_timer_period_us = 0;
+static bool host_timer_running = false;
+static void (*host_timer_callback)() = nullptr; // callback_func is private to AGTimerR4
+
+void AGTimerR4::ourTimerCallback(timer_callback_args_t __attribute((unused)) * p_args) {
+    AGTimerR4::callback_func();
+}
+
+void AGTimerR4::init(double freq_hz, void (*callback)()) {
+    init((int)(1000000 / freq_hz + 0.5), callback);
+}
+
+void AGTimerR4::init(int period_us, void (*callback)()) {
+    host_timer_period_us = period_us;
+    AGTimerR4::callback_func = callback;
+    host_timer_callback = callback;
+}
+
+void AGTimerR4::init(int, timer_source_div_t, void (*callback)()) {
+    AGTimerR4::callback_func = callback;
+    host_timer_callback = callback;
+}
+
+bool AGTimerR4::start(void) {
+    host_timer_running = AGTimerR4::callback_func != nullptr;
+    return host_timer_running;
+}
+
+bool AGTimerR4::stop(void) {
+    host_timer_running = false;
+    return true;
+}
+
+uint32_t hostTimerPeriod() {
+    return host_timer_running ? host_timer_period_us : 0;
+}
+
+void hostTimerFire() {
+    if (host_timer_running) host_timer_callback();
+}
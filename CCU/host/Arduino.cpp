@@ -0,0 +1,55 @@
+#include "Arduino.h"
+
+#include <chrono>
+#include <thread>
+
+HostSerial Serial;
+
+static const std::chrono::steady_clock::time_point host_start = std::chrono::steady_clock::now();
+static bool host_clock_set = false;
+static uint32_t host_clock_us = 0;
+static uint32_t host_clock_ms = 0;
+static uint32_t host_clock_fraction = 0; // Microseconds not yet in host_clock_ms
+
+unsigned long millis() {
+    if (host_clock_set) return host_clock_ms;
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - host_start).count();
+}
+
+unsigned long micros() {
+    if (host_clock_set) return host_clock_us;
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - host_start).count();
+}
+
+void delay(unsigned long ms) {
+    if (host_clock_set) {
+        hostClockAdvance(ms * 1000);
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us) {
+    if (host_clock_set) {
+        hostClockAdvance(us);
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void hostClockSet(uint32_t now_us, uint32_t now_ms) {
+    host_clock_set = true;
+    host_clock_us = now_us;
+    host_clock_ms = now_ms;
+    host_clock_fraction = 0;
+}
+
+void hostClockAdvance(uint32_t us) {
+    if (!host_clock_set) return;
+    host_clock_fraction += us;
+    host_clock_us += us;
+    host_clock_ms += host_clock_fraction / 1000;
+    host_clock_fraction %= 1000;
+}
@@ -0,0 +1,137 @@
+/*
+ * Minimal Arduino stand-in for building CCU sources on the host (Linux).
+ * Only what the CCU code uses is provided; Serial output goes to stdout.
+ * The clock is the host's steady clock until hostClockSet() freezes it at given values
+ * (the replay runs the tick at its recorded time).
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+#define RAD_TO_DEG 57.295779513082320876798154814105
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define DEC 10
+#define HEX 16
+
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+/// @brief Host only: freeze millis() and micros() at these values (until the next call)
+void hostClockSet(uint32_t now_us, uint32_t now_ms);
+/// @brief Host only: move a frozen clock on, e.g. by the time a bus transfer takes
+void hostClockAdvance(uint32_t us);
+
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int digitalRead(int) { return LOW; }
+inline int analogRead(int) { return 0; }
+inline void analogWrite(int, int) {}
+inline int digitalPinToInterrupt(int pin) { return pin; }
+inline void attachInterrupt(int, void (*)(), int) {}
+inline void detachInterrupt(int) {}
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+class String {
+public:
+    String() {}
+    String(const char *text) : _s(text ? text : "") {}
+    String(const std::string &text) : _s(text) {}
+    explicit String(char c) : _s(1, c) {}
+    String(int value, unsigned char base = DEC) : _s(integer(value, base)) {}
+    String(unsigned int value, unsigned char base = DEC) : _s(integer(value, base)) {}
+    String(long value, unsigned char base = DEC) : _s(integer(value, base)) {}
+    String(unsigned long value, unsigned char base = DEC) : _s(integer(value, base)) {}
+    String(float value, unsigned int decimals = 2) : _s(decimal(value, decimals)) {}
+    String(double value, unsigned int decimals = 2) : _s(decimal(value, decimals)) {}
+
+    const char *c_str() const { return _s.c_str(); }
+    unsigned int length() const { return _s.size(); }
+    String &operator+=(const String &other) { _s += other._s; return *this; }
+    String &operator+=(const char *other) { _s += other; return *this; }
+    bool operator==(const char *other) const { return _s == other; }
+    bool operator==(const String &other) const { return _s == other._s; }
+    bool operator!=(const char *other) const { return _s != other; }
+
+    friend String operator+(const String &a, const String &b) { return String(a._s + b._s); }
+    friend String operator+(const String &a, const char *b) { return String(a._s + b); }
+    friend String operator+(const char *a, const String &b) { return String(a + b._s); }
+
+private:
+    static std::string integer(long long value, unsigned char base) {
+        char text[24];
+        if (base == HEX) {
+            snprintf(text, sizeof(text), "%llX", (unsigned long long)value);
+        } else {
+            snprintf(text, sizeof(text), "%lld", value);
+        }
+        return text;
+    }
+    static std::string decimal(double value, unsigned int decimals) {
+        char text[64];
+        snprintf(text, sizeof(text), "%.*f", (int)decimals, value);
+        return text;
+    }
+
+    std::string _s;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t value) { return write(&value, 1); }
+    virtual size_t write(const uint8_t *data, size_t length) = 0;
+
+    size_t print(const char *text) { return write(reinterpret_cast<const uint8_t *>(text), strlen(text)); }
+    size_t print(const String &text) { return print(text.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value, int base = DEC) { return print(String(value, base)); }
+    size_t print(unsigned int value, int base = DEC) { return print(String(value, base)); }
+    size_t print(long value, int base = DEC) { return print(String(value, base)); }
+    size_t print(unsigned long value, int base = DEC) { return print(String(value, base)); }
+    size_t print(double value, int digits = 2) { return print(String(value, (unsigned int)digits)); }
+
+    size_t println() { return print("\r\n"); }
+    template <typename T> size_t println(const T &value) { size_t n = print(value); return n + println(); }
+    template <typename T> size_t println(const T &value, int format) { size_t n = print(value, format); return n + println(); }
+};
+
+class HostSerial : public Print {
+public:
+    using Print::write;
+    void begin(unsigned long) {}
+    size_t write(const uint8_t *data, size_t length) override {
+        if (!quiet) fwrite(data, 1, length, stdout);
+        return length;
+    }
+    bool quiet = false;         // Host only: drop the output (e.g. the replay's firmware chatter)
+};
+
+extern HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
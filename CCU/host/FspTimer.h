@@ -0,0 +1,15 @@
+/*
+ * Host stand-in for the R4 FSP timer, just the types AGTimerR4.h names.
+ */
+
+#ifndef HOST_FSP_TIMER_H
+#define HOST_FSP_TIMER_H
+
+#include "Arduino.h"
+
+typedef struct {} timer_callback_args_t;
+typedef int timer_source_div_t;
+
+class FspTimer {};
+
+#endif // HOST_FSP_TIMER_H
@@ -0,0 +1,75 @@
+#include "SD.h"
+
+SDClass SD;
+
+size_t File::write(const uint8_t *data, size_t length) {
+    if (!_file) return 0;
+    return fwrite(data, 1, length, _file.get());
+}
+
+int File::available() {
+    if (!_file) return 0;
+    FILE *file = _file.get();
+    const long pos = ftell(file);
+    fseek(file, 0, SEEK_END);
+    const long end = ftell(file);
+    fseek(file, pos, SEEK_SET);
+    return (int)(end - pos);
+}
+
+int File::read() {
+    if (!_file) return -1;
+    return fgetc(_file.get());
+}
+
+int File::read(uint8_t *data, size_t length) {
+    if (!_file) return -1;
+    return (int)fread(data, 1, length, _file.get());
+}
+
+size_t File::readBytesUntil(char terminator, char *buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        const int c = read();
+        if (c < 0 || c == terminator) break;
+        buffer[count++] = (char)c;
+    }
+    return count;
+}
+
+unsigned long File::size() {
+    if (!_file) return 0;
+    FILE *file = _file.get();
+    const long pos = ftell(file);
+    fseek(file, 0, SEEK_END);
+    const long end = ftell(file);
+    fseek(file, pos, SEEK_SET);
+    return (unsigned long)end;
+}
+
+void File::flush() {
+    if (_file) fflush(_file.get());
+}
+
+File SDClass::open(const char *filename, int mode) {
+    if (_root.empty()) return File();
+    FILE *file = fopen(path(filename).c_str(), mode == FILE_WRITE ? "ab+" : "rb");
+    return file ? File(file) : File();
+}
+
+bool SDClass::remove(const char *filename) {
+    if (_root.empty()) return false;
+    return ::remove(path(filename).c_str()) == 0;
+}
+
+bool SDClass::exists(const char *filename) {
+    if (_root.empty()) return false;
+    FILE *file = fopen(path(filename).c_str(), "rb");
+    if (!file) return false;
+    fclose(file);
+    return true;
+}
+
+std::string SDClass::path(const char *filename) const {
+    return _root + "/" + filename;
+}
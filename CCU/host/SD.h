@@ -0,0 +1,53 @@
+/*
+ * Host stand-in for the SD library: files in a directory of the host (SD.setRoot(), default
+ * the working directory, empty for no card). FILE_WRITE appends like on the card.
+ */
+
+#ifndef HOST_SD_H
+#define HOST_SD_H
+
+#include "Arduino.h"
+#include <memory>
+
+#define FILE_READ 0
+#define FILE_WRITE 1
+
+class File : public Print {
+public:
+    File() {}
+    explicit File(FILE *file) : _file(file, fclose) {}
+
+    using Print::write;
+    size_t write(const uint8_t *data, size_t length) override;
+    int available();
+    int read();
+    int read(uint8_t *data, size_t length);
+    size_t readBytesUntil(char terminator, char *buffer, size_t length);
+    unsigned long size();
+    void flush();
+    void close() { _file.reset(); }
+    operator bool() const { return _file != nullptr; }
+
+private:
+    std::shared_ptr<FILE> _file; // Copies share the open file like SD's File handles
+};
+
+class SDClass {
+public:
+    bool begin(int) { return !_root.empty(); }
+    File open(const char *filename, int mode = FILE_READ);
+    bool remove(const char *filename);
+    bool exists(const char *filename);
+
+    /// @brief Host only: directory that stands for the card, "" takes the card out
+    void setRoot(const std::string &root) { _root = root; }
+
+private:
+    std::string path(const char *filename) const;
+
+    std::string _root = ".";
+};
+
+extern SDClass SD;
+
+#endif // HOST_SD_H
@@ -0,0 +1,8 @@
+/*
+ * Host stand-in for SPI, only included for the SD library.
+ */
+
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#endif // HOST_SPI_H
@@ -0,0 +1,48 @@
+#include "WiFiS3.h"
+
+WiFiClass WiFi;
+
+bool IPAddress::fromString(const char *text) {
+    unsigned int part[4];
+    char end;
+    if (sscanf(text, "%u.%u.%u.%u%c", &part[0], &part[1], &part[2], &part[3], &end) != 4) return false;
+    for (int i = 0; i < 4; i++) {
+        if (part[i] > 255) return false;
+    }
+    *this = IPAddress(part[0], part[1], part[2], part[3]);
+    return true;
+}
+
+int WiFiClient::read() {
+    if (_rxPos >= _rx.size()) return -1;
+    return _rx[_rxPos++];
+}
+
+int WiFiClient::read(uint8_t *data, size_t length) {
+    size_t count = 0;
+    while (count < length && _rxPos < _rx.size()) {
+        data[count++] = _rx[_rxPos++];
+    }
+    return count > 0 ? (int)count : -1;
+}
+
+size_t WiFiClient::write(const uint8_t *data, size_t length) {
+    if (!_connected) return 0;
+    _tx.append(reinterpret_cast<const char *>(data), length);
+    return length;
+}
+
+std::string WiFiClient::takeSent() {
+    std::string sent;
+    sent.swap(_tx);
+    return sent;
+}
+
+void WiFiClient::feed(const uint8_t *data, size_t length) {
+    if (_rxPos == _rx.size()) {
+        _rx.clear();
+        _rxPos = 0;
+    }
+    _rx.insert(_rx.end(), data, data + length);
+    _connected = true;
+}
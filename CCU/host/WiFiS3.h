@@ -0,0 +1,78 @@
+/*
+ * Host stand-in for WiFiS3: never connects, no client arrives. The replay feeds the control
+ * client's bytes into a WiFiClient (feed()), replies are kept until takeSent().
+ */
+
+#ifndef HOST_WIFIS3_H
+#define HOST_WIFIS3_H
+
+#include "Arduino.h"
+#include <vector>
+
+#define WL_IDLE_STATUS 0
+#define WL_CONNECTED 3
+#define WL_DISCONNECTED 6
+
+class IPAddress {
+public:
+    IPAddress() {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : _address(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+    bool fromString(const char *text);
+    operator uint32_t() const { return _address; }
+
+private:
+    uint32_t _address = 0;
+};
+
+class WiFiClient : public Print {
+public:
+    using Print::write;
+    size_t write(const uint8_t *data, size_t length) override;
+    int available() { return (int)(_rx.size() - _rxPos); }
+    int read();
+    int read(uint8_t *data, size_t length);
+    bool connected() { return _connected || available() > 0; }
+    operator bool() { return _connected; }
+    void stop() { _connected = false; }
+    IPAddress remoteIP() { return IPAddress(127, 0, 0, 1); }
+    uint16_t remotePort() { return 0; }
+
+    /// @brief Host only: bytes for read(), the client counts as connected from then on
+    void feed(const uint8_t *data, size_t length);
+    /// @brief Host only: what the firmware wrote to the client since the last call
+    std::string takeSent();
+
+private:
+    std::string _tx;
+    std::vector<uint8_t> _rx;
+    size_t _rxPos = 0;
+    bool _connected = false;
+};
+
+class WiFiServer {
+public:
+    WiFiServer(int) {}
+    void begin() {}
+    WiFiClient accept() { return WiFiClient(); }
+};
+
+class WiFiUDP : public Print {
+public:
+    using Print::write;
+    uint8_t begin(uint16_t) { return 1; }
+    int beginPacket(const IPAddress &, uint16_t) { return 1; }
+    size_t write(const uint8_t *, size_t length) override { return length; }
+    int endPacket() { return 1; }
+};
+
+class WiFiClass {
+public:
+    int begin(const char *, const char *) { return WL_DISCONNECTED; }
+    int status() { return WL_DISCONNECTED; }
+    IPAddress localIP() { return IPAddress(); }
+};
+
+extern WiFiClass WiFi;
+
+#endif // HOST_WIFIS3_H
@@ -0,0 +1,73 @@
+#include "Wire.h"
+#include <algorithm>
+
+TwoWire Wire;
+
+void TwoWire::beginTransmission(uint8_t address) {
+    _address = address;
+    _txLength = 0;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t length) {
+    size_t written = 0;
+    while (written < length && _txLength < HOST_WIRE_BUFFER) {
+        _tx[_txLength++] = data[written++];
+    }
+    return written;
+}
+
+uint8_t TwoWire::endTransmission(bool stop) {
+    HostI2CDevice *device = _devices[_address & 0x7F];
+    if (!device || nack(_address)) {
+        transfer(0, stop);
+        return 2; // Address NACK
+    }
+    hostClockAdvance(_faults[_address & 0x7F].latency_us);
+    corrupt(_address, _tx, _txLength);
+    transfer(_txLength, stop);
+    return device->receive(_tx, _txLength) ? 0 : 3; // Data NACK
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t length, bool stop) {
+    HostI2CDevice *device = _devices[address & 0x7F];
+    if (length > HOST_WIRE_BUFFER) length = HOST_WIRE_BUFFER;
+    _rxLength = 0;
+    _rxPos = 0;
+    if (device && !nack(address)) {
+        hostClockAdvance(_faults[address & 0x7F].latency_us);
+        _rxLength = device->request(_rx, length);
+        corrupt(address, _rx, _rxLength);
+    }
+    transfer(_rxLength, stop);
+    return _rxLength;
+}
+
+bool TwoWire::nack(uint8_t address) {
+    HostWireStats &stats = _stats[address & 0x7F];
+    stats.transactions++;
+    const float p = _faults[address & 0x7F].nack;
+    if (p <= 0 || std::uniform_real_distribution<float>(0, 1)(_rng) >= p) return false;
+    stats.nacks++;
+    return true;
+}
+
+bool TwoWire::corrupt(uint8_t address, uint8_t *data, uint8_t length) {
+    const float p = _faults[address & 0x7F].bit_error;
+    if (p <= 0 || length == 0) return false;
+    // Distance to the next flipped bit instead of a draw per bit
+    std::geometric_distribution<uint32_t> gap(std::min(p, 0.999f));
+    bool corrupted = false;
+    for (uint32_t bit = gap(_rng); bit < 8u * length; bit += 1 + gap(_rng)) {
+        data[bit / 8] ^= 1 << (bit % 8);
+        corrupted = true;
+    }
+    if (corrupted) _stats[address & 0x7F].corrupted++;
+    return corrupted;
+}
+
+void TwoWire::transfer(uint8_t bytes, bool stop) {
+    // Start, address byte, data bytes of 9 clocks each (ACK included), stop unless the next
+    // transaction follows with a repeated start
+    const uint32_t clocks = (stop ? 2 : 1) + 9 * (1 + bytes);
+    hostClockAdvance((clocks * 1000000UL + _clock - 1) / _clock);
+}
@@ -0,0 +1,83 @@
+/*
+ * Host stand-in for Wire: a virtual bus. Addresses without an attached device NACK, which is
+ * all ccureplay needs (it takes the CCU's I2C traffic from the capture, CaptureWire). The
+ * simulator attaches models of the BMX160 and the MUs.
+ *
+ * While the host clock is frozen (hostClockSet()) every transaction takes its time on the bus
+ * at the selected clock, so I2CBus times and tick durations come out as on the car.
+ * setFaults() adds latency, NACKs and bit errors per address for fault tests.
+ */
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include "Arduino.h"
+#include <random>
+
+#define HOST_WIRE_BUFFER 32     // As Wire on the R4
+#define HOST_WIRE_DEVICES 128
+
+/// @brief A device on the virtual bus, called when the master's transaction ends
+class HostI2CDevice {
+public:
+    virtual ~HostI2CDevice() {}
+    /// @brief Master write (onReceive), false to NACK it
+    virtual bool receive(const uint8_t *data, uint8_t length) = 0;
+    /// @brief Master read (onRequest), returns the bytes put into data (at most length)
+    virtual uint8_t request(uint8_t *data, uint8_t length) = 0;
+};
+
+/// @brief Misbehaviour of one address, drawn per transaction
+struct HostWireFaults {
+    uint32_t latency_us;        // Extra time per transaction (clock stretching, slave ISR latency)
+    float nack;                 // Probability that the address byte is not acknowledged
+    float bit_error;            // Probability that a data bit flips on the wire, either direction
+};
+
+/// @brief What the faults did, per address
+struct HostWireStats {
+    uint32_t transactions;
+    uint32_t nacks;             // Transactions refused by a fault, not by a missing device
+    uint32_t corrupted;         // Transactions with at least one flipped bit
+};
+
+class TwoWire : public Print {
+public:
+    using Print::write;
+    void begin() {}
+    void setClock(uint32_t clock) { _clock = clock; }
+    void beginTransmission(uint8_t address);
+    size_t write(const uint8_t *data, size_t length) override;
+    uint8_t endTransmission(bool stop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t length, bool stop = true);
+    int available() { return _rxLength - _rxPos; }
+    int read() { return _rxPos < _rxLength ? _rx[_rxPos++] : -1; }
+
+    /// @brief Host only: put a device at this address, nullptr removes it
+    void attach(uint8_t address, HostI2CDevice *device) { _devices[address & 0x7F] = device; }
+    /// @brief Host only: faults of this address from now on, zeros remove them
+    void setFaults(uint8_t address, const HostWireFaults &faults) { _faults[address & 0x7F] = faults; }
+    void seedFaults(uint32_t seed) { _rng.seed(seed); }
+    const HostWireStats &getStats(uint8_t address) const { return _stats[address & 0x7F]; }
+
+private:
+    void transfer(uint8_t bytes, bool stop);
+    bool nack(uint8_t address);
+    bool corrupt(uint8_t address, uint8_t *data, uint8_t length);
+
+    HostI2CDevice *_devices[HOST_WIRE_DEVICES] = {nullptr};
+    HostWireFaults _faults[HOST_WIRE_DEVICES] = {};
+    HostWireStats _stats[HOST_WIRE_DEVICES] = {};
+    std::mt19937 _rng;
+    uint32_t _clock = 100000;
+    uint8_t _address = 0;
+    uint8_t _tx[HOST_WIRE_BUFFER];
+    uint8_t _txLength = 0;
+    uint8_t _rx[HOST_WIRE_BUFFER];
+    uint8_t _rxLength = 0;
+    uint8_t _rxPos = 0;
+};
+
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
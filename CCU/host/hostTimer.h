@@ -0,0 +1,15 @@
+/*
+ * Host only: AGTimer never fires on its own on the host, a simulation fires it in its time.
+ */
+
+#ifndef HOST_TIMER_H
+#define HOST_TIMER_H
+
+#include <stdint.h>
+
+/// @brief Period of the started AGTimer (us), 0 while it is stopped
+uint32_t hostTimerPeriod();
+/// @brief Run the AGTimer callback once
+void hostTimerFire();
+
+#endif // HOST_TIMER_H
@@ -0,0 +1,142 @@
+#include "ico_replay.h"
+
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+
+#include "../src/ICO_algo.h"
+#include "../src/filter.h"
+
+static const double SAMPLE_FREQ = 75.0;                 // Same as src/main.cpp
+
+static std::string trim(const std::string &s) {
+    size_t first = s.find_first_not_of(" \t\r");
+    size_t last = s.find_last_not_of(" \t\r");
+    return (first == std::string::npos) ? "" : s.substr(first, last - first + 1);
+}
+
+bool loadReplayDataset(const char *path, ReplayDataset &dataset) {
+    std::ifstream file(path);
+    std::string line;
+    if (!file || !std::getline(file, line)) {
+        return false;
+    }
+
+    int col_gyro = -1, col_setpoint = -1, col_radius = -1;
+    std::stringstream header(line);
+    std::string name;
+    for (int col = 0; std::getline(header, name, ','); col++) {
+        name = trim(name);
+        if (name == "gyro_z") col_gyro = col;
+        else if (name == "setpoint") col_setpoint = col;
+        else if (name == "setpoint_radius") col_radius = col;
+    }
+    if (col_gyro < 0 || col_setpoint < 0 || col_radius < 0) {
+        return false;
+    }
+
+    dataset.name = path;
+    dataset.rows.clear();
+    std::vector<double> values;
+    while (std::getline(file, line)) {
+        values.clear();
+        std::stringstream fields(line);
+        std::string field;
+        while (std::getline(fields, field, ',')) {
+            values.push_back(std::strtod(field.c_str(), nullptr));
+        }
+        if ((int)values.size() <= std::max(col_gyro, std::max(col_setpoint, col_radius))) {
+            continue; // Truncated row at the end of a log
+        }
+        dataset.rows.push_back({values[col_gyro], values[col_setpoint], values[col_radius]});
+    }
+    return !dataset.rows.empty();
+}
+
+template <typename T>
+void replayICO(const ICOConfig &config, const std::vector<ReplayDataset> &datasets,
+               ReplayMetrics &metrics, std::vector<double> *trace) {
+    const double dt = 1.0 / SAMPLE_FREQ;
+    const T dt_t = 1 / static_cast<T>(SAMPLE_FREQ);
+
+    // Same filter setup as src/main.cpp, owned by this replay
+    PIDFilterT<T> reflex_filter(1.24f, 5.27f, 0.0f, dt_t);
+    FIRFilterT<T> predictive_filter({-0.014, -0.127, -0.127, 0.111, 0.383, 0.383, 0.111, -0.127, -0.127, -0.014});
+    ResonatorBankT<T> bank({0.5, 1.0, 2.0, 4.0}, 0.6, dt);
+
+    std::vector<PredictiveT<T>> predictive = { PredictiveT<T>(config.eta, config.omega1, &predictive_filter) };
+    ReflexT<T> reflex(config.omega0, dt_t, &reflex_filter);
+    ICOAlgoT<T> ico(config.eta, dt_t, reflex, predictive);
+    if (config.resonator_bank) {
+        ico.setResonatorBank(&bank);
+    }
+
+    double error_sq_sum = 0;
+    double residual_sq_sum = 0;
+    double drift_sum = 0;
+    size_t drift_count = 0;
+    size_t clamped = 0;
+    size_t total = 0;
+    double weight = 0;
+
+    if (trace) {
+        trace->clear();
+    }
+
+    for (const ReplayDataset &dataset : datasets) {
+        // Equivalent of an "ICO:" message followed by START
+        ico.updateOmegaValues(config.omega0, config.omega1);
+        ico.setEta(config.eta);
+        ico.resetICO();
+        ico.clearFilters();
+
+        size_t settle_index = dataset.rows.size() * 8 / 10;
+        double prev_weight = ico.getomega_n();
+
+        for (size_t i = 0; i < dataset.rows.size(); i++) {
+            const ReplayRow &row = dataset.rows[i];
+            T setpoint_yaw_degs = (row.setpoint_radius != 0) ? (row.setpoint / row.setpoint_radius) * 180 / PI : 0;
+            T yaw_input = constrain(row.gyro_z, 0, 500);
+
+            double output = ico.computeChange(yaw_input, yaw_input, setpoint_yaw_degs);
+            double error = ico.getError();
+            error_sq_sum += error * error;
+            residual_sq_sum += (error - output) * (error - output);
+
+            if (std::fabs(ico.getOmega1()) >= 3.0) {
+                clamped++;
+            }
+
+            weight = ico.getomega_n();
+            if (config.resonator_bank) {
+                for (size_t k = 0; k < bank.size(); k++) {
+                    weight += ico.getBankWeight(k);
+                }
+            }
+            if (i >= settle_index) {
+                drift_sum += std::fabs(weight - prev_weight) / dt;
+                drift_count++;
+            }
+            prev_weight = weight;
+
+            if (trace) {
+                trace->push_back(output);
+            }
+        }
+        total += dataset.rows.size();
+    }
+
+    metrics.rms_error_yaw = total ? std::sqrt(error_sq_sum / total) : 0;
+    metrics.rms_residual_yaw = total ? std::sqrt(residual_sq_sum / total) : 0;
+    metrics.weight_drift = drift_count ? drift_sum / drift_count : 0;
+    metrics.weight_clamped = total ? (double)clamped / total : 0;
+    metrics.final_weight = weight;
+    metrics.score = metrics.rms_residual_yaw * (1.0 + metrics.weight_drift);
+}
+
+template void replayICO<float>(const ICOConfig &, const std::vector<ReplayDataset> &,
+                               ReplayMetrics &, std::vector<double> *);
+template void replayICO<double>(const ICOConfig &, const std::vector<ReplayDataset> &,
+                                ReplayMetrics &, std::vector<double> *);
@@ -0,0 +1,60 @@
+/*
+ * Open-loop replay of logged CCU runs through ICOAlgo::computeChange on the host.
+ *
+ * The replay mirrors the yaw path of timerISR in src/main.cpp: the logged (already Kalman
+ * filtered) gyro_z is constrained to 0..500 deg/s and fed as reflex and predictive input,
+ * the setpoint is setpoint / setpoint_radius in deg/s. The car does not react to the
+ * replayed output, so the metrics compare configurations, not closed-loop performance.
+ * The reflex error only depends on the log, so rms_error_yaw is the same for every
+ * configuration on the same datasets. The ranking uses rms_residual_yaw instead: the ICO
+ * output is the yaw correction (deg/s) added to the command, the residual is the error
+ * that is left after it, so a configuration scores by how well its output cancels the
+ * error the log shows, both in deg/s. A configuration whose weight ran into the +-3 clamp
+ * learned nothing the log can confirm, icosweep ranks those after all the others.
+ */
+
+#ifndef ICO_REPLAY_H
+#define ICO_REPLAY_H
+
+#include <string>
+#include <vector>
+
+struct ReplayRow {
+    double gyro_z;          // Filtered gyro z (deg/s) as logged
+    double setpoint;        // Setpoint (m/s)
+    double setpoint_radius; // Setpoint radius (m)
+};
+
+struct ReplayDataset {
+    std::string name;
+    std::vector<ReplayRow> rows;
+};
+
+struct ICOConfig {
+    double omega0;
+    double omega1;
+    double eta;
+    bool resonator_bank;
+};
+
+struct ReplayMetrics {
+    double rms_error_yaw;   // RMS of the reflex error (deg/s) over all rows, the same for every configuration
+    double rms_residual_yaw; // RMS of the reflex error minus the ICO output (deg/s)
+    double weight_drift;    // Mean |d omega_n / dt| over the last 20% of each run (1/s)
+    double weight_clamped;  // Fraction of rows with the predictive weight at its +-3 limit
+    double final_weight;    // Summed predictive weight at the end of the last run
+    double score;           // rms_residual_yaw * (1 + weight_drift), lower is better
+};
+
+/// @brief Load the gyro_z, setpoint and setpoint_radius columns of a CCU log
+/// @return false if the file cannot be read or a column is missing
+bool loadReplayDataset(const char *path, ReplayDataset &dataset);
+
+/// @brief Replay all datasets with one configuration, each run starts from a fresh ICO
+/// @tparam T Scalar type of the filters and ICO (instantiated for float and double)
+/// @param trace If not null, receives the ICO output of every row
+template <typename T>
+void replayICO(const ICOConfig &config, const std::vector<ReplayDataset> &datasets,
+               ReplayMetrics &metrics, std::vector<double> *trace = nullptr);
+
+#endif // ICO_REPLAY_H
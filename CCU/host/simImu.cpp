@@ -0,0 +1,145 @@
+#include "simImu.h"
+
+#define SIM_IMU_GYRO_OFFSET_LSB 0.061f                      // dps
+#define SIM_IMU_ACCEL_OFFSET_LSB (0.0039f * BMX160_GRAVITY) // m/s²
+
+SimImu::SimImu(const SimImuParams &params, uint32_t seed)
+    : _params(params), _rng(seed), _normal(0.0f, 1.0f), _ptr(0), _now_us(0), _nextSample_us(0),
+      _focDone_us(0) {
+    reset();
+}
+
+void SimImu::reset() {
+    memset(_regs, 0, sizeof(_regs));
+    _regs[BMX160_CHIP_ID_ADDR] = BMX160_CHIP_ID;
+    _regs[BMX160_ACCEL_CONFIG_ADDR] = 0x28; // Power-on defaults: 100 Hz, +-2 g, +-2000 dps
+    _regs[BMX160_ACCEL_RANGE_ADDR] = 0x03;
+    _regs[BMX160_GYRO_CONFIG_ADDR] = 0x28;
+    _regs[BMX160_GYRO_RANGE_ADDR] = 0x00;
+    _focDone_us = 0;
+}
+
+void SimImu::update(uint64_t now_us, const float gyro[3], const float accel[3], float heading) {
+    _now_us = now_us;
+    if (_focDone_us != 0 && now_us >= _focDone_us) {
+        finishFoc(gyro, accel);
+    }
+    while (now_us >= _nextSample_us) {
+        const uint32_t period = odrPeriodUs();
+        const float walk = _params.gyro_bias_walk * sqrtf(period * 1e-6f);
+        for (int i = 0; i < 3; i++) {
+            _params.gyro_bias[i] += walk * _normal(_rng);
+        }
+        sample(gyro, accel, heading);
+        _nextSample_us += period;
+    }
+}
+
+void SimImu::sample(const float gyro[3], const float accel[3], float heading) {
+    float g[3], a[3];
+    for (int i = 0; i < 3; i++) {
+        g[i] = gyro[i] + _params.gyro_bias[i] + gyroOffset(i) + _params.gyro_noise * _normal(_rng);
+        a[i] = accel[i] + _params.accel_bias[i] + accelOffset(i) + _params.accel_noise * _normal(_rng);
+    }
+    // Field in the sensor frame, x right and y forward: it turns against the heading
+    const float m[3] = {SIM_IMU_FIELD_UT * sinf(heading), SIM_IMU_FIELD_UT * cosf(heading), -SIM_IMU_FIELD_UT};
+
+    const uint8_t accel_shift = _regs[BMX160_ACCEL_RANGE_ADDR] == 0x05 ? 1 :
+                                _regs[BMX160_ACCEL_RANGE_ADDR] == 0x08 ? 2 :
+                                _regs[BMX160_ACCEL_RANGE_ADDR] == 0x0C ? 3 : 0;
+    putRaw(BMX160_GYRO_DATA_ADDR, g, 16.4f * (1 << (_regs[BMX160_GYRO_RANGE_ADDR] & 0x07)));
+    putRaw(BMX160_ACCEL_DATA_ADDR, a, (16384 >> accel_shift) / BMX160_GRAVITY);
+    putRaw(BMX160_MAG_DATA_ADDR, m, 1.0f / BMX160_MAGN_UT_LSB);
+}
+
+void SimImu::putRaw(uint8_t reg, const float value[3], float lsb) {
+    for (int i = 0; i < 3; i++) {
+        const int32_t raw = constrain(lroundf(value[i] * lsb), -32768L, 32767L);
+        _regs[reg + 2 * i] = (uint8_t)(raw & 0xFF);
+        _regs[reg + 2 * i + 1] = (uint8_t)((raw >> 8) & 0xFF);
+    }
+}
+
+void SimImu::finishFoc(const float gyro[3], const float accel[3]) {
+    // The sensor averages its own output, the noise averages out
+    const uint8_t conf = _regs[BMX160_FOC_CONF_ADDR];
+    uint8_t high = _regs[BMX160_OFFSET_CONF_ADDR] & 0xC0;
+    for (int i = 0; i < 3; i++) {
+        int32_t offset = 0;
+        if (conf & BMX160_GYRO_FOC_EN_MASK) {
+            offset = lroundf(-(gyro[i] + _params.gyro_bias[i]) / SIM_IMU_GYRO_OFFSET_LSB);
+            offset = constrain(offset, -512L, 511L);
+        } else {
+            offset = _regs[BMX160_OFFSET_ADDR + 3 + i] | (((_regs[BMX160_OFFSET_CONF_ADDR] >> (2 * i)) & 0x03) << 8);
+        }
+        _regs[BMX160_OFFSET_ADDR + 3 + i] = (uint8_t)(offset & 0xFF);
+        high |= ((offset >> 8) & 0x03) << (2 * i);
+
+        const uint8_t target = (conf >> (4 - 2 * i)) & 0x03; // x in bits 4-5, z in bits 0-1
+        if (target != BMX160_FOC_ACCEL_DISABLED) {
+            const float g = target == BMX160_FOC_ACCEL_POSITIVE_G ? BMX160_GRAVITY :
+                            target == BMX160_FOC_ACCEL_NEGATIVE_G ? -BMX160_GRAVITY : 0.0f;
+            int32_t accel_offset = lroundf(-(accel[i] + _params.accel_bias[i] - g) / SIM_IMU_ACCEL_OFFSET_LSB);
+            _regs[BMX160_OFFSET_ADDR + i] = (uint8_t)(int8_t)constrain(accel_offset, -128L, 127L);
+        }
+    }
+    _regs[BMX160_OFFSET_CONF_ADDR] = high;
+    _regs[BMX160_STATUS_ADDR] |= BMX160_FOC_STATUS_MASK;
+    _focDone_us = 0;
+}
+
+float SimImu::gyroOffset(int axis) const {
+    if (!(_regs[BMX160_OFFSET_CONF_ADDR] & BMX160_GYRO_OFFSET_EN_MASK)) return 0;
+    int16_t offset = _regs[BMX160_OFFSET_ADDR + 3 + axis] | (((_regs[BMX160_OFFSET_CONF_ADDR] >> (2 * axis)) & 0x03) << 8);
+    if (offset & 0x200) offset -= 0x400;
+    return offset * SIM_IMU_GYRO_OFFSET_LSB;
+}
+
+float SimImu::accelOffset(int axis) const {
+    if (!(_regs[BMX160_OFFSET_CONF_ADDR] & BMX160_ACCEL_OFFSET_EN_MASK)) return 0;
+    return (int8_t)_regs[BMX160_OFFSET_ADDR + axis] * SIM_IMU_ACCEL_OFFSET_LSB;
+}
+
+float SimImu::residualGyroBias(int axis) const {
+    return _params.gyro_bias[axis] + gyroOffset(axis);
+}
+
+uint32_t SimImu::odrPeriodUs() const {
+    const int odr = _regs[BMX160_GYRO_CONFIG_ADDR] & 0x0F; // 0x08: 100 Hz, each step doubles
+    if (odr < BMX160_GYRO_ODR_25HZ || odr > BMX160_GYRO_ODR_3200HZ) return 10000;
+    return odr >= 8 ? 10000 >> (odr - 8) : 10000 << (8 - odr);
+}
+
+bool SimImu::receive(const uint8_t *data, uint8_t length) {
+    if (length == 0) return true; // Address probe
+    _ptr = data[0] & 0x7F;
+    for (uint8_t i = 1; i < length; i++) {
+        store(_ptr++, data[i]);
+    }
+    return true;
+}
+
+void SimImu::store(uint8_t reg, uint8_t value) {
+    reg &= 0x7F;
+    if (reg == BMX160_COMMAND_REG_ADDR) {
+        if (value == BMX160_SOFT_RESET_CMD) reset();
+        if (value == BMX160_START_FOC_CMD) {
+            _regs[BMX160_STATUS_ADDR] &= ~BMX160_FOC_STATUS_MASK;
+            _focDone_us = _now_us + SIM_IMU_FOC_US;
+        }
+        return;
+    }
+    _regs[reg] = value;
+}
+
+uint8_t SimImu::request(uint8_t *data, uint8_t length) {
+    // SENSORTIME counts 39.0625 us, latched at the read
+    const uint32_t ticks = (uint32_t)(((uint64_t)micros() * 16 / 625) & (BMX160_SENSORTIME_WRAP - 1));
+    _regs[BMX160_SENSORTIME_ADDR] = ticks & 0xFF;
+    _regs[BMX160_SENSORTIME_ADDR + 1] = (ticks >> 8) & 0xFF;
+    _regs[BMX160_SENSORTIME_ADDR + 2] = (ticks >> 16) & 0xFF;
+    for (uint8_t i = 0; i < length; i++) {
+        data[i] = _regs[_ptr++ & 0x7F];
+    }
+    return length;
+}
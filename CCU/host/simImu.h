@@ -0,0 +1,66 @@
+/*
+ * BMX160 model for the virtual bus: the register file the CCU's driver uses, filled from the
+ * simulated motion with bias, noise and the sensor's quantisation.
+ */
+
+#ifndef SIM_IMU_H
+#define SIM_IMU_H
+
+#include <Wire.h>
+#include <BMX160.h>
+#include <random>
+
+#define SIM_IMU_FOC_US 250000   // Fast offset compensation time
+#define SIM_IMU_FIELD_UT 40.0f  // Earth field in the horizontal plane (uT)
+
+struct SimImuParams {
+    float gyro_noise;           // dps RMS per sample
+    float gyro_bias[3];         // dps, at power-up
+    float gyro_bias_walk;       // dps per sqrt(s)
+    float accel_noise;          // m/s² RMS per sample
+    float accel_bias[3];        // m/s²
+};
+
+/**
+ * @brief Register file of a BMX160 behind the virtual bus.
+ *
+ * The data registers are refreshed at the configured gyro output data rate from the last
+ * motion passed to update(), SENSORTIME is latched when it is read. Ranges, soft reset, the
+ * fast offset compensation (FOC) and the offset registers behave as on the sensor, so the
+ * CCU's calibration runs against it unchanged.
+ */
+class SimImu : public HostI2CDevice {
+public:
+    SimImu(const SimImuParams &params, uint32_t seed);
+
+    /// @brief Motion at the sensor: rates (dps), specific force (m/s², gravity included) and
+    /// heading (rad) for the magnetometer. Samples due by now_us are taken from it.
+    void update(uint64_t now_us, const float gyro[3], const float accel[3], float heading);
+
+    bool receive(const uint8_t *data, uint8_t length) override;
+    uint8_t request(uint8_t *data, uint8_t length) override;
+
+    /// @brief Gyro offset the sensor still outputs at rest (dps), after its offset registers
+    float residualGyroBias(int axis) const;
+
+private:
+    void reset();
+    void sample(const float gyro[3], const float accel[3], float heading);
+    void finishFoc(const float gyro[3], const float accel[3]);
+    void store(uint8_t reg, uint8_t value);
+    void putRaw(uint8_t reg, const float value[3], float lsb);
+    float gyroOffset(int axis) const;   // dps the offset registers subtract, 0 if disabled
+    float accelOffset(int axis) const;  // m/s²
+    uint32_t odrPeriodUs() const;
+
+    SimImuParams _params;
+    std::mt19937 _rng;
+    std::normal_distribution<float> _normal;
+    uint8_t _regs[128];
+    uint8_t _ptr;
+    uint64_t _now_us;
+    uint64_t _nextSample_us;
+    uint64_t _focDone_us;       // 0 without a running FOC
+};
+
+#endif // SIM_IMU_H
@@ -0,0 +1,141 @@
+#include "simMotorUnit.h"
+
+// As MU/src/main.cpp and i2c_slave.h
+#define MU_WHEEL_DIA 0.068
+#define MU_CMD_SET_PARAM 0x10
+#define MU_CMD_SET_SETPOINT 0x20
+#define MU_SCALE_SPEED 71.0
+#define MU_SCALE_TORQUE 0.5
+#define MU_SCALE_RPM 0.25
+#define MU_SCALE_CURRENT 57.0
+#define MU_SCALE_INTERNAL_TORQUE 2
+#define MU_VTORPM 280.862
+#define MU_RPMTOV 0.00356
+
+// The AVR converts through an integer, only the low byte goes on the bus
+static uint8_t muByte(double value) {
+    return (uint8_t)(long)value;
+}
+
+SimMotorUnit::SimMotorUnit(const SimMotorParams &params)
+    : _params(params), _omega0(params.no_load_rpm * 2 * PI / 60),
+      _inertia(params.tau * params.stall_torque / _omega0),
+      _pid(0.3, 5, 0.0, 0, SIM_MU_CONTROL_US * 1e-6), _sensor(3, 5, 0, 10),
+      _mode(0), _setpoint(0), _kp(0), _ki(0), _kd(0), _newGains(false),
+      _currentRPM(0.001), _currentTorque(1), _currentVelocity(1), _motorCurrent(1), _pwm(0),
+      _omega(0), _angle(0), _lastPulse_us(0), _timeBetweenPulses(0), _pulsed(false) {}
+
+float SimMotorUnit::motorTorque() const {
+    return _params.stall_torque * (_pwm / 255.0f - _omega / _omega0);
+}
+
+float SimMotorUnit::motorCurrent() const {
+    return _params.stall_current * (_pwm / 255.0f - _omega / _omega0);
+}
+
+void SimMotorUnit::control() {
+    // controlLoop()
+    if (_pulsed) {
+        _pulsed = false;
+        double rawRPM = ((1e6 * 60.0) / SIM_MU_HALL_PULSES) / _timeBetweenPulses;
+        if (rawRPM > 2000) rawRPM = 0;
+        _currentRPM = _sensor.getFilteredRPM(rawRPM);
+        _currentVelocity = (_currentRPM * PI * MU_WHEEL_DIA) / 60;
+    }
+
+    // The sensor only sees current into the motor, 10 bit ADC on 5 V
+    const int adc = constrain((int)(motorCurrent() * SIM_MU_CURRENT_V_PER_A / 5.0 * 1023 + 0.5), 0, 1023);
+    _motorCurrent = _sensor.getFilteredCurrent(((adc * 5.0) / 1023.0) / SIM_MU_CURRENT_V_PER_A);
+    _currentTorque = 98.1 * MU_SCALE_INTERNAL_TORQUE * _motorCurrent;
+
+    double output = 0;
+    switch (_mode) {
+        case 0: output = _pid.compute(_currentRPM); break;
+        case 1: output = _pid.compute(_currentTorque); break;
+        case 2: output = _pid.compute(_currentRPM); break;
+        default: break;
+    }
+    _pwm = constrain(output, 0, 255);
+
+    // loop()
+    _pid.setSetpoint(_setpoint);
+    if (_newGains) {
+        _pid.setGains(_kp, _ki, _kd);
+        _newGains = false;
+    }
+}
+
+void SimMotorUnit::integrate(float load_torque, float dt, uint64_t now_us) {
+    _omega += (motorTorque() - load_torque) / _inertia * dt;
+
+    // The hall sensor does not tell the direction, every pulse counts
+    _angle += fabs(_omega) * dt / (2 * PI);
+    const double pulse = 1.0 / SIM_MU_HALL_PULSES;
+    if (_angle >= pulse) {
+        _angle = fmod(_angle, pulse);
+        // Interpolated back to the edge within the step
+        const uint64_t edge_us = now_us - (uint64_t)(_angle / (fabs(_omega) / (2 * PI)) * 1e6);
+        if (_lastPulse_us != 0) {
+            _timeBetweenPulses = (uint32_t)(edge_us - _lastPulse_us);
+            _pulsed = _timeBetweenPulses > 0;
+        }
+        _lastPulse_us = edge_us;
+    }
+}
+
+bool SimMotorUnit::receive(const uint8_t *data, uint8_t length) {
+    if (length == 0) return true; // Address probe
+    switch (data[0]) {
+        case MU_CMD_SET_PARAM:
+            if (length == 8) {
+                _mode = data[1];
+                _kp = static_cast<double>(static_cast<uint16_t>((data[2] << 8) | data[3])) / 1000;
+                _ki = static_cast<double>(static_cast<uint16_t>((data[4] << 8) | data[5])) / 800;
+                _kd = static_cast<double>(static_cast<uint16_t>((data[6] << 8) | data[7])) / 10000;
+                _newGains = true;
+            }
+            break;
+        case MU_CMD_SET_SETPOINT:
+            if (length == 2) {
+                switch (_mode) {
+                    case 0: _setpoint = (data[1] / MU_SCALE_SPEED) * MU_VTORPM; break;
+                    case 1: _setpoint = data[1] / (MU_SCALE_TORQUE / MU_SCALE_INTERNAL_TORQUE); break;
+                    case 2: _setpoint = data[1] / MU_SCALE_RPM; break;
+                    default: break;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    return true; // The AVR acknowledges every byte, even of a frame it ignores
+}
+
+uint8_t SimMotorUnit::request(uint8_t *data, uint8_t length) {
+    uint8_t reply[3];
+    uint8_t count = 0;
+    switch (_mode) {
+        case 0:
+            reply[count++] = muByte((_setpoint * MU_SCALE_SPEED) * MU_RPMTOV);
+            reply[count++] = muByte(_currentVelocity * MU_SCALE_SPEED);
+            break;
+        case 1:
+            reply[count++] = muByte(_setpoint * (MU_SCALE_TORQUE / MU_SCALE_INTERNAL_TORQUE));
+            reply[count++] = muByte(_currentTorque * (MU_SCALE_TORQUE / MU_SCALE_INTERNAL_TORQUE));
+            break;
+        case 2:
+            reply[count++] = muByte(_setpoint * MU_SCALE_RPM);
+            reply[count++] = muByte(_currentRPM * MU_SCALE_RPM);
+            break;
+        default:
+            reply[count++] = 0xFF;
+            break;
+    }
+    reply[count++] = muByte(_motorCurrent * MU_SCALE_CURRENT);
+
+    // Wire on the AVR pads a short reply with 0xFF
+    for (uint8_t i = 0; i < length; i++) {
+        data[i] = i < count ? reply[i] : 0xFF;
+    }
+    return length;
+}
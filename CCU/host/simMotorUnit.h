@@ -0,0 +1,79 @@
+/*
+ * Motor unit model for the virtual bus: the MU firmware's protocol and 1 ms control loop
+ * (MU/src) in front of a DC motor and its wheel.
+ */
+
+#ifndef SIM_MOTOR_UNIT_H
+#define SIM_MOTOR_UNIT_H
+
+#include <Wire.h>
+#include "../../MU/src/motor_pid.h"
+#include "../../MU/src/motor_sensor.h"
+
+#define SIM_MU_HALL_PULSES 110      // Hall pulses per wheel revolution
+#define SIM_MU_CURRENT_V_PER_A 1.1  // Current sense amplifier
+#define SIM_MU_CONTROL_US 1000      // timer1 period of the MU
+
+struct SimMotorParams {
+    float no_load_rpm;          // Wheel rpm at full PWM without load
+    float stall_torque;         // Nm at the wheel at full PWM
+    float stall_current;        // A at full PWM
+    float tau;                  // s, mechanical time constant of motor and wheel without load
+};
+
+/**
+ * @brief One MU: the I2C protocol of I2CSlave, the MotorPID and MotorSensor filters driven as
+ * in MU/src/main.cpp, the hall sensor, the current ADC and the motor.
+ *
+ * I2CSlave is a singleton bound to the AVR Wire, so its decoding is repeated here byte for
+ * byte; MotorPID and MotorSensor are the firmware's own. The wheel is integrated by the
+ * vehicle through integrate(), control() runs the MU's control loop.
+ */
+class SimMotorUnit : public HostI2CDevice {
+public:
+    explicit SimMotorUnit(const SimMotorParams &params);
+
+    /// @brief The MU's controlLoop() and loop(), every SIM_MU_CONTROL_US
+    void control();
+    /// @brief Advance the wheel by dt against the road's torque on it (Nm, opposing positive
+    /// rotation), now_us is the time at the end of the step
+    void integrate(float load_torque, float dt, uint64_t now_us);
+
+    float omega() const { return _omega; }      // rad/s of the wheel
+    float rpm() const { return _currentRPM; }   // As the MU reports it
+
+    bool receive(const uint8_t *data, uint8_t length) override;
+    uint8_t request(uint8_t *data, uint8_t length) override;
+
+private:
+    float motorTorque() const;
+    float motorCurrent() const;
+
+    SimMotorParams _params;
+    float _omega0;              // rad/s no load
+    float _inertia;             // kg m² seen at the wheel
+    MotorPID _pid;
+    MotorSensor _sensor;
+
+    // I2CSlave state
+    uint8_t _mode;
+    double _setpoint;
+    double _kp, _ki, _kd;
+    bool _newGains;
+
+    // MU main.cpp state
+    double _currentRPM;
+    double _currentTorque;
+    double _currentVelocity;
+    double _motorCurrent;
+    int _pwm;
+
+    // Wheel and hall sensor
+    float _omega;
+    double _angle;              // Revolutions since the last hall pulse
+    uint64_t _lastPulse_us;
+    uint32_t _timeBetweenPulses;
+    bool _pulsed;
+};
+
+#endif // SIM_MOTOR_UNIT_H
@@ -0,0 +1,70 @@
+#include "vehicleSim.h"
+
+// Wheel contact points from the rear axle centre, x forward and y to the left
+static const float wheel_x[4] = {d_wheelbase, d_wheelbase, 0, 0};
+static const float wheel_y[4] = {d_track / 2, -d_track / 2, d_track / 2, -d_track / 2};
+
+VehicleSim::VehicleSim(const VehicleParams &params, uint32_t seed)
+    : _params(params), _imu(params.imu, seed),
+      _mu{SimMotorUnit(params.motor[0]), SimMotorUnit(params.motor[1]),
+          SimMotorUnit(params.motor[2]), SimMotorUnit(params.motor[3])},
+      _v(0), _omega(0), _vDot(0), _omegaDot(0), _heading(0), _x(0), _y(0), _maxSlip(0) {
+    // Uniform plate of wheelbase by track, moved to the rear axle
+    const float c = d_wheelbase / 2;
+    _inertia = params.mass * (d_wheelbase * d_wheelbase + d_track * d_track) / 12 + params.mass * c * c;
+}
+
+void VehicleSim::attach(TwoWire &wire) {
+    for (int i = 0; i < 4; i++) {
+        wire.attach(VEHICLE_SIM_MU_ADDRESS + i, &_mu[i]);
+    }
+    wire.attach(VEHICLE_SIM_IMU_ADDRESS, &_imu);
+}
+
+void VehicleSim::step(uint64_t now_us) {
+    for (int i = 0; i < 4; i++) {
+        _mu[i].control();
+    }
+
+    const float dt = VEHICLE_SIM_STEP_US * 1e-6f / VEHICLE_SIM_SUBSTEPS;
+    const float radius = d_wheel / 2;
+    const float c = d_wheelbase / 2;
+    const float m = _params.mass;
+    const float traction = _params.friction * m * VEHICLE_SIM_GRAVITY / 4;
+    for (int s = 0; s < VEHICLE_SIM_SUBSTEPS; s++) {
+        const uint64_t t_us = now_us - VEHICLE_SIM_STEP_US + (uint64_t)(s + 1) * VEHICLE_SIM_STEP_US / VEHICLE_SIM_SUBSTEPS;
+        float fx = 0, moment = 0;
+        for (int i = 0; i < 4; i++) {
+            // Rolling direction: the body axis at the rear, the direction of travel at the front
+            const float cx = _v - _omega * wheel_y[i];
+            const float cy = _omega * wheel_x[i];
+            float dx = 1, dy = 0;
+            const float cv = sqrtf(cx * cx + cy * cy);
+            if (wheel_x[i] > 0 && cv > 1e-3f) {
+                dx = (cx >= 0 ? cx : -cx) / cv;
+                dy = (cx >= 0 ? cy : -cy) / cv;
+            }
+            const float slip = _mu[i].omega() * radius - (cx * dx + cy * dy);
+            if (fabsf(slip) > _maxSlip) _maxSlip = fabsf(slip);
+            const float force = traction * tanhf(slip / VEHICLE_SIM_SLIP);
+            fx += force * dx;
+            moment += wheel_x[i] * force * dy - wheel_y[i] * force * dx;
+            _mu[i].integrate(force * radius, dt, t_us);
+        }
+        fx -= _params.rolling * m * VEHICLE_SIM_GRAVITY * tanhf(_v / 0.01f);
+
+        // The rear axle carries the side force, no moment about its centre
+        _vDot = fx / m + c * _omega * _omega;
+        _omegaDot = (moment - m * c * _v * _omega) / _inertia;
+        _v += _vDot * dt;
+        _omega += _omegaDot * dt;
+        _heading += _omega * dt;
+        _x += _v * cosf(_heading) * dt;
+        _y += _v * sinf(_heading) * dt;
+    }
+
+    // The IMU sits at the centre of mass, x to the right, y forward, z up
+    const float gyro[3] = {0, 0, _omega * (float)RAD_TO_DEG};
+    const float accel[3] = {-(c * _omegaDot + _v * _omega), _vDot - c * _omega * _omega, VEHICLE_SIM_GRAVITY};
+    _imu.update(now_us, gyro, accel, _heading);
+}
@@ -0,0 +1,63 @@
+/*
+ * Plant of the car simulator: body, wheels and motor units, and the BMX160 on the virtual bus.
+ */
+
+#ifndef VEHICLE_SIM_H
+#define VEHICLE_SIM_H
+
+#include "simImu.h"
+#include "simMotorUnit.h"
+#include "../src/kinematic.h"
+
+#define VEHICLE_SIM_STEP_US 1000    // One MU control period per step()
+#define VEHICLE_SIM_SUBSTEPS 10     // Wheel slip is stiff, the body is integrated at 100 us
+#define VEHICLE_SIM_SLIP 0.05f      // m/s of slip at which traction is 76 % of its limit
+#define VEHICLE_SIM_MU_ADDRESS 0x08 // MU0-MU3 in Velocities_acker order
+#define VEHICLE_SIM_IMU_ADDRESS 0x68
+#define VEHICLE_SIM_GRAVITY 9.80665f
+
+struct VehicleParams {
+    float mass;                 // kg
+    float friction;             // Tyre-road friction coefficient
+    float rolling;              // Rolling resistance coefficient
+    SimMotorParams motor[4];    // Left front, right front, left rear, right rear
+    SimImuParams imu;
+};
+
+/**
+ * @brief The car on a flat floor, state at the rear axle centre.
+ *
+ * The rear wheels do not slide sideways, the front wheels turn freely into their direction of
+ * travel, as the kinematic model of the CCU assumes (d_track, d_wheelbase, d_wheel). Every
+ * wheel pushes along its rolling direction with a traction that saturates at friction times
+ * its load; the body has its centre of mass halfway between the axles.
+ */
+class VehicleSim {
+public:
+    VehicleSim(const VehicleParams &params, uint32_t seed);
+
+    /// @brief Put the MUs and the IMU on the bus
+    void attach(TwoWire &wire);
+    /// @brief Advance by VEHICLE_SIM_STEP_US to now_us: MU control loops, wheels and body, IMU
+    void step(uint64_t now_us);
+
+    float speed() const { return _v; }                          // m/s of the rear axle centre
+    float yawRate() const { return _omega * RAD_TO_DEG; }       // dps, positive turning left
+    float heading() const { return _heading; }                  // rad
+    float x() const { return _x; }
+    float y() const { return _y; }
+    float maxSlip() const { return _maxSlip; }                  // m/s, largest since the start
+    const SimImu &imu() const { return _imu; }
+
+private:
+    VehicleParams _params;
+    SimImu _imu;
+    SimMotorUnit _mu[4];
+    float _inertia;             // kg m² about the rear axle centre
+    float _v, _omega;           // m/s, rad/s
+    float _vDot, _omegaDot;     // From the last substep, for the accelerometer
+    float _heading, _x, _y;
+    float _maxSlip;
+};
+
+#endif // VEHICLE_SIM_H
@@ -0,0 +1,79 @@
+/*
+ * Work-stealing thread pool for host tools.
+ *
+ * run() seeds every worker with a contiguous block of task indices. A worker pops tasks
+ * from the back of its own deque and, once empty, steals from the front of the other
+ * workers' deques, so uneven task costs still keep every core busy until the end.
+ */
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threads = 0)
+        : threads_(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+    unsigned getThreadCount() const { return threads_; }
+
+    /// @brief Run task(i) for i in [0, task_count), blocks until all tasks are done
+    void run(size_t task_count, const std::function<void(size_t)>& task) {
+        std::vector<Worker> workers(threads_);
+        for (size_t i = 0; i < task_count; i++) {
+            workers[(i * threads_) / task_count].tasks.push_back(i);
+        }
+
+        std::vector<std::thread> pool;
+        for (unsigned w = 0; w < threads_; w++) {
+            pool.emplace_back([&, w]() {
+                size_t index;
+                while (pop(workers[w], index) || steal(workers, w, index)) {
+                    task(index);
+                }
+            });
+        }
+        for (auto &t : pool) {
+            t.join();
+        }
+    }
+
+private:
+    struct Worker {
+        std::mutex lock;
+        std::deque<size_t> tasks;
+    };
+
+    static bool pop(Worker &worker, size_t &index) {
+        std::lock_guard<std::mutex> guard(worker.lock);
+        if (worker.tasks.empty()) {
+            return false;
+        }
+        index = worker.tasks.back();
+        worker.tasks.pop_back();
+        return true;
+    }
+
+    static bool steal(std::vector<Worker> &workers, unsigned self, size_t &index) {
+        for (size_t n = 1; n < workers.size(); n++) {
+            Worker &victim = workers[(self + n) % workers.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                index = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    unsigned threads_;
+};
+
+#endif // WORK_STEALING_POOL_H
@@ -0,0 +1,128 @@
+/*
+ * icosweep - replay logged runs through ICOAlgo and rank omega0/omega1/eta combinations.
+ *
+ * The rank is the yaw error left after the ICO output (see host/ico_replay.h), for the
+ * configurations whose predictive weight stayed inside its clamp.
+ *
+ * Usage: icosweep [options] log.csv [log2.csv ...]
+ *   --omega0 start:stop:step   Reflex weight grid        (default 0.05:1.0:0.05)
+ *   --omega1 start:stop:step   Predictive start grid     (default 0.1:2.0:0.1)
+ *   --eta v1,v2,...            Learning rates            (default 1e-6,3e-6,1e-5,3e-5,1e-4,3e-4,1e-3)
+ *   --bank                     Also feed the resonator bank (ICO_RESONATOR_BANK)
+ *   --threads N                Worker threads            (default all cores)
+ *   --top N                    Rows to print             (default 20)
+ *
+ * Example: ./icosweep ../datasets/15-04-2025/ICO_1_0_10_0.csv ../datasets/15-04-2025/ICO_3_0_60_0.csv
+ */
+
+#include "host/ico_replay.h"
+#include "host/work_stealing_pool.h"
+#include "src/controlScalar.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static std::vector<double> parseRange(const char *arg) {
+    std::vector<double> values;
+    double start, stop, step;
+    if (sscanf(arg, "%lf:%lf:%lf", &start, &stop, &step) == 3 && step > 0) {
+        for (int i = 0; start + i * step <= stop + step * 1e-6; i++) {
+            values.push_back(start + i * step);
+        }
+    }
+    return values;
+}
+
+static std::vector<double> parseList(const char *arg) {
+    std::vector<double> values;
+    const char *p = arg;
+    while (*p) {
+        char *end;
+        values.push_back(strtod(p, &end));
+        p = (*end == ',') ? end + 1 : end;
+        if (end == p && *p != '\0') break;
+    }
+    return values;
+}
+
+int main(int argc, char **argv) {
+    std::vector<double> omega0_grid = parseRange("0.05:1.0:0.05");
+    std::vector<double> omega1_grid = parseRange("0.1:2.0:0.1");
+    std::vector<double> eta_grid = parseList("1e-6,3e-6,1e-5,3e-5,1e-4,3e-4,1e-3");
+    bool bank = false;
+    unsigned threads = 0;
+    size_t top = 20;
+    std::vector<ReplayDataset> datasets;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--omega0") && i + 1 < argc) omega0_grid = parseRange(argv[++i]);
+        else if (!strcmp(argv[i], "--omega1") && i + 1 < argc) omega1_grid = parseRange(argv[++i]);
+        else if (!strcmp(argv[i], "--eta") && i + 1 < argc) eta_grid = parseList(argv[++i]);
+        else if (!strcmp(argv[i], "--bank")) bank = true;
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--top") && i + 1 < argc) top = atoi(argv[++i]);
+        else {
+            ReplayDataset dataset;
+            if (!loadReplayDataset(argv[i], dataset)) {
+                fprintf(stderr, "Error: could not load %s (needs gyro_z, setpoint, setpoint_radius)\n", argv[i]);
+                return 1;
+            }
+            datasets.push_back(dataset);
+        }
+    }
+    if (datasets.empty() || omega0_grid.empty() || omega1_grid.empty() || eta_grid.empty()) {
+        fprintf(stderr, "Usage: %s [--omega0 a:b:s] [--omega1 a:b:s] [--eta v,..] [--bank] [--threads N] [--top N] log.csv ...\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<ICOConfig> configs;
+    for (double omega0 : omega0_grid)
+        for (double omega1 : omega1_grid)
+            for (double eta : eta_grid)
+                configs.push_back({omega0, omega1, eta, bank});
+
+    size_t rows = 0;
+    for (const ReplayDataset &dataset : datasets) rows += dataset.rows.size();
+
+    std::vector<ReplayMetrics> results(configs.size());
+    WorkStealingPool pool(threads);
+
+    auto start = std::chrono::steady_clock::now();
+    pool.run(configs.size(), [&](size_t i) { replayICO<control_scalar_t>(configs[i], datasets, results[i]); });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<size_t> order(configs.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    // Clamped weights say nothing about the configuration, those rank after every unclamped one
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        const bool clamped_a = results[a].weight_clamped > 0;
+        const bool clamped_b = results[b].weight_clamped > 0;
+        return (clamped_a != clamped_b) ? clamped_b : results[a].score < results[b].score;
+    });
+    const size_t unclamped = std::count_if(results.begin(), results.end(),
+                                           [](const ReplayMetrics &m) { return m.weight_clamped == 0; });
+
+    printf("# %zu configurations x %zu rows on %u threads in %.3f s (%.0f configs/s, %.1f Mrows/s)\n",
+           configs.size(), rows, pool.getThreadCount(), seconds,
+           configs.size() / seconds, configs.size() * rows / seconds / 1e6);
+    if (unclamped == 0) {
+        printf("# Every configuration ran into the weight clamp, the replay cannot rank them, the rows only report the output statistics\n");
+    } else if (unclamped < order.size()) {
+        printf("# %zu configurations ranked, %zu ran into the weight clamp and follow unranked\n",
+               unclamped, order.size() - unclamped);
+    }
+    printf("rank, omega0, omega1, eta, rms_error_yaw, rms_residual_yaw, weight_drift, weight_clamped, final_weight, score\n");
+    for (size_t r = 0; r < std::min(top, order.size()); r++) {
+        const ICOConfig &c = configs[order[r]];
+        const ReplayMetrics &m = results[order[r]];
+        printf("%zu, %.3f, %.3f, %.1e, %.3f, %.3f, %.5f, %.3f, %.5f, %.4f\n",
+               r + 1, c.omega0, c.omega1, c.eta, m.rms_error_yaw, m.rms_residual_yaw, m.weight_drift,
+               m.weight_clamped, m.final_weight, m.score);
+    }
+    return 0;
+}
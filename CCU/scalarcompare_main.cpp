@@ -0,0 +1,84 @@
+/*
+ * scalarcompare - replay logged runs through the ICO pipeline in float and double and report
+ * how far the single-precision outputs drift from the double-precision reference.
+ *
+ * Usage: scalarcompare [options] log.csv [log2.csv ...]
+ *   --omega0 v     Reflex weight         (default 0.2, same as src/main.cpp)
+ *   --omega1 v     Predictive start      (default 0.4)
+ *   --eta v        Learning rate         (default 0.0001)
+ *   --bank         Also feed the resonator bank (ICO_RESONATOR_BANK)
+ *   --bench N      Also time the control kernels over N iterations on this machine
+ *
+ * Every dataset is replayed on its own. Output is CSV:
+ *   dataset, rows, max_abs_diff, rms_diff, weight_float, weight_double, weight_diff
+ */
+
+#include "host/ico_replay.h"
+#include "src/kernelBench.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+int main(int argc, char **argv) {
+    ICOConfig config = {0.2, 0.4, 0.0001, false};
+    unsigned bench_iterations = 0;
+    std::vector<ReplayDataset> datasets;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--omega0") && i + 1 < argc) config.omega0 = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--omega1") && i + 1 < argc) config.omega1 = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--eta") && i + 1 < argc) config.eta = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--bank")) config.resonator_bank = true;
+        else if (!strcmp(argv[i], "--bench") && i + 1 < argc) bench_iterations = atoi(argv[++i]);
+        else {
+            ReplayDataset dataset;
+            if (!loadReplayDataset(argv[i], dataset)) {
+                fprintf(stderr, "Error: could not load %s (needs gyro_z, setpoint, setpoint_radius)\n", argv[i]);
+                return 1;
+            }
+            datasets.push_back(dataset);
+        }
+    }
+    if (datasets.empty() && bench_iterations == 0) {
+        fprintf(stderr, "Usage: %s [--omega0 v] [--omega1 v] [--eta v] [--bank] [--bench N] log.csv ...\n", argv[0]);
+        return 1;
+    }
+
+    if (!datasets.empty()) {
+        printf("dataset, rows, max_abs_diff, rms_diff, weight_float, weight_double, weight_diff\n");
+    }
+    for (const ReplayDataset &dataset : datasets) {
+        std::vector<ReplayDataset> single = {dataset};
+        std::vector<double> trace_float, trace_double;
+        ReplayMetrics metrics_float, metrics_double;
+        replayICO<float>(config, single, metrics_float, &trace_float);
+        replayICO<double>(config, single, metrics_double, &trace_double);
+
+        double max_diff = 0;
+        double sq_sum = 0;
+        for (size_t i = 0; i < trace_double.size(); i++) {
+            double diff = std::fabs(trace_float[i] - trace_double[i]);
+            max_diff = std::max(max_diff, diff);
+            sq_sum += diff * diff;
+        }
+        double rms_diff = trace_double.empty() ? 0 : std::sqrt(sq_sum / trace_double.size());
+
+        printf("%s, %zu, %.3e, %.3e, %.6f, %.6f, %.3e\n", dataset.name.c_str(), trace_double.size(),
+               max_diff, rms_diff, metrics_float.final_weight, metrics_double.final_weight,
+               std::fabs(metrics_float.final_weight - metrics_double.final_weight));
+    }
+
+    if (bench_iterations > 0) {
+        KernelBenchResult results[KERNEL_BENCH_COUNT];
+        runKernelBench(results, bench_iterations);
+        printf("kernel, float_us, double_us, speedup\n");
+        for (int i = 0; i < KERNEL_BENCH_COUNT; i++) {
+            printf("%s, %.4f, %.4f, %.2f\n", results[i].name, results[i].us_float, results[i].us_double,
+                   results[i].us_double / results[i].us_float);
+        }
+    }
+    return 0;
+}
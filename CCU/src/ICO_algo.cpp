@@ -3,7 +3,8 @@
 
 #include "ICO_algo.h"
 
-ICOAlgo::ICOAlgo(double eta, double sampleTime, Reflex& reflex, std::vector<Predictive>& predictive)
+template <typename T>
+ICOAlgoT<T>::ICOAlgoT(T eta, T sampleTime, ReflexT<T>& reflex, std::vector<PredictiveT<T>>& predictive)
     : eta_(eta), sampleTime_(sampleTime), reflex_(reflex), predictive_(predictive)
 {
     reflex_.setSampleTime(sampleTime);
@@ -12,58 +13,98 @@ ICOAlgo::ICOAlgo(double eta, double sampleTime, Reflex& reflex, std::vector<Pred
 #endif
 }
 
-double ICOAlgo::getError() {
+template <typename T>
+T ICOAlgoT<T>::getError() {
     return reflex_.getError();
 }
 
-double ICOAlgo::getEta() {
+template <typename T>
+T ICOAlgoT<T>::getEta() {
     return eta_;
 }
 
-double ICOAlgo::getOmega1() {
+template <typename T>
+T ICOAlgoT<T>::getOmega1() {
     return predictive_.at(0).getOmega_n();
 }
 
-void ICOAlgo::setEta(double eta) {
+template <typename T>
+void ICOAlgoT<T>::setEta(T eta) {
     eta_ = constrain(eta, 0, 1);
     for (auto it = predictive_.begin(); it != predictive_.end(); ++it) {
         it->setEta(eta_);
     }
+    for (auto it = bank_predictive_.begin(); it != bank_predictive_.end(); ++it) {
+        it->setEta(eta_);
+    }
 #ifdef DEBUG_ICO
     Serial.print("SET: Eta set to ");
     Serial.println(eta_);
 #endif
 }
 
-void ICOAlgo::clearFilters() 
+template <typename T>
+void ICOAlgoT<T>::clearFilters() 
 {
     for (auto it = predictive_.begin(); it != predictive_.end(); ++it) {
         it->clearFilter();
     }
     reflex_.clearFilter();
+    for (auto it = bank_predictive_.begin(); it != bank_predictive_.end(); ++it) {
+        it->clearFilter();
+    }
+    if (bank_ != nullptr) {
+        bank_->reset();
+    }
+}
+
+template <typename T>
+void ICOAlgoT<T>::setResonatorBank(ResonatorBankT<T> *bank)
+{
+    bank_ = bank;
+    bank_predictive_.clear();
+    if (bank_ == nullptr) {
+        return;
+    }
+    for (size_t k = 0; k < bank_->size(); k++) {
+        bank_predictive_.emplace_back(eta_, 0.0);
+    }
+    bank_->reset();
+#ifdef DEBUG_ICO
+    Serial.print("SET: Resonator bank attached, channels = ");
+    Serial.println(bank_->size());
+#endif
 }
 
-double ICOAlgo::computeChange(double input_reflex, double input_prediction, double setpoint) {
+template <typename T>
+T ICOAlgoT<T>::computeChange(T input_reflex, T input_prediction, T setpoint) {
 #ifdef DEBUG_ICO
     Serial.println("CC: Starting computeChange");
 #endif
-    double derivatative_error = reflex_.computeDerivativeError(input_reflex, setpoint);
-    double reflex_out = reflex_.getFilteredError() * reflex_.getOmega0();
-    double predictive_sum = 0;
+    T derivatative_error = reflex_.computeDerivativeError(input_reflex, setpoint);
+    T reflex_out = reflex_.getFilteredError() * reflex_.getOmega0();
+    T predictive_sum = 0;
 #ifdef DEBUG_ICO
     Serial.print("CC: Reflex output = ");
     Serial.println(reflex_out);
 #endif
     for (auto it = predictive_.begin(); it != predictive_.end(); ++it) {
-        double pred_output = it->computeOutput(input_prediction, derivatative_error);
+        T pred_output = it->computeOutput(input_prediction, derivatative_error);
 #ifdef DEBUG_ICO
         Serial.print("CC: Predictive output += ");
         Serial.println(pred_output);
 #endif
         predictive_sum += pred_output;
     }
+    if (bank_ != nullptr) {
+        // One pass over the whole bank, then each resonator output drives its own weight
+        bank_->filter(input_prediction);
+        for (size_t k = 0; k < bank_predictive_.size(); k++) {
+            predictive_sum += bank_predictive_[k].computeOutput(bank_->getOutput(k), derivatative_error);
+        }
+    }
     predictive_sum_ = predictive_sum; 
-    double result = reflex_out + predictive_sum;
+    T result = reflex_out + predictive_sum;
 #ifdef DEBUG_ICO
     Serial.print("CC: Total output = ");
     Serial.println(result);
@@ -71,7 +112,70 @@ double ICOAlgo::computeChange(double input_reflex, double input_prediction, doub
     return result;
 }
 
-void ICOAlgo::updateOmegaValues(double omega0, double omega_predictive_start) {
+template <typename T>
+size_t ICOAlgoT<T>::stateSize() {
+    size_t size = reflex_.stateSize();
+    for (auto it = predictive_.begin(); it != predictive_.end(); ++it) {
+        size += it->stateSize();
+    }
+    for (auto it = bank_predictive_.begin(); it != bank_predictive_.end(); ++it) {
+        size += it->stateSize();
+    }
+    if (bank_ != nullptr) {
+        size += bank_->stateSize();
+    }
+    return size;
+}
+
+template <typename T>
+size_t ICOAlgoT<T>::getState(T *state, size_t max) {
+    size_t size = stateSize();
+    if (max < size) {
+        return 0;
+    }
+    reflex_.getState(state);
+    state += reflex_.stateSize();
+    for (auto it = predictive_.begin(); it != predictive_.end(); ++it) {
+        it->getState(state);
+        state += it->stateSize();
+    }
+    for (auto it = bank_predictive_.begin(); it != bank_predictive_.end(); ++it) {
+        it->getState(state);
+        state += it->stateSize();
+    }
+    if (bank_ != nullptr) {
+        bank_->getState(state);
+    }
+    return size;
+}
+
+template <typename T>
+bool ICOAlgoT<T>::setState(const T *state, size_t count) {
+    if (count != stateSize()) {
+        return false;
+    }
+    reflex_.setState(state);
+    state += reflex_.stateSize();
+    for (auto it = predictive_.begin(); it != predictive_.end(); ++it) {
+        it->setState(state);
+        state += it->stateSize();
+    }
+    for (auto it = bank_predictive_.begin(); it != bank_predictive_.end(); ++it) {
+        it->setState(state);
+        state += it->stateSize();
+    }
+    if (bank_ != nullptr) {
+        bank_->setState(state);
+    }
+#ifdef DEBUG_ICO
+    Serial.print("LOAD: ICO state restored, values = ");
+    Serial.println(count);
+#endif
+    return true;
+}
+
+template <typename T>
+void ICOAlgoT<T>::updateOmegaValues(T omega0, T omega_predictive_start) {
     reflex_.setOmega0(omega0);
 #ifdef DEBUG_ICO
     Serial.print("UPDATE: Omega0 set to ");
@@ -86,7 +190,8 @@ void ICOAlgo::updateOmegaValues(double omega0, double omega_predictive_start) {
     }
 }
 
-void ICOAlgo::resetICO() {
+template <typename T>
+void ICOAlgoT<T>::resetICO() {
     reflex_.resetICO();
 #ifdef DEBUG_ICO
     Serial.println("RESET: Reflex ICO reset");
@@ -97,17 +202,25 @@ void ICOAlgo::resetICO() {
         Serial.println("RESET: Predictive ICO reset");
 #endif
     }
+    for (auto it = bank_predictive_.begin(); it != bank_predictive_.end(); ++it) {
+        it->resetICO();
+    }
+    if (bank_ != nullptr) {
+        bank_->reset();
+    }
 }
 
-Reflex::Reflex(double omega0, double sampleTime, Filter *h0)
+template <typename T>
+ReflexT<T>::ReflexT(T omega0, T sampleTime, FilterT<T> *h0)
 : omega0_(omega0), sampleTime_(sampleTime), h0_(h0) {
 #ifdef DEBUG_ICO
     Serial.println("INIT: Reflex initialized");
 #endif
 }
 
-double ICOAlgo::getomega_n() {
-    double sum = 0;
+template <typename T>
+T ICOAlgoT<T>::getomega_n() {
+    T sum = 0;
     for (auto it = predictive_.begin(); it != predictive_.end(); ++it) {
         sum += it->getOmega_n();
     }
@@ -118,19 +231,23 @@ double ICOAlgo::getomega_n() {
     return sum;
 }
 
-double Reflex::getOmega0() {
+template <typename T>
+T ReflexT<T>::getOmega0() {
     return omega0_;
 }
 
-double Reflex::getError() {
+template <typename T>
+T ReflexT<T>::getError() {
     return error_;
 }
 
-double Reflex::getFilteredError() {
+template <typename T>
+T ReflexT<T>::getFilteredError() {
     return filtered_error_;
 }
 
-void Reflex::setOmega0(double omega0) {
+template <typename T>
+void ReflexT<T>::setOmega0(T omega0) {
     omega0_ = omega0;
 #ifdef DEBUG_ICO
     Serial.print("SET: Reflex omega0 = ");
@@ -138,7 +255,8 @@ void Reflex::setOmega0(double omega0) {
 #endif
 }
 
-void Reflex::setSampleTime(double sampleTime) {
+template <typename T>
+void ReflexT<T>::setSampleTime(T sampleTime) {
     sampleTime_ = sampleTime;
 #ifdef DEBUG_ICO
     Serial.print("SET: Reflex sampleTime = ");
@@ -146,11 +264,13 @@ void Reflex::setSampleTime(double sampleTime) {
 #endif
 }
 
-void Reflex::clearFilter(){
+template <typename T>
+void ReflexT<T>::clearFilter(){
     h0_->reset();
 }
 
-void Reflex::resetICO() {
+template <typename T>
+void ReflexT<T>::resetICO() {
     prev_error_ = 0;
     error_ = 0; // Stores current error
     prev_error_ = 0;   // Previous error for derivative term
@@ -167,7 +287,39 @@ void Reflex::resetICO() {
 #endif
 }
 
-double Reflex::computeDerivativeError(double input_reflex, double setpoint) {
+template <typename T>
+size_t ReflexT<T>::stateSize() {
+    return 6 + ((h0_ != nullptr) ? h0_->stateSize() : 0);
+}
+
+template <typename T>
+void ReflexT<T>::getState(T *state) {
+    state[0] = error_;
+    state[1] = prev_error_;
+    state[2] = filtered_error_;
+    state[3] = filtered_prev_error_;
+    state[4] = S0_current_;
+    state[5] = S0_next_;
+    if (h0_ != nullptr) {
+        h0_->getState(state + 6);
+    }
+}
+
+template <typename T>
+void ReflexT<T>::setState(const T *state) {
+    error_ = state[0];
+    prev_error_ = state[1];
+    filtered_error_ = state[2];
+    filtered_prev_error_ = state[3];
+    S0_current_ = state[4];
+    S0_next_ = state[5];
+    if (h0_ != nullptr) {
+        h0_->setState(state + 6);
+    }
+}
+
+template <typename T>
+T ReflexT<T>::computeDerivativeError(T input_reflex, T setpoint) {
 #ifdef DEBUG_ICO
     Serial.println("CDE: Starting computeDerivativeError");
 #endif
@@ -191,18 +343,21 @@ double Reflex::computeDerivativeError(double input_reflex, double setpoint) {
     return (error_ - prev_error_) / sampleTime_;
 }
 
-Predictive::Predictive(double eta, double omega_predictive_start, Filter *hn)
-: eta_(eta), omega_n_(omega_predictive_start), hn_(hn) {
+template <typename T>
+PredictiveT<T>::PredictiveT(T eta, T omega_predictive_start, FilterT<T> *hn)
+: eta_(eta), omega_n_start_(omega_predictive_start), omega_n_(omega_predictive_start), hn_(hn) {
 #ifdef DEBUG_ICO
     Serial.println("INIT: Predictive initialized");
 #endif
 }
 
-double Predictive::getOmega_n() {
+template <typename T>
+T PredictiveT<T>::getOmega_n() {
     return omega_n_;
 }
 
-void Predictive::setOmega_n_start(double omega_n_start) {
+template <typename T>
+void PredictiveT<T>::setOmega_n_start(T omega_n_start) {
     omega_n_start_ = omega_n_start;
     omega_n_ = omega_n_start_;
 #ifdef DEBUG_ICO
@@ -211,11 +366,13 @@ void Predictive::setOmega_n_start(double omega_n_start) {
 #endif
 }
 
-double Predictive::getEta() {
+template <typename T>
+T PredictiveT<T>::getEta() {
     return eta_;
 }
 
-void Predictive::setEta(double eta) {
+template <typename T>
+void PredictiveT<T>::setEta(T eta) {
     eta_ = constrain(eta, 0, 1);
 #ifdef DEBUG_ICO
     Serial.print("SET: Predictive eta = ");
@@ -223,12 +380,16 @@ void Predictive::setEta(double eta) {
 #endif
 }
 
-void Predictive::clearFilter()
+template <typename T>
+void PredictiveT<T>::clearFilter()
 {
-    hn_->reset(); 
+    if (hn_ != nullptr) {
+        hn_->reset(); 
+    }
 }
 
-void Predictive::updateOmegaValue(double input_prediction, double derivativeError) {
+template <typename T>
+void PredictiveT<T>::updateOmegaValue(T input_prediction, T derivativeError) {
     omega_n_ += (input_prediction * eta_ * derivativeError);
     omega_n_ = constrain(omega_n_, -3, 3);
 #ifdef DEBUG_ICO
@@ -237,16 +398,41 @@ void Predictive::updateOmegaValue(double input_prediction, double derivativeErro
 #endif
 }
 
-void Predictive::resetICO() {
+template <typename T>
+void PredictiveT<T>::resetICO() {
     omega_n_ = omega_n_start_;
 
-    hn_->reset(); // Reset the filter if it exists
+    if (hn_ != nullptr) {
+        hn_->reset(); // Reset the filter if it exists
+    }
 #ifdef DEBUG_ICO
     Serial.println("RESET: Predictive omega_n reset");
 #endif
 }
 
-double Predictive::computeOutput(double input_prediction, double derivativeError) {
+template <typename T>
+size_t PredictiveT<T>::stateSize() {
+    return 1 + ((hn_ != nullptr) ? hn_->stateSize() : 0);
+}
+
+template <typename T>
+void PredictiveT<T>::getState(T *state) {
+    state[0] = omega_n_;
+    if (hn_ != nullptr) {
+        hn_->getState(state + 1);
+    }
+}
+
+template <typename T>
+void PredictiveT<T>::setState(const T *state) {
+    omega_n_ = constrain(state[0], -3, 3);
+    if (hn_ != nullptr) {
+        hn_->setState(state + 1);
+    }
+}
+
+template <typename T>
+T PredictiveT<T>::computeOutput(T input_prediction, T derivativeError) {
 #ifdef DEBUG_ICO
     Serial.println("CO: Starting computeOutput");
 #endif
@@ -258,7 +444,7 @@ double Predictive::computeOutput(double input_prediction, double derivativeError
 #endif
     }
     updateOmegaValue(input_prediction, derivativeError);
-    double output = omega_n_ * input_prediction;
+    T output = omega_n_ * input_prediction;
 #ifdef DEBUG_ICO
     Serial.print("CO: Output = ");
     Serial.println(output);
@@ -266,4 +452,12 @@ double Predictive::computeOutput(double input_prediction, double derivativeError
     return output;
 }
 
+// Explicit instantiations, float for the control loop and double as reference
+template class ReflexT<float>;
+template class ReflexT<double>;
+template class PredictiveT<float>;
+template class PredictiveT<double>;
+template class ICOAlgoT<float>;
+template class ICOAlgoT<double>;
+
 #endif  // ICO_ALGRO_H
@@ -4,64 +4,74 @@
 #include <Arduino.h>
 #include "filter.h"
 #include <vector>
+#include "controlScalar.h"
 
-class Reflex {
+template <typename T>
+class ReflexT {
     public:
-        Reflex(double omega0, double sampleTime, Filter *h0 = nullptr);
-        double computeDerivativeError(double input0, double setpoint);
-        double getOmega0();
-        double getError();
-        double getFilteredError();
-        void setOmega0(double omega0);
-        void setSampleTime(double sampleTime);
+        ReflexT(T omega0, T sampleTime, FilterT<T> *h0 = nullptr);
+        T computeDerivativeError(T input0, T setpoint);
+        T getOmega0();
+        T getError();
+        T getFilteredError();
+        void setOmega0(T omega0);
+        void setSampleTime(T sampleTime);
         void clearFilter();
-        Filter* getFilter() { return h0_; } 
+        FilterT<T>* getFilter() { return h0_; } 
+        size_t stateSize();
+        void getState(T *state);
+        void setState(const T *state);
 
         void resetICO();
     private:
-        double input_;      // Current data from IMU
-        double setpoint_;   // Previous data from IMU
+        T input_;      // Current data from IMU
+        T setpoint_;   // Previous data from IMU
 
-        double sampleTime_; // Sample time for ICO computation
+        T sampleTime_; // Sample time for ICO computation
 
-        double omega0_ = 0.1; // Scale for error
+        T omega0_ = 0.1; // Scale for error
 
-        double error_ = 0; // Stores current error
-        double prev_error_ = 0;   // Previous error for derivative term
-        double filtered_error_ = 0; // Filtered error
-        double filtered_prev_error_ = 0; // Previous filtered error
+        T error_ = 0; // Stores current error
+        T prev_error_ = 0;   // Previous error for derivative term
+        T filtered_error_ = 0; // Filtered error
+        T filtered_prev_error_ = 0; // Previous filtered error
 
-        double S0_current_ = 0; // Stores S0 value at t = 0
-        double S0_next_ = 0; // Stores S0 value at t = 1
+        T S0_current_ = 0; // Stores S0 value at t = 0
+        T S0_next_ = 0; // Stores S0 value at t = 1
 
-        Filter *h0_ = nullptr; // Pointer to filter object
+        FilterT<T> *h0_ = nullptr; // Pointer to filter object
 };
 
-class Predictive {
+template <typename T>
+class PredictiveT {
     public:
-        Predictive(double eta, double omega_predictive_start, Filter *hn = nullptr);
-        double computeOutput(double input_prediction, double input_reflex);
-        void updateOmegaValue(double input_prediction, double derivativeError);
-        double getOmega_n();
-        void setOmega_n_start(double omega_n_start);
-        double getEta();
-        void setEta(double eta);
+        PredictiveT(T eta, T omega_predictive_start, FilterT<T> *hn = nullptr);
+        T computeOutput(T input_prediction, T input_reflex);
+        void updateOmegaValue(T input_prediction, T derivativeError);
+        T getOmega_n();
+        void setOmega_n_start(T omega_n_start);
+        T getEta();
+        void setEta(T eta);
         void clearFilter();
-        Filter* getFilter() { return hn_; } 
+        FilterT<T>* getFilter() { return hn_; } 
+        size_t stateSize();
+        void getState(T *state);
+        void setState(const T *state);
 
         void resetICO();
 
     private:
-        double eta_;        // Learning rate
+        T eta_;        // Learning rate
 
-        double omega_n_start_; // Scale for error
-        double omega_n_;
+        T omega_n_start_; // Scale for error
+        T omega_n_;
 
-        Filter *hn_ = nullptr; // Pointer to filter object
+        FilterT<T> *hn_ = nullptr; // Pointer to filter object
 };
 
 
-class ICOAlgo {
+template <typename T>
+class ICOAlgoT {
 public:
     /// @brief 
     /// @param eta 
@@ -69,34 +79,55 @@ public:
     /// @param omega_predictive_start 
     /// @param sampleTime 
     /// @param filter
-    ICOAlgo(double eta, double sampleTime, Reflex& reflex, std::vector<Predictive>& predictive);
-    double computeChange(double input0, double input1, double setpoint);
-
-    void updateOmegaValues(double omega0, double omega_n);
-
-    double getomega_n();
-    double getOmega1();
-    double getOmega0();
-    double getError();
-    double getEta();
-    double getPredictiveSum() { return predictive_sum_; } 
-    void  setEta(double eta);
+    ICOAlgoT(T eta, T sampleTime, ReflexT<T>& reflex, std::vector<PredictiveT<T>>& predictive);
+    T computeChange(T input0, T input1, T setpoint);
+
+    void updateOmegaValues(T omega0, T omega_n);
+
+    T getomega_n();
+    T getOmega1();
+    T getOmega0();
+    T getError();
+    T getEta();
+    T getPredictiveSum() { return predictive_sum_; } 
+    void  setEta(T eta);
     void clearFilters();
 
+    /// @brief Spread the predictive input over a resonator bank, one learnable weight per resonator
+    /// @param bank Resonator bank fed with input_prediction, nullptr to detach
+    void setResonatorBank(ResonatorBankT<T> *bank);
+    T getBankWeight(size_t k) { return bank_predictive_.at(k).getOmega_n(); }
+
+    /// @brief Number of values in a full learning state snapshot
+    size_t stateSize();
+    /// @brief Snapshot of the full learning state (weights, filter delay lines, reflex state)
+    /// @return Number of values written, 0 if max is too small
+    size_t getState(T *state, size_t max);
+    /// @brief Restore a snapshot taken with getState() from an ICO with the same filter setup
+    /// @return false if count does not match stateSize()
+    bool setState(const T *state, size_t count);
+
     void resetICO();
 
 private:
-    double input_;      // Current data from IMU
-    double setpoint_;   // Previous data from IMU
+    T input_;      // Current data from IMU
+    T setpoint_;   // Previous data from IMU
+
+    T eta_;        // Learning rate
+    T sampleTime_; // Sample time for ICO computation
+    T predictive_sum_ = 0; // Sum of predictive outputs
 
-    double eta_;        // Learning rate
-    double sampleTime_; // Sample time for ICO computation
-    double predictive_sum_ = 0; // Sum of predictive outputs
+    ReflexT<T>& reflex_; // Reflex object for prediction
 
-    Reflex& reflex_; // Reflex object for prediction
+    std::vector<PredictiveT<T>>& predictive_;
 
-    std::vector<Predictive>& predictive_;
+    ResonatorBankT<T> *bank_ = nullptr; // Optional resonator bank on the predictive input
+    std::vector<PredictiveT<T>> bank_predictive_; // One weight per resonator, starts at 0
 };
 
+// ICO on the project-wide control scalar type
+typedef ReflexT<control_scalar_t> Reflex;
+typedef PredictiveT<control_scalar_t> Predictive;
+typedef ICOAlgoT<control_scalar_t> ICOAlgo;
 
 #endif  // ICO_ALGO_H
\ No newline at end of file
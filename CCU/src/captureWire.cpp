@@ -0,0 +1,25 @@
+#include "captureWire.h"
+
+uint8_t CaptureWire::endTransmission() {
+    uint8_t status = 0;
+    if (!_capture.replaying()) {
+        _wire.beginTransmission(_address);
+        _wire.write(_tx, _txLength);
+        status = _wire.endTransmission();
+    }
+    return _capture.i2cWrite(_address, _tx, _txLength, status);
+}
+
+uint8_t CaptureWire::requestFrom(uint8_t address, uint8_t length) {
+    if (length > CAPTURE_WIRE_BUFFER) length = CAPTURE_WIRE_BUFFER;
+    uint8_t count = 0;
+    if (!_capture.replaying()) {
+        _wire.requestFrom(address, length);
+        while (count < length && _wire.available()) {
+            _rx[count++] = _wire.read();
+        }
+    }
+    _rxLength = _capture.i2cRead(address, _rx, _capture.replaying() ? length : count);
+    _rxPos = 0;
+    return _rxLength;
+}
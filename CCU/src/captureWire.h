@@ -0,0 +1,58 @@
+#ifndef CAPTURE_WIRE_H
+#define CAPTURE_WIRE_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "inputCapture.h"
+
+#define CAPTURE_WIRE_BUFFER 32  // As Wire's own buffer
+
+/**
+ * @brief Wire as the CCU uses it (the subset the BMX160 driver and I2CBus call), with every
+ * transaction passed through InputCapture.
+ *
+ * Writes are collected until endTransmission() like Wire does, reads are taken in full in
+ * requestFrom(). While recording, both go to Wire and are recorded; in a replay Wire is not
+ * touched, the status and the bytes received come from the recording.
+ */
+class CaptureWire {
+public:
+    CaptureWire(TwoWire &wire, InputCapture &capture) : _wire(wire), _capture(capture) {}
+
+    void begin() { _wire.begin(); }
+    void setClock(uint32_t clock) { _wire.setClock(clock); }
+
+    void beginTransmission(uint8_t address) {
+        _address = address;
+        _txLength = 0;
+    }
+    size_t write(uint8_t value) {
+        if (_txLength >= CAPTURE_WIRE_BUFFER) return 0;
+        _tx[_txLength++] = value;
+        return 1;
+    }
+    size_t write(const uint8_t *data, size_t length) {
+        size_t written = 0;
+        while (written < length && write(data[written])) written++;
+        return written;
+    }
+    uint8_t endTransmission();
+
+    uint8_t requestFrom(uint8_t address, uint8_t length);
+    /// @brief A clock value a bus decision depends on, recorded or replayed like the data
+    uint32_t clock(uint32_t value) { return _capture.clock(value); }
+    int available() { return _rxLength - _rxPos; }
+    int read() { return _rxPos < _rxLength ? _rx[_rxPos++] : -1; }
+
+private:
+    TwoWire &_wire;
+    InputCapture &_capture;
+    uint8_t _address = 0;
+    uint8_t _tx[CAPTURE_WIRE_BUFFER];
+    uint8_t _txLength = 0;
+    uint8_t _rx[CAPTURE_WIRE_BUFFER];
+    uint8_t _rxLength = 0;
+    uint8_t _rxPos = 0;
+};
+
+#endif // CAPTURE_WIRE_H
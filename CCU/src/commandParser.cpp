@@ -0,0 +1,251 @@
+#include "commandParser.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Payload sizes of the typed commands
+static const uint8_t PID_PAYLOAD = 4 * sizeof(float) + 1;
+static const uint8_t SETPOINT_PAYLOAD = sizeof(float);
+static const uint8_t ICO_PAYLOAD = 3 * sizeof(float);
+
+// Parse exactly count comma separated numbers up to the end of the line
+static bool parseNumbers(const char *p, float *values, int count) {
+    for (int i = 0; i < count; i++) {
+        char *end;
+        values[i] = strtod(p, &end);
+        if (end == p) {
+            return false;
+        }
+        while (*end == ' ') end++;
+        if (i < count - 1) {
+            if (*end != ',') {
+                return false;
+            }
+            p = end + 1;
+        } else if (*end != '\0') {
+            return false;
+        }
+    }
+    return true;
+}
+
+CommandParser::CommandParser() : _errors(0) {
+    reset();
+}
+
+void CommandParser::reset() {
+    _state = IDLE;
+    _index = 0;
+}
+
+bool CommandParser::invalid(Command &command, const char *reason) {
+    _errors++;
+    command.type = CMD_INVALID;
+    command.binary = (_state != TEXT_SKIP);
+    command.text = reason;
+    return true;
+}
+
+bool CommandParser::push(uint8_t byte, Command &command) {
+    switch (_state) {
+        case IDLE:
+            if (byte == CMD_FRAME_START) {
+                _state = LENGTH;
+                return false;
+            }
+            if (byte == '\n' || byte == '\r') {
+                return false; // Empty line or the '\r' of "\r\n"
+            }
+            _state = TEXT;
+            _index = 0;
+            [[fallthrough]]; // The byte is the first character of the line
+        case TEXT:
+            if (byte == '\n') {
+                _text[_index] = '\0';
+                _state = IDLE;
+                return finishText(command);
+            }
+            if (byte == '\r') {
+                return false;
+            }
+            if (_index >= CMD_MAX_TEXT - 1) {
+                _state = TEXT_SKIP;
+                return invalid(command, "text line too long");
+            }
+            _text[_index++] = byte;
+            return false;
+
+        case TEXT_SKIP:
+            if (byte == '\n') {
+                _state = IDLE;
+            }
+            return false;
+
+        case LENGTH:
+            if (byte > CMD_MAX_PAYLOAD) {
+                // Discard type, payload and checksum, they are no text line
+                _length = byte;
+                _index = 0;
+                _state = FRAME_SKIP;
+                return invalid(command, "frame too long");
+            }
+            _length = byte;
+            _sum = byte;
+            _state = TYPE;
+            return false;
+
+        case TYPE:
+            _type = byte;
+            _sum += byte;
+            _index = 0;
+            _state = (_length > 0) ? PAYLOAD : CHECKSUM;
+            return false;
+
+        case PAYLOAD:
+            _payload[_index++] = byte;
+            _sum += byte;
+            if (_index >= _length) {
+                _state = CHECKSUM;
+            }
+            return false;
+
+        case CHECKSUM:
+            _state = IDLE;
+            if (byte != (uint8_t)(0xFF - _sum)) {
+                return invalid(command, "frame checksum");
+            }
+            return finishFrame(command);
+
+        case FRAME_SKIP:
+            if (++_index >= _length + 2) {
+                _state = IDLE;
+            }
+            return false;
+    }
+    return false;
+}
+
+bool CommandParser::finishFrame(Command &command) {
+    command.binary = true;
+    command.text = nullptr;
+    switch (_type) {
+        case CMD_START:
+        case CMD_STOP:
+            if (_length != 0) break;
+            command.type = _type;
+            return true;
+        case CMD_PID:
+            if (_length != PID_PAYLOAD) break;
+            command.type = CMD_PID;
+            memcpy(&command.pid.kp, &_payload[0], sizeof(float));
+            memcpy(&command.pid.ki, &_payload[4], sizeof(float));
+            memcpy(&command.pid.kd, &_payload[8], sizeof(float));
+            memcpy(&command.pid.setpoint, &_payload[12], sizeof(float));
+            command.pid.mode = _payload[16];
+            return true;
+        case CMD_SETPOINT:
+            if (_length != SETPOINT_PAYLOAD) break;
+            command.type = CMD_SETPOINT;
+            memcpy(&command.setpoint.setpoint, &_payload[0], sizeof(float));
+            return true;
+        case CMD_ICO:
+            if (_length != ICO_PAYLOAD) break;
+            command.type = CMD_ICO;
+            memcpy(&command.ico.omega0, &_payload[0], sizeof(float));
+            memcpy(&command.ico.omega1, &_payload[4], sizeof(float));
+            memcpy(&command.ico.eta, &_payload[8], sizeof(float));
+            return true;
+        default:
+            break;
+    }
+    return invalid(command, "frame type or length");
+}
+
+bool CommandParser::finishText(Command &command) {
+    command.binary = false;
+    command.text = _text;
+    float values[5];
+
+    if (strcmp(_text, "START") == 0) {
+        command.type = CMD_START;
+    } else if (strcmp(_text, "STOP") == 0) {
+        command.type = CMD_STOP;
+    } else if (strncmp(_text, "PID:", 4) == 0) { // PID:kp,ki,kd,setpoint,mode
+        if (!parseNumbers(_text + 4, values, 5)) {
+            _errors++;
+            command.type = CMD_INVALID;
+            return true;
+        }
+        command.type = CMD_PID;
+        command.pid.kp = values[0];
+        command.pid.ki = values[1];
+        command.pid.kd = values[2];
+        command.pid.setpoint = values[3];
+        command.pid.mode = (uint8_t)values[4];
+    } else if (strncmp(_text, "SETPOINT:", 9) == 0) {
+        if (!parseNumbers(_text + 9, values, 1)) {
+            _errors++;
+            command.type = CMD_INVALID;
+            return true;
+        }
+        command.type = CMD_SETPOINT;
+        command.setpoint.setpoint = values[0];
+    } else if (strncmp(_text, "ICO:", 4) == 0) { // ICO:omega0,omega1,eta
+        if (!parseNumbers(_text + 4, values, 3)) {
+            _errors++;
+            command.type = CMD_INVALID;
+            return true;
+        }
+        command.type = CMD_ICO;
+        command.ico.omega0 = values[0];
+        command.ico.omega1 = values[1];
+        command.ico.eta = values[2];
+    } else {
+        command.type = CMD_TEXT;
+    }
+    return true;
+}
+
+size_t CommandParser::encode(const Command &command, uint8_t *frame, size_t max_length) {
+    uint8_t payload[CMD_MAX_PAYLOAD];
+    uint8_t length = 0;
+    switch (command.type) {
+        case CMD_START:
+        case CMD_STOP:
+            break;
+        case CMD_PID:
+            memcpy(&payload[0], &command.pid.kp, sizeof(float));
+            memcpy(&payload[4], &command.pid.ki, sizeof(float));
+            memcpy(&payload[8], &command.pid.kd, sizeof(float));
+            memcpy(&payload[12], &command.pid.setpoint, sizeof(float));
+            payload[16] = command.pid.mode;
+            length = PID_PAYLOAD;
+            break;
+        case CMD_SETPOINT:
+            memcpy(&payload[0], &command.setpoint.setpoint, sizeof(float));
+            length = SETPOINT_PAYLOAD;
+            break;
+        case CMD_ICO:
+            memcpy(&payload[0], &command.ico.omega0, sizeof(float));
+            memcpy(&payload[4], &command.ico.omega1, sizeof(float));
+            memcpy(&payload[8], &command.ico.eta, sizeof(float));
+            length = ICO_PAYLOAD;
+            break;
+        default:
+            return 0;
+    }
+    if ((size_t)length + 4 > max_length) {
+        return 0;
+    }
+
+    uint8_t sum = length + command.type;
+    frame[0] = CMD_FRAME_START;
+    frame[1] = length;
+    frame[2] = command.type;
+    for (uint8_t i = 0; i < length; i++) {
+        frame[3 + i] = payload[i];
+        sum += payload[i];
+    }
+    frame[3 + length] = 0xFF - sum;
+    return length + 4;
+}
@@ -0,0 +1,84 @@
+#ifndef COMMAND_PARSER_H
+#define COMMAND_PARSER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Binary command frame, all multi-byte values little endian (RA4M1 and PCs):
+ *
+ *   0xA5 | length | type | payload (length bytes) | checksum
+ *
+ * checksum = 0xFF - ((length + type + sum of payload) & 0xFF)
+ *
+ * Any other first byte starts a text line terminated by '\n' (the old protocol), so
+ * wificommander.py and netcat keep working. START, STOP, PID:, SETPOINT: and ICO: lines
+ * are parsed into the same typed commands as the binary frames, other lines are passed
+ * on as CMD_TEXT.
+ */
+
+#define CMD_FRAME_START 0xA5
+#define CMD_MAX_PAYLOAD 32
+// Longest text line incl. terminator, longer lines are dropped. Fits a SET: of PARAM_MAX_BATCH
+// assignments with the values as DUMP prints them, and a TQMAP: line of TORQUE_MAP_POINTS currents.
+#define CMD_MAX_TEXT 320
+
+enum CommandType : uint8_t {
+    CMD_NONE = 0x00,
+    CMD_START = 0x01,       // No payload
+    CMD_STOP = 0x02,        // No payload
+    CMD_PID = 0x03,         // float kp, ki, kd, setpoint, uint8 mode
+    CMD_SETPOINT = 0x04,    // float setpoint
+    CMD_ICO = 0x05,         // float omega0, omega1, eta
+    CMD_TEXT = 0x7E,        // Other text line, see Command::text
+    CMD_INVALID = 0x7F      // Malformed frame or text command, see Command::text
+};
+
+struct Command {
+    uint8_t type;           // CommandType
+    bool binary;            // Received as binary frame
+    union {
+        struct { float kp, ki, kd, setpoint; uint8_t mode; } pid;
+        struct { float setpoint; } setpoint;
+        struct { float omega0, omega1, eta; } ico;
+    };
+    const char *text;       // Text line (CMD_TEXT, CMD_INVALID), valid until the next push()
+};
+
+/**
+ * @brief Incremental, non-blocking command parser over a fixed receive buffer.
+ *
+ * Bytes are pushed one at a time as they arrive, push() returns true when a command is
+ * complete. Nothing is allocated and no call waits for more input.
+ */
+class CommandParser {
+public:
+    CommandParser();
+
+    /// @brief Feed one received byte, true when command holds a complete command
+    bool push(uint8_t byte, Command &command);
+    void reset();
+
+    uint32_t getErrors() { return _errors; }    // Dropped frames and lines
+
+    /// @brief Build a binary frame of a typed command, returns its length (0 if it does not fit)
+    static size_t encode(const Command &command, uint8_t *frame, size_t max_length);
+
+private:
+    enum State : uint8_t { IDLE, TEXT, TEXT_SKIP, LENGTH, TYPE, PAYLOAD, CHECKSUM, FRAME_SKIP };
+
+    bool finishFrame(Command &command);
+    bool finishText(Command &command);
+    bool invalid(Command &command, const char *reason);
+
+    State _state;
+    uint8_t _length;
+    uint8_t _type;
+    uint16_t _index;        // Up to CMD_MAX_TEXT
+    uint8_t _sum;
+    uint8_t _payload[CMD_MAX_PAYLOAD];
+    char _text[CMD_MAX_TEXT];
+    uint32_t _errors;
+};
+
+#endif // COMMAND_PARSER_H
@@ -0,0 +1,13 @@
+#ifndef CONTROL_SCALAR_H
+#define CONTROL_SCALAR_H
+
+// Scalar type of the control pipeline (filters, ICO, kinematics, Kalman).
+// The RA4M1 FPU only does single precision, so float is the default. Build with
+// -D CONTROL_SCALAR_DOUBLE for the previous double precision (software emulated) math.
+#ifdef CONTROL_SCALAR_DOUBLE
+typedef double control_scalar_t;
+#else
+typedef float control_scalar_t;
+#endif
+
+#endif // CONTROL_SCALAR_H
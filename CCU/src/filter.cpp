@@ -1,13 +1,17 @@
 #include "filter.h"
 #include <iostream>
+#include <cmath>
+#include <algorithm>
 
 // FIRFilter implementation
-FIRFilter::FIRFilter(const std::vector<double>& coeffs) 
+template <typename T>
+FIRFilterT<T>::FIRFilterT(const std::vector<T>& coeffs) 
     : coefficients(coeffs), buffer(coeffs.size(), 0.0) {}
 
-double FIRFilter::filter(double input) {
+template <typename T>
+T FIRFilterT<T>::filter(T input) {
     buffer[index] = input;
-    double output = 0.0;
+    T output = 0.0;
     size_t idx = index;
     
     for (size_t i = 0; i < coefficients.size(); i++) {
@@ -19,38 +23,77 @@ double FIRFilter::filter(double input) {
     return output;
 }
 
-void FIRFilter::reset() {
+template <typename T>
+void FIRFilterT<T>::reset() {
     std::fill(buffer.begin(), buffer.end(), 0.0);
     index = 0;
 }
 
+template <typename T>
+void FIRFilterT<T>::getState(T *state) {
+    std::copy(buffer.begin(), buffer.end(), state);
+    state[buffer.size()] = index;
+}
+
+template <typename T>
+void FIRFilterT<T>::setState(const T *state) {
+    std::copy(state, state + buffer.size(), buffer.begin());
+    index = static_cast<size_t>(state[buffer.size()]) % buffer.size();
+}
+
 // IIRFilter implementation
-IIRFilter::IIRFilter(double b_coeff, double a_coeff) 
+template <typename T>
+IIRFilterT<T>::IIRFilterT(T b_coeff, T a_coeff) 
     : a(a_coeff), b(b_coeff), prev_output(0.0) {}
 
-double IIRFilter::filter(double input) {
-    double output = b * input - a * prev_output;
+template <typename T>
+T IIRFilterT<T>::filter(T input) {
+    T output = b * input - a * prev_output;
     prev_output = output;
     return output;
 }
 
-void IIRFilter::reset() {
+template <typename T>
+void IIRFilterT<T>::reset() {
     prev_output = 0.0;
 }
 
+template <typename T>
+void IIRFilterT<T>::getState(T *state) {
+    state[0] = prev_output;
+}
+
+template <typename T>
+void IIRFilterT<T>::setState(const T *state) {
+    prev_output = state[0];
+}
+
 // ExponentialDecayFilter implementation
-ExponentialDecayFilter::ExponentialDecayFilter(double alpha_value) 
+template <typename T>
+ExponentialDecayFilterT<T>::ExponentialDecayFilterT(T alpha_value) 
     : alpha(alpha_value), state(0.0) {}
 
-double ExponentialDecayFilter::filter(double input) {
+template <typename T>
+T ExponentialDecayFilterT<T>::filter(T input) {
     state = alpha * input + (1 - alpha) * state;
     return state;
 }
 
-void ExponentialDecayFilter::reset() {
+template <typename T>
+void ExponentialDecayFilterT<T>::reset() {
     state = 0.0;
 }
 
+template <typename T>
+void ExponentialDecayFilterT<T>::getState(T *out) {
+    out[0] = state;
+}
+
+template <typename T>
+void ExponentialDecayFilterT<T>::setState(const T *in) {
+    state = in[0];
+}
+
 // Test harness implementation
 void test_filter(Filter& filter, const std::string& name, int length) {
     std::cout << "Testing " << name << ":\n";
@@ -75,7 +118,8 @@ void test_filter(Filter& filter, const std::string& name, int length) {
     std::cout << "------------------------\n\n";
 }
 
-PIDFilter::PIDFilter(double kp_value, double ki_value, double kd_value, double dt_value)
+template <typename T>
+PIDFilterT<T>::PIDFilterT(T kp_value, T ki_value, T kd_value, T dt_value)
 {
     kp = kp_value;
     ki = ki_value;
@@ -85,26 +129,107 @@ PIDFilter::PIDFilter(double kp_value, double ki_value, double kd_value, double d
     integral = 0.0;
 }
 
-void PIDFilter::setParameters(double p, double i, double d)
+template <typename T>
+void PIDFilterT<T>::setParameters(T p, T i, T d)
 {
     kp = p;
     ki = i;
     kd = d;
 }
 
-double PIDFilter::filter(double input)
+template <typename T>
+T PIDFilterT<T>::filter(T input)
 {
-    double error = input;
+    T error = input;
     integral += error * dt;
-    double derivative = (error - prev_error) / dt;
-    double output = kp * error + ki * integral + kd * derivative;
+    T derivative = (error - prev_error) / dt;
+    T output = kp * error + ki * integral + kd * derivative;
     
     prev_error = error;
     return output;
 }
 
-void PIDFilter::reset()
+template <typename T>
+void PIDFilterT<T>::reset()
 {
     prev_error = 0.0;
     integral = 0.0;
 }
+
+template <typename T>
+void PIDFilterT<T>::getState(T *state)
+{
+    state[0] = prev_error;
+    state[1] = integral;
+}
+
+template <typename T>
+void PIDFilterT<T>::setState(const T *state)
+{
+    prev_error = state[0];
+    integral = state[1];
+}
+
+// ResonatorBank implementation
+template <typename T>
+ResonatorBankT<T>::ResonatorBankT(const std::vector<double>& frequencies, double q, double sampleTime)
+    : c1(frequencies.size()), c2(frequencies.size()), gain(frequencies.size()),
+      y1(frequencies.size(), 0.0), y2(frequencies.size(), 0.0),
+      q_(std::isfinite(q) ? std::max(q, (double)RESONATOR_MIN_Q) : RESONATOR_MIN_Q)
+{
+    // Coefficients are designed in double and stored in T
+    for (size_t k = 0; k < frequencies.size(); k++) {
+        double w = 2.0 * M_PI * frequencies[k];
+        double a = -w / (2.0 * q_);                 // Damping, q_ > 0.5 keeps the resonator oscillatory
+        double b = std::sqrt(std::max(w * w - a * a, 0.0));
+        double r = std::exp(a * sampleTime);
+        double c1_k = 2.0 * r * std::cos(b * sampleTime);
+        double c2_k = -r * r;
+
+        c1[k] = c1_k;
+        c2[k] = c2_k;
+        gain[k] = 1.0 - c1_k - c2_k;                // Unit DC gain
+    }
+}
+
+template <typename T>
+T ResonatorBankT<T>::filter(T input) {
+    T sum = 0.0;
+    for (size_t k = 0; k < y1.size(); k++) {
+        T y = gain[k] * input + c1[k] * y1[k] + c2[k] * y2[k];
+        y2[k] = y1[k];
+        y1[k] = y;
+        sum += y;
+    }
+    return sum;
+}
+
+template <typename T>
+void ResonatorBankT<T>::reset() {
+    std::fill(y1.begin(), y1.end(), 0.0);
+    std::fill(y2.begin(), y2.end(), 0.0);
+}
+
+template <typename T>
+void ResonatorBankT<T>::getState(T *state) {
+    std::copy(y1.begin(), y1.end(), state);
+    std::copy(y2.begin(), y2.end(), state + y1.size());
+}
+
+template <typename T>
+void ResonatorBankT<T>::setState(const T *state) {
+    std::copy(state, state + y1.size(), y1.begin());
+    std::copy(state + y1.size(), state + 2 * y1.size(), y2.begin());
+}
+
+// Explicit instantiations, float for the control loop and double as reference
+template class FIRFilterT<float>;
+template class FIRFilterT<double>;
+template class IIRFilterT<float>;
+template class IIRFilterT<double>;
+template class ExponentialDecayFilterT<float>;
+template class ExponentialDecayFilterT<double>;
+template class PIDFilterT<float>;
+template class PIDFilterT<double>;
+template class ResonatorBankT<float>;
+template class ResonatorBankT<double>;
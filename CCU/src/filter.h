@@ -3,77 +3,148 @@
 
 #include <vector>
 #include <string>
+#include "controlScalar.h"
 
-
-class Filter {
+// The filters are templates on the scalar type, the typedefs at the end select control_scalar_t
+template <typename T>
+class FilterT {
 public:
-    virtual double filter(double input) = 0;
+    virtual T filter(T input) = 0;
     virtual std::string getType() = 0; 
     virtual void reset() = 0;
-    virtual ~Filter() {}
+    // State snapshot (delay lines) used for ICO warm start, stateSize() values
+    virtual size_t stateSize() { return 0; }
+    virtual void getState(T *state) {}
+    virtual void setState(const T *state) {}
+    virtual ~FilterT() {}
 };
 
-class FIRFilter : public Filter {
+template <typename T>
+class FIRFilterT : public FilterT<T> {
 private:
-    std::vector<double> coefficients;
-    std::vector<double> buffer;
+    std::vector<T> coefficients;
+    std::vector<T> buffer;
     size_t index = 0;
 
 public:
-    FIRFilter(const std::vector<double>& coeffs);
+    FIRFilterT(const std::vector<T>& coeffs);
     std::string getType() override { return "FIR"; } 
-    double filter(double input) override;
+    T filter(T input) override;
     void reset() override;
+    size_t stateSize() override { return buffer.size() + 1; }
+    void getState(T *state) override;
+    void setState(const T *state) override;
+    size_t size() { return coefficients.size(); }
+    void setCoefficient(size_t k, T value) { if (k < coefficients.size()) coefficients[k] = value; }
 };
 
-class IIRFilter : public Filter {
+template <typename T>
+class IIRFilterT : public FilterT<T> {
 private:
-    double a;  // feedback coefficient
-    double b;  // feedforward coefficient
-    double prev_output = 0.0;
+    T a;  // feedback coefficient
+    T b;  // feedforward coefficient
+    T prev_output = 0.0;
 
 public:
-    IIRFilter(double b_coeff, double a_coeff);
+    IIRFilterT(T b_coeff, T a_coeff);
     std::string getType() override { return "IIR"; }
-    double filter(double input) override;
+    T filter(T input) override;
     void reset() override;
+    size_t stateSize() override { return 1; }
+    void getState(T *state) override;
+    void setState(const T *state) override;
 };
 
-class ExponentialDecayFilter : public Filter {
+template <typename T>
+class ExponentialDecayFilterT : public FilterT<T> {
 private:
-    double alpha;
-    double state;
+    T alpha;
+    T state;
 
 public:
-    ExponentialDecayFilter(double alpha_value);
+    ExponentialDecayFilterT(T alpha_value);
     std::string getType() override { return "ExponentialDecay"; }
-    double filter(double input) override;
+    T filter(T input) override;
     void reset() override;
+    size_t stateSize() override { return 1; }
+    void getState(T *state) override;
+    void setState(const T *state) override;
 };
 
-class PassThroughFilter : public Filter {
+template <typename T>
+class PassThroughFilterT : public FilterT<T> {
 public:
-    double filter(double input) override { return input; }
+    T filter(T input) override { return input; }
     std::string getType() override { return "PassThrough"; }
     void reset() override {}
 };
 
-class PIDFilter : public Filter {
+template <typename T>
+class PIDFilterT : public FilterT<T> {
 private:
-    double kp, ki, kd;
-    double prev_error;
-    double integral;
-    double dt; 
+    T kp, ki, kd;
+    T prev_error;
+    T integral;
+    T dt; 
 public:
-    PIDFilter(double p, double i, double d, double time_step);
+    PIDFilterT(T p, T i, T d, T time_step);
     std::string getType() override { return "PID"; }
-    void setParameters(double p, double i, double d);
+    void setParameters(T p, T i, T d);
+
+    T filter(T input) override;
+
+    void reset() override;
+    size_t stateSize() override { return 2; }
+    void getState(T *state) override;
+    void setState(const T *state) override;
+};
 
-    double filter(double input) override;
+/**
+ * @brief Bank of K damped resonators sharing one input (ICO temporal basis functions).
+ *
+ * Each resonator k is the discretised impulse response h(t) = e^(a t) sin(b t) / b with
+ * a = -pi*f/Q and b = sqrt((2*pi*f)^2 - a^2), normalised to unit DC gain. All resonators
+ * are updated in one pass over the state arrays, filter() returns the sum of the outputs
+ * and getOutput(k) the individual channel.
+ *
+ * Below RESONATOR_MIN_Q b is imaginary and the coefficients NaN, a smaller (or non-finite)
+ * Q is clamped to it, which is the critically damped resonator.
+ */
+#define RESONATOR_MIN_Q 0.5
 
+template <typename T>
+class ResonatorBankT : public FilterT<T> {
+private:
+    std::vector<T> c1;     // y[n-1] coefficient per resonator
+    std::vector<T> c2;     // y[n-2] coefficient per resonator
+    std::vector<T> gain;   // input gain per resonator
+    std::vector<T> y1;     // y[n-1], also the current output
+    std::vector<T> y2;     // y[n-2]
+    double q_;             // Quality factor after clamping
+
+public:
+    ResonatorBankT(const std::vector<double>& frequencies, double q, double sampleTime);
+    std::string getType() override { return "ResonatorBank"; }
+    T filter(T input) override;
     void reset() override;
+    size_t stateSize() override { return 2 * y1.size(); }
+    void getState(T *state) override;
+    void setState(const T *state) override;
+
+    size_t size() const { return y1.size(); }
+    T getOutput(size_t k) const { return y1[k]; }
+    double getQ() const { return q_; }
 };
 
+// Filters on the project-wide control scalar type
+typedef FilterT<control_scalar_t> Filter;
+typedef FIRFilterT<control_scalar_t> FIRFilter;
+typedef IIRFilterT<control_scalar_t> IIRFilter;
+typedef ExponentialDecayFilterT<control_scalar_t> ExponentialDecayFilter;
+typedef PassThroughFilterT<control_scalar_t> PassThroughFilter;
+typedef PIDFilterT<control_scalar_t> PIDFilter;
+typedef ResonatorBankT<control_scalar_t> ResonatorBank;
+
 // ===== Test Harness =====
 void test_filter(Filter& filter, const std::string& name, int length = 20);
 
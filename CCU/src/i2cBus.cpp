@@ -0,0 +1,171 @@
+#include "i2cBus.h"
+
+I2CBus::I2CBus(CaptureWire &wire)
+    : _wire(wire), _count(0), _clock(0), _tickStart_us(0), _statsStart_us(0), _started_us(0),
+      _queueCount(0), _dropped(0), _tickRunning(false), _inTick(false), _held(false),
+      _waitHook(nullptr) {}
+
+uint8_t I2CBus::addDevice(const char *name, uint8_t address, uint32_t clock) {
+    if (_count >= I2C_MAX_DEVICES) return 0xFF;
+    I2CDeviceStats &device = _devices[_count];
+    device.name = name;
+    device.address = address;
+    device.clock = clock;
+    _count++;
+    resetStats();
+    return _count - 1;
+}
+
+uint8_t I2CBus::find(uint8_t address) const {
+    for (uint8_t i = 0; i < _count; i++) {
+        if (_devices[i].address == address) return i;
+    }
+    return 0xFF;
+}
+
+bool I2CBus::ownsBus() const {
+    if (_inTick) return !_held;
+    return !_tickRunning || _held;
+}
+
+void I2CBus::applyClock(uint8_t device) {
+    if (_devices[device].clock != _clock) {
+        _clock = _devices[device].clock;
+        _wire.setClock(_clock);
+    }
+}
+
+bool I2CBus::begin(uint8_t device) {
+    if (device >= _count || !ownsBus()) return false;
+    applyClock(device);
+    _started_us = micros();
+    if (_inTick) {
+        I2CDeviceStats &stats = _devices[device];
+        uint32_t phase = _started_us - _tickStart_us;
+        if (phase < stats.phase_min_us) stats.phase_min_us = phase;
+        if (phase > stats.phase_max_us) stats.phase_max_us = phase;
+    }
+    return true;
+}
+
+void I2CBus::end(uint8_t device, uint8_t bytes, bool ok) {
+    uint32_t elapsed = micros() - _started_us;
+    I2CDeviceStats &stats = _devices[device];
+    stats.transactions++;
+    stats.bytes += bytes;
+    stats.busy_us += elapsed;
+    if (elapsed > stats.max_us) stats.max_us = elapsed;
+    if (!ok) stats.errors++;
+}
+
+bool I2CBus::writeNow(uint8_t device, const uint8_t *data, uint8_t length) {
+    if (!begin(device)) return false;
+    _wire.beginTransmission(_devices[device].address);
+    _wire.write(data, length);
+    bool ok = _wire.endTransmission() == 0;
+    end(device, length, ok);
+    return ok;
+}
+
+bool I2CBus::write(uint8_t device, const uint8_t *data, uint8_t length, I2CPriority priority) {
+    if (device >= _count || length > I2C_JOB_MAX_BYTES) return false;
+    if (ownsBus()) return writeNow(device, data, length);
+
+    // Queue for the tick, interrupts off only while the job is copied in
+    bool queued = false;
+    noInterrupts();
+    if (_queueCount < I2C_QUEUE_LENGTH) {
+        Job &job = _queue[_queueCount];
+        job.device = device;
+        job.priority = priority;
+        job.length = length;
+        job.queued_us = micros();
+        memcpy(job.data, data, length);
+        _queueCount++;
+        queued = true;
+    } else {
+        _dropped++;
+    }
+    interrupts();
+    return queued;
+}
+
+uint8_t I2CBus::read(uint8_t device, uint8_t *data, uint8_t length) {
+    if (!begin(device)) return 0;
+    _wire.requestFrom(_devices[device].address, length);
+    uint8_t count = 0;
+    while (count < length && _wire.available()) {
+        data[count++] = _wire.read();
+    }
+    end(device, count, count == length);
+    return count;
+}
+
+void I2CBus::tickStart() {
+    _tickStart_us = micros();
+    _inTick = true;
+}
+
+void I2CBus::runQueue(uint32_t budget_us) {
+    if (_held) {
+        _inTick = false;
+        return;
+    }
+    // The budget decides how many jobs go out, its clock is part of a capture (only taken
+    // with jobs waiting, so an idle tick records nothing)
+    const uint32_t start = _queueCount > 0 ? _wire.clock(micros()) : 0;
+    while (_queueCount > 0 && _wire.clock(micros()) - start < budget_us) {
+        // Highest priority first, oldest first within a priority
+        uint8_t next = 0;
+        for (uint8_t i = 1; i < _queueCount; i++) {
+            if (_queue[i].priority > _queue[next].priority ||
+                (_queue[i].priority == _queue[next].priority &&
+                 (int32_t)(_queue[i].queued_us - _queue[next].queued_us) < 0)) {
+                next = i;
+            }
+        }
+        Job job = _queue[next];
+        _queue[next] = _queue[_queueCount - 1];
+        _queueCount--;
+
+        uint32_t wait = micros() - job.queued_us;
+        if (wait > _devices[job.device].max_wait_us) _devices[job.device].max_wait_us = wait;
+        writeNow(job.device, job.data, job.length);
+    }
+    _inTick = false;
+}
+
+void I2CBus::acquire() {
+    if (_inTick) return;
+    while (_tickRunning && _queueCount > 0) {
+        // The tick drains the queue, e.g. the zero setpoints of STOP before a calibration
+        if (_waitHook) _waitHook();
+    }
+    _held = true;
+}
+
+float I2CBus::utilisation() const {
+    uint32_t elapsed = micros() - _statsStart_us;
+    if (elapsed == 0) return 0;
+    uint32_t busy = 0;
+    for (uint8_t i = 0; i < _count; i++) {
+        busy += _devices[i].busy_us;
+    }
+    return (float)busy / elapsed;
+}
+
+void I2CBus::resetStats() {
+    for (uint8_t i = 0; i < _count; i++) {
+        I2CDeviceStats &stats = _devices[i];
+        stats.transactions = 0;
+        stats.bytes = 0;
+        stats.errors = 0;
+        stats.busy_us = 0;
+        stats.max_us = 0;
+        stats.max_wait_us = 0;
+        stats.phase_min_us = UINT32_MAX;
+        stats.phase_max_us = 0;
+    }
+    _dropped = 0;
+    _statsStart_us = micros();
+}
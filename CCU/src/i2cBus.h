@@ -0,0 +1,112 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <Arduino.h>
+#include "captureWire.h"
+
+#define I2C_MAX_DEVICES 6       // BMX160 and four MUs, one spare
+#define I2C_QUEUE_LENGTH 16     // Deferred writes waiting for the tick
+#define I2C_JOB_MAX_BYTES 12    // Longest deferred write (MU parameters: 8 bytes)
+
+enum I2CPriority : uint8_t {
+    I2C_PRIORITY_LOW = 0,
+    I2C_PRIORITY_NORMAL = 1,
+    I2C_PRIORITY_HIGH = 2       // Safety writes, e.g. zero setpoints on STOP
+};
+
+struct I2CDeviceStats {
+    const char *name;
+    uint8_t address;
+    uint32_t clock;
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t errors;
+    uint32_t busy_us;           // Time spent in transactions since resetStats()
+    uint32_t max_us;            // Longest transaction
+    uint32_t max_wait_us;       // Longest time a deferred write waited in the queue
+    uint32_t phase_min_us;      // Earliest/latest start of a transaction after the tick start
+    uint32_t phase_max_us;
+};
+
+/**
+ * @brief Owner of the shared Wire bus (BMX160 and the MUs).
+ *
+ * Once the control tick runs, only the tick touches the bus: transactions issued from loop()
+ * are queued and the tick runs them after its own fixed phases (IMU read first, then the MUs),
+ * highest priority first, within a time budget. The IMU read therefore always starts at the
+ * same offset into the tick. loop() can take the bus for a while (acquire(), e.g. IMU
+ * calibration while stopped), the queue is drained first and the tick defers its own writes.
+ *
+ * Every transaction switches to the clock of its device if needed and is timed, so busy time,
+ * utilisation, worst case duration, queue wait and the phase in the tick are known per device.
+ */
+class I2CBus {
+public:
+    explicit I2CBus(CaptureWire &wire);
+
+    /// @brief Register a device, returns its id (0xFF if the table is full)
+    uint8_t addDevice(const char *name, uint8_t address, uint32_t clock);
+    /// @brief Id of the device with this address, 0xFF if unknown
+    uint8_t find(uint8_t address) const;
+
+    /// @brief Write now if this context owns the bus, otherwise queue for the tick
+    bool write(uint8_t device, const uint8_t *data, uint8_t length, I2CPriority priority = I2C_PRIORITY_NORMAL);
+    /// @brief Read now, only from the owning context, returns the bytes read
+    uint8_t read(uint8_t device, uint8_t *data, uint8_t length);
+
+    /// @brief Bracket a transaction done directly on Wire by a driver (BMX160)
+    bool begin(uint8_t device);
+    void end(uint8_t device, uint8_t bytes, bool ok = true);
+
+    /// @brief Tick boundaries, call at the start of the ISR and last in it. Between the two
+    /// the caller is the tick and owns the bus unless loop() holds it.
+    void tickStart();
+    void runQueue(uint32_t budget_us);
+    /// @brief Until the tick runs, loop() owns the bus and writes directly
+    void setTickRunning(bool running) { _tickRunning = running; }
+
+    /// @brief Take the bus from loop(), waits until the queued writes went out
+    void acquire();
+    /// @brief Called while acquire() waits for the tick (a replay runs the recorded tick there)
+    void setWaitHook(void (*hook)()) { _waitHook = hook; }
+    void release() { _held = false; }
+
+    const I2CDeviceStats &getStats(uint8_t device) const { return _devices[device]; }
+    uint8_t deviceCount() const { return _count; }
+    /// @brief Share of the time since resetStats() the bus was busy (0..1)
+    float utilisation() const;
+    uint8_t queued() const { return _queueCount; }
+    uint32_t getDropped() const { return _dropped; }
+    void resetStats();
+
+private:
+    struct Job {
+        uint8_t device;
+        uint8_t priority;
+        uint8_t length;
+        uint32_t queued_us;
+        uint8_t data[I2C_JOB_MAX_BYTES];
+    };
+
+    bool ownsBus() const;
+    bool writeNow(uint8_t device, const uint8_t *data, uint8_t length);
+    void applyClock(uint8_t device);
+
+    CaptureWire &_wire;
+    I2CDeviceStats _devices[I2C_MAX_DEVICES];
+    uint8_t _count;
+    uint32_t _clock;            // Clock Wire currently runs at
+    uint32_t _tickStart_us;
+    uint32_t _statsStart_us;
+    uint32_t _started_us;       // Start of the running transaction
+
+    Job _queue[I2C_QUEUE_LENGTH];
+    volatile uint8_t _queueCount;
+    uint32_t _dropped;          // Writes lost because the queue was full
+    volatile bool _tickRunning;
+    volatile bool _inTick;      // Between tickStart() and the end of runQueue()
+    volatile bool _held;
+    void (*_waitHook)();
+};
+
+#endif // I2C_BUS_H
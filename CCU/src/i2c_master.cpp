@@ -8,7 +8,7 @@
 // +--------------------+---------------------+----------+
 
 
-I2CMaster::I2CMaster() {}
+I2CMaster::I2CMaster(I2CBus &bus) : _bus(bus) {}
 
 void I2CMaster::begin() {
     Wire.begin();
@@ -22,55 +22,68 @@ bool I2CMaster::sendParam(uint8_t slave_adress, uint8_t mode, float kp, float ki
     uint16_t scaled_ki = ki*800;    //Max 81.918 (Can contain three decimals)
     uint16_t scaled_kd = kd*10000;  //Max 6.5535 (Can contain four decimals)
 
-
-    Wire.beginTransmission(slave_adress);
-    Wire.write(CMD_PARAM);
-    Wire.write(mode);
-    Wire.write(byte((scaled_kp >> 8) & 0xFF));
-    Wire.write(byte(scaled_kp & 0xFF));
-    Wire.write(byte((scaled_ki >> 8) & 0xFF));
-    Wire.write(byte(scaled_ki & 0xFF));
-    Wire.write(byte((scaled_kd >> 8) & 0xFF));
-    Wire.write(byte(scaled_kd & 0xFF)); 
-    Wire.endTransmission();
+    const uint8_t frame[8] = {
+        CMD_PARAM,
+        mode,
+        byte((scaled_kp >> 8) & 0xFF),
+        byte(scaled_kp & 0xFF),
+        byte((scaled_ki >> 8) & 0xFF),
+        byte(scaled_ki & 0xFF),
+        byte((scaled_kd >> 8) & 0xFF),
+        byte(scaled_kd & 0xFF)
+    };
+    bool success = _bus.write(_bus.find(slave_adress), frame, sizeof(frame));
 
     if(SEND_DATA_SERIAL){
         Serial.println("Parameters sent!");
     }
-    return true;
+    return success;
 }
 
-bool I2CMaster::sendSetpoint(uint8_t slave_adress, float setpoint) {
-    Wire.beginTransmission(slave_adress);
-    Wire.write(CMD_SET);
+bool I2CMaster::sendSetpoint(uint8_t slave_adress, float setpoint, I2CPriority priority) {
+    uint8_t frame[2] = {CMD_SET, 0};
     switch (_mode)
     {
     case 0:
-        Wire.write(byte(constrain(setpoint * SCALE_FACTOR_SPEED, 0, 255)));
+        frame[1] = byte(constrain(setpoint * SCALE_FACTOR_SPEED, 0, 255));
         break;
     case 1:
-        Wire.write(byte(constrain(setpoint * SCALE_FACTOR_TORQUE, 0, 255)));
+        frame[1] = byte(constrain(setpoint * SCALE_FACTOR_TORQUE, 0, 255));
         break;
     default:
-        Wire.write(byte(constrain(setpoint * SCALE_FACTOR_RPM, 0, 255)));
+        frame[1] = byte(constrain(setpoint * SCALE_FACTOR_RPM, 0, 255));
         break;
     }
-    Wire.endTransmission();
+    bool success = _bus.write(_bus.find(slave_adress), frame, sizeof(frame), priority);
     
     if(SEND_DATA_SERIAL){
         Serial.println("Setpoint sent!");
     }
-    return true;
+    return success;
 }
 
-bool I2CMaster::requestData(uint8_t slave_adress, MUData& data) {
-    Wire.requestFrom(slave_adress, 3); // Request 3 bytes
+bool I2CMaster::sendSetpointRaw(uint8_t slave_adress, uint8_t value) {
+    const uint8_t frame[2] = {CMD_SET, value};
+    bool success = _bus.write(_bus.find(slave_adress), frame, sizeof(frame));
 
-    if (Wire.available() >= 3) {
+    if(SEND_DATA_SERIAL){
+        Serial.println("Setpoint sent!");
+    }
+    return success;
+}
+
+bool I2CMaster::probe(uint8_t slave_adress) {
+    Wire.beginTransmission(slave_adress);
+    return Wire.endTransmission() == 0;
+}
+
+bool I2CMaster::requestData(uint8_t slave_adress, MUData& data) {
+    uint8_t raw[3];
+    if (_bus.read(_bus.find(slave_adress), raw, 3) == 3) { // Request 3 bytes
 
-        uint8_t raw_setpoint = Wire.read();
-        uint8_t raw_value = Wire.read();
-        uint8_t raw_current = Wire.read();
+        uint8_t raw_setpoint = raw[0];
+        uint8_t raw_value = raw[1];
+        uint8_t raw_current = raw[2];
 
         switch (_mode)
         {
@@ -99,7 +112,9 @@ bool I2CMaster::requestData(uint8_t slave_adress, MUData& data) {
             Serial.print(", Current = ");
             Serial.println(data.current_recv);
         }
+        return true;
     } else {
         Serial.println("Error: Did not receive expected data from slave!");
+        return false;
     }
 }
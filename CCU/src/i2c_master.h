@@ -10,6 +10,7 @@
 
 #include <Wire.h>
 #include <Arduino.h>
+#include "i2cBus.h"
 
 // Command bytes
 #define CMD_PARAM 0x10
@@ -24,13 +25,17 @@ struct MUData
 
 class I2CMaster {
 public:
-    I2CMaster();
+    I2CMaster(I2CBus &bus);
     void begin(); 
+    // Writes go through the bus arbiter, from loop() they are queued for the next tick
     bool sendParam(uint8_t slave_adress, uint8_t mode, float kp, float ki, float kd);
-    bool sendSetpoint(uint8_t slave_adress, float setpoint);
+    bool sendSetpoint(uint8_t slave_adress, float setpoint, I2CPriority priority = I2C_PRIORITY_NORMAL);
+    bool sendSetpointRaw(uint8_t slave_adress, uint8_t value); // Already scaled for the MU mode
     bool requestData(uint8_t slave_adress, MUData& data);
+    bool probe(uint8_t slave_adress); // True if the MU acknowledges its address
 
 private:
+    I2CBus &_bus;
     uint8_t _slaveAddress;
     uint8_t _mode = 0;
 };
@@ -0,0 +1,123 @@
+#include "icoStore.h"
+
+ICOStore::ICOStore(void) {
+}
+
+int32_t ICOStore::centi(float value) {
+    return (int32_t)lroundf(constrain(value, -1e7f, 1e7f) * 100);
+}
+
+void ICOStore::makeFilename(uint8_t mode, int32_t setpoint_centi, int32_t radius_centi, char *filename) {
+    // 8.3 file name: I<mode><FNV-1a of the key, 24 bits>.ICO
+    const int32_t key[2] = {setpoint_centi, radius_centi};
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(key);
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < sizeof(key); i++) {
+        hash = (hash ^ data[i]) * 16777619UL;
+    }
+    snprintf(filename, 13, "I%u%06lX.ICO", (unsigned int)(mode % 10), (unsigned long)((hash ^ (hash >> 24)) & 0xFFFFFF));
+}
+
+uint16_t ICOStore::checksum(const float *values, size_t count) {
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(values);
+    uint16_t sum1 = 0;
+    uint16_t sum2 = 0;
+    for (size_t i = 0; i < count * sizeof(float); i++) {
+        sum1 = (sum1 + data[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    return (sum2 << 8) | sum1;
+}
+
+bool ICOStore::save(uint8_t mode, float setpoint, float radius, ICOAlgo &ico_yaw, ICOAlgo &ico_move) {
+    size_t count_yaw = ico_yaw.getState(_state_yaw, ICO_STORE_MAX_VALUES);
+    size_t count_move = ico_move.getState(_state_move, ICO_STORE_MAX_VALUES);
+    if (count_yaw == 0 || count_move == 0) {
+        Serial.println("Error: ICO state too large for snapshot");
+        return false;
+    }
+
+    for (size_t i = 0; i < count_yaw; i++) {
+        _values[i] = _state_yaw[i];
+    }
+    for (size_t i = 0; i < count_move; i++) {
+        _values[count_yaw + i] = _state_move[i];
+    }
+
+    ICOStoreHeader header;
+    header.magic = ICO_STORE_MAGIC;
+    header.mode = mode;
+    header.setpoint_centi = centi(setpoint);
+    header.radius_centi = centi(radius);
+    header.count_yaw = count_yaw;
+    header.count_move = count_move;
+    header.checksum = checksum(_values, count_yaw + count_move);
+
+    char filename[13];
+    makeFilename(mode, header.setpoint_centi, header.radius_centi, filename);
+    SD.remove(filename); // FILE_WRITE appends
+    File file = SD.open(filename, FILE_WRITE);
+    if (!file) {
+        Serial.println("Error opening file SD (ICO save)");
+        return false;
+    }
+    size_t bytes = file.write(reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+    bytes += file.write(reinterpret_cast<const uint8_t *>(_values), (count_yaw + count_move) * sizeof(float));
+    file.close();
+
+    if (bytes != sizeof(header) + (count_yaw + count_move) * sizeof(float)) {
+        Serial.println("Error writing ICO snapshot");
+        return false;
+    }
+    Serial.print("ICO state saved to ");
+    Serial.println(filename);
+    return true;
+}
+
+bool ICOStore::load(uint8_t mode, float setpoint, float radius, ICOAlgo &ico_yaw, ICOAlgo &ico_move) {
+    const int32_t setpoint_centi = centi(setpoint);
+    const int32_t radius_centi = centi(radius);
+    char filename[13];
+    makeFilename(mode, setpoint_centi, radius_centi, filename);
+    File file = SD.open(filename, FILE_READ);
+    if (!file) {
+        Serial.print("No ICO snapshot ");
+        Serial.println(filename);
+        return false;
+    }
+
+    ICOStoreHeader header;
+    bool ok = file.read(reinterpret_cast<uint8_t *>(&header), sizeof(header)) == sizeof(header)
+           && header.magic == ICO_STORE_MAGIC
+           && header.mode == mode
+           && header.setpoint_centi == setpoint_centi
+           && header.radius_centi == radius_centi
+           && header.count_yaw == ico_yaw.stateSize()
+           && header.count_move == ico_move.stateSize()
+           && header.count_yaw + header.count_move <= 2 * ICO_STORE_MAX_VALUES
+           && file.size() == sizeof(header) + (header.count_yaw + header.count_move) * sizeof(float);
+    if (ok) {
+        size_t bytes = (header.count_yaw + header.count_move) * sizeof(float);
+        ok = file.read(reinterpret_cast<uint8_t *>(_values), bytes) == (int)bytes
+          && checksum(_values, header.count_yaw + header.count_move) == header.checksum;
+    }
+    file.close();
+    if (!ok) {
+        Serial.print("Error: ICO snapshot invalid, of another key or from another filter setup: ");
+        Serial.println(filename);
+        return false;
+    }
+
+    for (size_t i = 0; i < header.count_yaw; i++) {
+        _state_yaw[i] = _values[i];
+    }
+    for (size_t i = 0; i < header.count_move; i++) {
+        _state_move[i] = _values[header.count_yaw + i];
+    }
+    ico_yaw.setState(_state_yaw, header.count_yaw);
+    ico_move.setState(_state_move, header.count_move);
+
+    Serial.print("ICO state loaded from ");
+    Serial.println(filename);
+    return true;
+}
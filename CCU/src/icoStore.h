@@ -0,0 +1,47 @@
+#ifndef ICOSTORE_H
+#define ICOSTORE_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "ICO_algo.h"
+
+#define ICO_STORE_MAGIC 0x324F4349UL   // "ICO2", the key holds the radius
+#define ICO_STORE_MAX_VALUES 128       // Per ICO, values are stored as float
+
+// Header of an ICO snapshot file, followed by count_yaw + count_move floats
+struct __attribute__((packed)) ICOStoreHeader {
+    uint32_t magic;
+    uint8_t mode;               // Control mode the state was learned in
+    int32_t setpoint_centi;     // setpoint * 100
+    int32_t radius_centi;       // setpoint_radius * 100, 0 is straight
+    uint16_t count_yaw;         // Values in the ico_yaw snapshot
+    uint16_t count_move;        // Values in the ico_move snapshot
+    uint16_t checksum;          // Fletcher-16 over the values
+};
+
+/**
+ * @brief Snapshot and restore of the learned ICO state on the SD card.
+ *
+ * One file per mode, setpoint and radius, named I<mode><hash of setpoint and radius>.ICO
+ * to fit 8.3 names. The header holds the full key, load() rejects a file whose key, size
+ * or checksum does not match, so a hash collision or a foreign file is never restored.
+ * A snapshot only restores into ICOs with the same filter setup, otherwise load() fails
+ * and the ICOs are left untouched.
+ */
+class ICOStore {
+public:
+    ICOStore(void);
+    bool save(uint8_t mode, float setpoint, float radius, ICOAlgo &ico_yaw, ICOAlgo &ico_move);
+    bool load(uint8_t mode, float setpoint, float radius, ICOAlgo &ico_yaw, ICOAlgo &ico_move);
+
+private:
+    int32_t centi(float value);
+    void makeFilename(uint8_t mode, int32_t setpoint_centi, int32_t radius_centi, char *filename);
+    uint16_t checksum(const float *values, size_t count);
+
+    control_scalar_t _state_yaw[ICO_STORE_MAX_VALUES];
+    control_scalar_t _state_move[ICO_STORE_MAX_VALUES];
+    float _values[2 * ICO_STORE_MAX_VALUES];
+};
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef IMU_H
+#define IMU_H
+
+#include <BMX160.h>
+#include "captureWire.h"
+
+// The CCU's BMX160: +-2 g, +-500 dps, 100 Hz (the data ready tick), on the captured bus
+typedef BMX160Config<eAccelRange_2G, eGyroRange_500DPS, BMX160_ACCEL_ODR_100HZ, BMX160_GYRO_ODR_100HZ> ImuConfig;
+typedef BMX160<CaptureWire, ImuConfig> Imu;
+
+#endif // IMU_H
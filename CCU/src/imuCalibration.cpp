@@ -0,0 +1,68 @@
+#include "imuCalibration.h"
+
+ImuCalibration::ImuCalibration(Imu &imu, uint16_t window, float gyro_var_max,
+                               float accel_var_max, uint16_t timeout)
+    : _imu(imu), _window(window), _gyroVarMax(gyro_var_max), _accelVarMax(accel_var_max),
+      _timeout(timeout), _state(IMU_CAL_IDLE), _ticks(0), _n(0), _gyroVar(0), _accelVar(0),
+      _count(0) {
+    resetWindow();
+}
+
+void ImuCalibration::request() {
+    if (_state == IMU_CAL_FOC) return; // The running one finishes first
+    noInterrupts(); // The tick sees the new state only with a fresh window
+    resetWindow();
+    _ticks = 0;
+    _state = IMU_CAL_WAIT_STILL;
+    interrupts();
+}
+
+void ImuCalibration::abort() {
+    if (_state == IMU_CAL_WAIT_STILL) _state = IMU_CAL_IDLE;
+}
+
+void ImuCalibration::resetWindow() {
+    _n = 0;
+    for (int i = 0; i < 6; i++) {
+        _mean[i] = 0;
+        _m2[i] = 0;
+    }
+}
+
+bool ImuCalibration::update(const sBmx160SensorData_t &gyro, const sBmx160SensorData_t &accel) {
+    _ticks++;
+
+    if (_state == IMU_CAL_FOC) {
+        if (_imu.focReady()) {
+            _imu.enableOffsets(true, true);
+            _count++;
+            _state = IMU_CAL_DONE;
+            return true;
+        }
+        if (_ticks > _timeout) _state = IMU_CAL_FAILED;
+        return false;
+    }
+    if (_state != IMU_CAL_WAIT_STILL) return false;
+
+    // Running mean and variance, constant work per tick
+    const float x[6] = {gyro.x, gyro.y, gyro.z, accel.x, accel.y, accel.z};
+    _n++;
+    for (int i = 0; i < 6; i++) {
+        float delta = x[i] - _mean[i];
+        _mean[i] += delta / _n;
+        _m2[i] += delta * (x[i] - _mean[i]);
+    }
+    if (_n < _window) return false;
+
+    _gyroVar = (_m2[0] + _m2[1] + _m2[2]) / (_n - 1);
+    _accelVar = (_m2[3] + _m2[4] + _m2[5]) / (_n - 1);
+    resetWindow();
+    if (_gyroVar <= _gyroVarMax && _accelVar <= _accelVarMax) {
+        _imu.startFOC(true, BMX160_FOC_ACCEL_0G, BMX160_FOC_ACCEL_0G, BMX160_FOC_ACCEL_POSITIVE_G);
+        _ticks = 0;
+        _state = IMU_CAL_FOC;
+    } else if (_ticks > _timeout) {
+        _state = IMU_CAL_FAILED;
+    }
+    return false;
+}
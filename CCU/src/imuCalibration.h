@@ -0,0 +1,70 @@
+#ifndef IMU_CALIBRATION_H
+#define IMU_CALIBRATION_H
+
+#include <Arduino.h>
+#include "imu.h"
+
+enum ImuCalState : uint8_t {
+    IMU_CAL_IDLE,           // Nothing requested
+    IMU_CAL_WAIT_STILL,     // Collecting windows until one is still enough
+    IMU_CAL_FOC,            // Fast offset compensation running on the chip
+    IMU_CAL_DONE,           // Offsets in the sensor registers and enabled
+    IMU_CAL_FAILED          // No still window in time, or the FOC did not finish
+};
+
+/**
+ * @brief IMU offset calibration in the idle ticks, without blocking loop().
+ *
+ * While requested, the tick passes each sample to update(). The samples are collected in
+ * windows; the gyro and accel variance of a window tells whether the car stands still. On the
+ * first still window the BMX160's fast offset compensation is started, polled on the following
+ * ticks and its result enabled in the sensor, so the data arrives offset free and the tick
+ * subtracts nothing. The accel targets assume the sensor lies flat, z up (+1 g).
+ * A window that is not still starts the next one, a moving car just delays the calibration.
+ */
+class ImuCalibration {
+public:
+    /// @param window Samples per stillness window
+    /// @param gyro_var_max Largest gyro variance (dps², sum of the axes) counted as still
+    /// @param accel_var_max Largest accel variance ((m/s²)², sum of the axes) counted as still
+    /// @param timeout Ticks to wait for a still window or the FOC before giving up
+    ImuCalibration(Imu &imu, uint16_t window, float gyro_var_max, float accel_var_max,
+                   uint16_t timeout);
+
+    /// @brief Start (again) on the next tick
+    void request();
+    /// @brief Stop waiting for stillness, a running FOC is finished by the sensor regardless
+    void abort();
+
+    /// @brief Tick side, with the sample just read. Returns true when new offsets were enabled.
+    bool update(const sBmx160SensorData_t &gyro, const sBmx160SensorData_t &accel);
+
+    ImuCalState state() const { return _state; }
+    /// @brief Whether the tick has to read samples for update()
+    bool pending() const { return _state == IMU_CAL_WAIT_STILL || _state == IMU_CAL_FOC; }
+    /// @brief The FOC is running, the sensor data is not usable for control
+    bool busy() const { return _state == IMU_CAL_FOC; }
+    float getGyroVariance() const { return _gyroVar; }    // Of the last complete window
+    float getAccelVariance() const { return _accelVar; }
+    uint16_t getCount() const { return _count; }          // Successful calibrations since boot
+
+private:
+    void resetWindow();
+
+    Imu &_imu;
+    const uint16_t _window;
+    const float _gyroVarMax;
+    const float _accelVarMax;
+    const uint16_t _timeout;
+
+    volatile ImuCalState _state;
+    uint16_t _ticks;            // In the current state
+    uint16_t _n;                // Samples in the window
+    float _mean[6];             // Gyro x y z, accel x y z (Welford)
+    float _m2[6];
+    float _gyroVar;
+    float _accelVar;
+    uint16_t _count;
+};
+
+#endif // IMU_CALIBRATION_H
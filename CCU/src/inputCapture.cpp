@@ -0,0 +1,315 @@
+#include "inputCapture.h"
+#include "controlScalar.h"
+
+static const char *const capture_record_names[] = {
+    "END", "TICK", "CLOCK", "I2C_WRITE", "I2C_READ", "TCP", "DISCONNECT", "CHECK", "LOST"
+};
+
+static const char *recordName(uint8_t type) {
+    return type <= CAPTURE_LOST ? capture_record_names[type] : "UNKNOWN";
+}
+
+InputCapture::InputCapture()
+    : _mode(MODE_IDLE), _opened(false), _inTick(false), _head(0), _count(0), _lost(0),
+      _lost_total(0), _flushTicks(0), _stream(nullptr), _length(0), _pos(0),
+      _tickHandler(nullptr), _failed(false), _ended(false), _mismatches(0), _compared(0),
+      _ticks(0), _records(0) {
+    _error[0] = '\0';
+}
+
+bool InputCapture::open(const char *filename) {
+    if (_stream) return false; // Replaying, the card may hold the capture being replayed
+    SD.remove(filename); // FILE_WRITE appends
+    _file = SD.open(filename, FILE_WRITE);
+    if (!_file) {
+        Serial.println("Error opening file SD (capture)");
+        return false;
+    }
+    CaptureHeader header;
+    header.magic = CAPTURE_MAGIC;
+    header.version = CAPTURE_VERSION;
+    header.scalar_size = sizeof(control_scalar_t);
+    _file.write(reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+    _opened = true;
+    return true;
+}
+
+bool InputCapture::attach(const uint8_t *data, size_t length) {
+    CaptureHeader header;
+    if (length < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != CAPTURE_MAGIC || header.version != CAPTURE_VERSION) return false;
+    if (header.scalar_size != sizeof(control_scalar_t)) {
+        fail("recorded with another control_scalar_t (CONTROL_SCALAR_DOUBLE)");
+        return false;
+    }
+    // A replay runs the firmware as built for the capture, whose setup() opened a recording
+    if (_opened) {
+        _file.close();
+        _opened = false;
+    }
+    _stream = data;
+    _length = length;
+    _pos = sizeof(header);
+    return true;
+}
+
+void InputCapture::start() {
+    if (_opened) {
+        _mode = MODE_RECORD;
+    } else if (_stream) {
+        _mode = MODE_REPLAY;
+    }
+}
+
+bool InputCapture::append(CaptureRecord type, const uint8_t *a, uint8_t a_length,
+                          const uint8_t *b, uint8_t b_length) {
+    const uint16_t size = 2 + a_length + b_length;
+    const bool loop_context = !_inTick;
+    if (loop_context) noInterrupts(); // The tick appends and writes the buffer out
+
+    // A gap is marked before the next record that fits, the replay stops there
+    bool ok = true;
+    if (_lost > 0) {
+        if (_count + 4 + size <= CAPTURE_BUFFER) {
+            const uint8_t lost[4] = {CAPTURE_LOST, 2, (uint8_t)(_lost & 0xFF), (uint8_t)(_lost >> 8)};
+            for (uint8_t i = 0; i < 4; i++) {
+                _buffer[(_head + _count + i) % CAPTURE_BUFFER] = lost[i];
+            }
+            _count += 4;
+            _lost = 0;
+        } else {
+            ok = false;
+        }
+    } else if (_count + size > CAPTURE_BUFFER) {
+        ok = false;
+    }
+
+    if (ok) {
+        uint16_t tail = (_head + _count) % CAPTURE_BUFFER;
+        _buffer[tail] = type;
+        _buffer[(tail + 1) % CAPTURE_BUFFER] = a_length + b_length;
+        tail = (tail + 2) % CAPTURE_BUFFER;
+        for (uint8_t i = 0; i < a_length; i++) {
+            _buffer[tail] = a[i];
+            tail = (tail + 1) % CAPTURE_BUFFER;
+        }
+        for (uint8_t i = 0; i < b_length; i++) {
+            _buffer[tail] = b[i];
+            tail = (tail + 1) % CAPTURE_BUFFER;
+        }
+        _count += size;
+    } else {
+        if (_lost < UINT16_MAX - size) _lost += size;
+        _lost_total += size;
+    }
+
+    if (loop_context) interrupts();
+    return ok;
+}
+
+void InputCapture::flush() {
+    // At most two writes when the buffer wraps
+    while (_count > 0) {
+        uint16_t length = CAPTURE_BUFFER - _head;
+        if (length > _count) length = _count;
+        _file.write(&_buffer[_head], length);
+        _head = (_head + length) % CAPTURE_BUFFER;
+        _count -= length;
+    }
+    if (++_flushTicks >= CAPTURE_FLUSH_TICKS) {
+        _flushTicks = 0;
+        _file.flush();
+    }
+}
+
+void InputCapture::tick(uint32_t &now_us, uint32_t &now_ms) {
+    if (_mode == MODE_RECORD) {
+        _inTick = true;
+        uint8_t payload[8];
+        memcpy(payload, &now_us, 4);
+        memcpy(payload + 4, &now_ms, 4);
+        append(CAPTURE_TICK, payload, sizeof(payload));
+    } else if (_mode == MODE_REPLAY) {
+        uint8_t length;
+        const uint8_t *payload = take(CAPTURE_TICK, length);
+        _inTick = true;
+        if (payload) {
+            memcpy(&now_us, payload, 4);
+            memcpy(&now_ms, payload + 4, 4);
+            _ticks++;
+        }
+    }
+}
+
+void InputCapture::endTick() {
+    if (_mode == MODE_RECORD) flush();
+    _inTick = false;
+}
+
+uint32_t InputCapture::clock(uint32_t value) {
+    if (_mode == MODE_RECORD) {
+        append(CAPTURE_CLOCK, reinterpret_cast<const uint8_t *>(&value), 4);
+    } else if (_mode == MODE_REPLAY) {
+        uint8_t length;
+        const uint8_t *payload = take(CAPTURE_CLOCK, length);
+        if (payload) memcpy(&value, payload, 4);
+    }
+    return value;
+}
+
+uint8_t InputCapture::i2cWrite(uint8_t address, const uint8_t *data, uint8_t length, uint8_t status) {
+    if (_mode == MODE_RECORD) {
+        const uint8_t head[2] = {address, status};
+        append(CAPTURE_I2C_WRITE, head, 2, data, length);
+    } else if (_mode == MODE_REPLAY) {
+        uint8_t recorded;
+        const uint8_t *payload = take(CAPTURE_I2C_WRITE, recorded);
+        if (!payload) return 2; // NACK, nothing on the bus any more
+        _compared++;
+        if (payload[0] != address || recorded - 2 != length || memcmp(payload + 2, data, length) != 0) {
+            char what[48];
+            snprintf(what, sizeof(what), "I2C write to 0x%02X differs", address);
+            mismatch(what);
+        }
+        status = payload[1];
+    }
+    return status;
+}
+
+uint8_t InputCapture::i2cRead(uint8_t address, uint8_t *data, uint8_t count) {
+    if (_mode == MODE_RECORD) {
+        append(CAPTURE_I2C_READ, &address, 1, data, count);
+    } else if (_mode == MODE_REPLAY) {
+        uint8_t length;
+        const uint8_t *payload = take(CAPTURE_I2C_READ, length);
+        if (!payload) return 0;
+        if (payload[0] != address) {
+            char what[48];
+            snprintf(what, sizeof(what), "I2C read from 0x%02X, recorded 0x%02X", address, payload[0]);
+            mismatch(what);
+        }
+        count = (length - 1 < count) ? length - 1 : count;
+        memcpy(data, payload + 1, count);
+    }
+    return count;
+}
+
+void InputCapture::tcp(const uint8_t *data, uint8_t length) {
+    if (_mode == MODE_RECORD) {
+        uint8_t head[8];
+        const uint32_t now_us = micros();
+        const uint32_t now_ms = millis();
+        memcpy(head, &now_us, 4);
+        memcpy(head + 4, &now_ms, 4);
+        append(CAPTURE_TCP, head, sizeof(head), data, length);
+    } else if (_mode == MODE_REPLAY) {
+        uint8_t recorded;
+        const uint8_t *payload = take(CAPTURE_TCP, recorded);
+        if (payload && (recorded - 8 != length || memcmp(payload + 8, data, length) != 0)) {
+            mismatch("client bytes differ from the recording");
+        }
+    }
+}
+
+void InputCapture::disconnect() {
+    if (_mode == MODE_RECORD) {
+        append(CAPTURE_DISCONNECT, nullptr, 0);
+    } else if (_mode == MODE_REPLAY) {
+        uint8_t length;
+        take(CAPTURE_DISCONNECT, length);
+    }
+}
+
+void InputCapture::check(const void *data, size_t length) {
+    const uint32_t value = hash(data, length);
+    if (_mode == MODE_RECORD) {
+        append(CAPTURE_CHECK, reinterpret_cast<const uint8_t *>(&value), 4);
+    } else if (_mode == MODE_REPLAY) {
+        uint8_t recorded;
+        const uint8_t *payload = take(CAPTURE_CHECK, recorded);
+        if (!payload) return;
+        _compared++;
+        if (memcmp(payload, &value, 4) != 0) {
+            mismatch("output hash differs (logged row or ICO state)");
+        }
+    }
+}
+
+CaptureRecord InputCapture::peek(const uint8_t **payload, uint8_t *length) const {
+    if (_failed || _ended || _pos + 2 > _length) return CAPTURE_END;
+    const uint8_t size = _stream[_pos + 1];
+    if (_pos + 2 + size > _length) return CAPTURE_END; // Cut off by the power-off
+    if (payload) *payload = _stream + _pos + 2;
+    if (length) *length = size;
+    return (CaptureRecord)_stream[_pos];
+}
+
+void InputCapture::pump() {
+    if (_mode != MODE_REPLAY || _inTick || !_tickHandler || _failed) return;
+    const uint8_t *payload;
+    uint8_t length;
+    if (peek(&payload, &length) == CAPTURE_TICK) {
+        uint32_t now_us, now_ms;
+        memcpy(&now_us, payload, 4);
+        memcpy(&now_ms, payload + 4, 4);
+        _tickHandler(now_us, now_ms);
+    } else if (peek() == CAPTURE_END) {
+        _ended = true;
+    } else {
+        fail("loop() waits for a tick that was not recorded");
+    }
+}
+
+const uint8_t *InputCapture::take(CaptureRecord type, uint8_t &length) {
+    // A tick that interrupted loop() is in the stream before loop()'s next record
+    if (type != CAPTURE_TICK) {
+        while (!_inTick && _tickHandler && peek() == CAPTURE_TICK) {
+            pump();
+        }
+    }
+    const uint8_t *payload = nullptr;
+    const CaptureRecord found = peek(&payload, &length);
+    if (found == CAPTURE_END) {
+        _ended = true; // Power-off, the rest of this tick was not recorded
+        return nullptr;
+    }
+    if (found != type) {
+        char what[64];
+        if (found == CAPTURE_LOST) {
+            snprintf(what, sizeof(what), "recording has a gap of %u bytes", payload[0] | (payload[1] << 8));
+        } else {
+            snprintf(what, sizeof(what), "expected %s, recorded %s", recordName(type), recordName(found));
+        }
+        fail(what);
+        return nullptr;
+    }
+    _pos += 2 + length;
+    _records++;
+    return payload;
+}
+
+void InputCapture::mismatch(const char *what) {
+    if (_mismatches++ == 0 && _error[0] == '\0') {
+        snprintf(_error, sizeof(_error), "tick %lu, record %lu: %s",
+                 (unsigned long)_ticks, (unsigned long)_records, what);
+    }
+}
+
+void InputCapture::fail(const char *what) {
+    if (_error[0] == '\0') {
+        snprintf(_error, sizeof(_error), "tick %lu, record %lu: %s",
+                 (unsigned long)_ticks, (unsigned long)_records, what);
+    }
+    _failed = true;
+}
+
+uint32_t InputCapture::hash(const void *data, size_t length) {
+    // FNV-1a, 32 bit
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    uint32_t value = 2166136261UL;
+    for (size_t i = 0; i < length; i++) {
+        value = (value ^ bytes[i]) * 16777619UL;
+    }
+    return value;
+}
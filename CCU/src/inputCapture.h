@@ -0,0 +1,138 @@
+#ifndef INPUT_CAPTURE_H
+#define INPUT_CAPTURE_H
+
+#include <Arduino.h>
+#include <SD.h>
+
+#define CAPTURE_MAGIC 0x49554343UL   // "CCUI"
+#define CAPTURE_VERSION 2            // 2: the clock of the I2C queue budget
+#define CAPTURE_BUFFER 2048          // Records waiting for the next tick to write them
+#define CAPTURE_FLUSH_TICKS 75       // File flush every 75 ticks, a power cut loses about 1 s
+#define CAPTURE_TCP_CHUNK 64         // Bytes from the control client per record
+#define CAPTURE_ERROR_LENGTH 128
+
+// Stream: CaptureHeader, then records of u8 type, u8 payload length, payload (little endian)
+enum CaptureRecord : uint8_t {
+    CAPTURE_END = 0,            // End of the stream (not stored)
+    CAPTURE_TICK = 1,           // u32 micros, u32 millis at the tick start
+    CAPTURE_CLOCK = 2,          // u32, a clock value the control path uses
+    CAPTURE_I2C_WRITE = 3,      // u8 address, u8 endTransmission status, data written
+    CAPTURE_I2C_READ = 4,       // u8 address, data received (the count is the length - 1)
+    CAPTURE_TCP = 5,            // u32 micros, u32 millis, bytes from the control client
+    CAPTURE_DISCONNECT = 6,     // The control client was lost
+    CAPTURE_CHECK = 7,          // u32 FNV-1a hash of an output (logged row, ICO state)
+    CAPTURE_LOST = 8            // u16 bytes dropped because the buffer was full
+};
+
+struct __attribute__((packed)) CaptureHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t scalar_size;        // sizeof(control_scalar_t), replays are only exact with the same
+};
+
+/**
+ * @brief Record of every input of the control path, and replay of it on the host.
+ *
+ * Recording (firmware): the tick, the clock values the control path uses, every I2C transaction
+ * (via CaptureWire: IMU register bytes, MU replies, write status), the bytes from the control
+ * client and its loss are appended to a RAM buffer and written to the SD card at the end of each
+ * tick, the context that already owns the card. Outputs are recorded next to the inputs: the
+ * data of every I2C write and a hash of every logged row and of the ICO state.
+ *
+ * Replay (host, ccureplay): the same hooks take their values from the stream instead, in the
+ * same order, and compare the outputs with the recorded ones. A tick that interrupted loop() is
+ * run at loop()'s next hook, which is where the recorded stream shows it.
+ */
+class InputCapture {
+public:
+    InputCapture();
+
+    /// @brief Record to a file on the SD card (overwritten), starts with start().
+    /// Refused once a stream is attached.
+    bool open(const char *filename);
+    /// @brief Replay a stream held in memory, starts with start(). Wins over open(), a
+    /// recording opened before is closed.
+    bool attach(const uint8_t *data, size_t length);
+    /// @brief Called when the control tick is armed, the state from then on is reproducible.
+    /// A recording runs until power-off, the file is flushed every CAPTURE_FLUSH_TICKS.
+    void start();
+
+    bool recording() const { return _mode == MODE_RECORD; }
+    bool replaying() const { return _mode == MODE_REPLAY; }
+    bool active() const { return _mode != MODE_IDLE; }
+
+    /// @brief Tick boundaries, first and last thing in the ISR. end flushes the buffer to SD.
+    void tick(uint32_t &now_us, uint32_t &now_ms);
+    void endTick();
+    /// @brief A clock value the control path uses, returns the recorded one in a replay
+    uint32_t clock(uint32_t value);
+    /// @brief I2C transaction of CaptureWire, returns the status/count to use. For a read,
+    /// count is the bytes received, in a replay the room in data.
+    uint8_t i2cWrite(uint8_t address, const uint8_t *data, uint8_t length, uint8_t status);
+    uint8_t i2cRead(uint8_t address, uint8_t *data, uint8_t count);
+    /// @brief Bytes read from the control client, compared in a replay
+    void tcp(const uint8_t *data, uint8_t length);
+    void disconnect();
+    /// @brief An output, compared with its recorded hash in a replay
+    void check(const void *data, size_t length);
+
+    // Replay
+    /// @brief Next record without taking it, CAPTURE_END at the end or after a failure.
+    /// Records cut off by the power-off end the stream as well.
+    CaptureRecord peek(const uint8_t **payload = nullptr, uint8_t *length = nullptr) const;
+    /// @brief Runs a tick that interrupted loop(), set by the replay runner
+    void setTickHandler(void (*handler)(uint32_t now_us, uint32_t now_ms)) { _tickHandler = handler; }
+    /// @brief From loop() while waiting for the tick: runs it if it is next in the stream,
+    /// fails the replay if another record is (the wait would never end)
+    void pump();
+    bool failed() const { return _failed; }
+    /// @brief The stream ended where the firmware wanted a record, i.e. within the last tick
+    bool ended() const { return _ended; }
+    uint32_t getMismatches() const { return _mismatches; }
+    uint32_t getCompared() const { return _compared; }
+    uint32_t getTicks() const { return _ticks; }
+    uint32_t getRecords() const { return _records; }
+    const char *getError() const { return _error; }
+
+    /// @brief Recording: bytes dropped because the buffer was full (the replay stops there)
+    uint32_t getLost() const { return _lost_total; }
+
+private:
+    enum Mode : uint8_t { MODE_IDLE, MODE_RECORD, MODE_REPLAY };
+
+    bool append(CaptureRecord type, const uint8_t *a, uint8_t a_length,
+                const uint8_t *b = nullptr, uint8_t b_length = 0);
+    void flush();
+    const uint8_t *take(CaptureRecord type, uint8_t &length);
+    void mismatch(const char *what);
+    void fail(const char *what);
+    static uint32_t hash(const void *data, size_t length);
+
+    volatile Mode _mode;
+    bool _opened;
+    bool _inTick;
+
+    // Recording
+    File _file;
+    uint8_t _buffer[CAPTURE_BUFFER];
+    volatile uint16_t _head;        // Oldest unwritten byte
+    volatile uint16_t _count;
+    uint16_t _lost;                 // Dropped since the last CAPTURE_LOST record
+    uint32_t _lost_total;
+    uint16_t _flushTicks;
+
+    // Replay
+    const uint8_t *_stream;
+    size_t _length;
+    size_t _pos;
+    void (*_tickHandler)(uint32_t now_us, uint32_t now_ms);
+    bool _failed;
+    bool _ended;
+    uint32_t _mismatches;
+    uint32_t _compared;
+    uint32_t _ticks;
+    uint32_t _records;
+    char _error[CAPTURE_ERROR_LENGTH];
+};
+
+#endif // INPUT_CAPTURE_H
@@ -0,0 +1,123 @@
+#include "kernelBench.h"
+#include "filter.h"
+#include "ICO_algo.h"
+#include "kinematic.h"
+#include "kinematicTable.h"
+
+static volatile float bench_sink; // Keeps the compiler from dropping the kernels
+
+// Deterministic test input resembling a yaw rate in deg/s
+template <typename T>
+static T benchInput(unsigned int i) {
+    return static_cast<T>(100) + static_cast<T>((i * 37u) % 200u) * static_cast<T>(0.25);
+}
+
+template <typename T>
+static float benchFIR(unsigned int iterations) {
+    FIRFilterT<T> fir({-0.014, -0.127, -0.127, 0.111, 0.383, 0.383, 0.111, -0.127, -0.127, -0.014});
+    T sum = 0;
+    unsigned long start = micros();
+    for (unsigned int i = 0; i < iterations; i++) {
+        sum += fir.filter(benchInput<T>(i));
+    }
+    unsigned long elapsed = micros() - start;
+    bench_sink = sum;
+    return (float)elapsed / iterations;
+}
+
+template <typename T>
+static float benchPID(unsigned int iterations) {
+    PIDFilterT<T> pid(1.24f, 5.27f, 0.0f, 1 / static_cast<T>(75));
+    T sum = 0;
+    unsigned long start = micros();
+    for (unsigned int i = 0; i < iterations; i++) {
+        sum += pid.filter(benchInput<T>(i));
+    }
+    unsigned long elapsed = micros() - start;
+    bench_sink = sum;
+    return (float)elapsed / iterations;
+}
+
+template <typename T>
+static float benchResonator(unsigned int iterations) {
+    ResonatorBankT<T> bank({0.5, 1.0, 2.0, 4.0}, 0.6, 1.0 / 75.0);
+    T sum = 0;
+    unsigned long start = micros();
+    for (unsigned int i = 0; i < iterations; i++) {
+        sum += bank.filter(benchInput<T>(i));
+    }
+    unsigned long elapsed = micros() - start;
+    bench_sink = sum;
+    return (float)elapsed / iterations;
+}
+
+template <typename T>
+static float benchICO(unsigned int iterations) {
+    const T dt = 1 / static_cast<T>(75);
+    PIDFilterT<T> reflex_filter(1.24f, 5.27f, 0.0f, dt);
+    FIRFilterT<T> predictive_filter({-0.014, -0.127, -0.127, 0.111, 0.383, 0.383, 0.111, -0.127, -0.127, -0.014});
+    ResonatorBankT<T> bank({0.5, 1.0, 2.0, 4.0}, 0.6, 1.0 / 75.0);
+    std::vector<PredictiveT<T>> predictive = { PredictiveT<T>(0.0001f, 0.4f, &predictive_filter) };
+    ReflexT<T> reflex(0.2f, dt, &reflex_filter);
+    ICOAlgoT<T> ico(0.0001f, dt, reflex, predictive);
+    ico.setResonatorBank(&bank);
+
+    T sum = 0;
+    unsigned long start = micros();
+    for (unsigned int i = 0; i < iterations; i++) {
+        T input = benchInput<T>(i);
+        sum += ico.computeChange(input, input, static_cast<T>(114.6));
+    }
+    unsigned long elapsed = micros() - start;
+    bench_sink = sum;
+    return (float)elapsed / iterations;
+}
+
+// The kinematics are not templates, they are timed in control_scalar_t as the firmware runs them
+static float benchKinematic(unsigned int iterations) {
+    Kinematic kinematic;
+    Velocities_acker velocities;
+    float sum = 0;
+    unsigned long start = micros();
+    for (unsigned int i = 0; i < iterations; i++) {
+        kinematic.getVelocities_acker(benchInput<control_scalar_t>(i) / 100, 0.5, velocities);
+        sum += velocities.v_left_front + velocities.v_right_rear;
+    }
+    unsigned long elapsed = micros() - start;
+    bench_sink = sum;
+    return (float)elapsed / iterations;
+}
+
+// What the tick runs in the velocity modes
+static float benchKinematicTable(unsigned int iterations) {
+    static KinematicTable table; // Grid of KINEMATIC_TABLE_SIZE turns, kept off the stack
+    WheelCommands commands;
+    table.setRadius(0.5);
+    float sum = 0;
+    unsigned long start = micros();
+    for (unsigned int i = 0; i < iterations; i++) {
+        table.getCommands(benchInput<control_scalar_t>(i) / 100, commands);
+        sum += commands.velocity.v_left_front + commands.mu_speed[3];
+    }
+    unsigned long elapsed = micros() - start;
+    bench_sink = sum;
+    return (float)elapsed / iterations;
+}
+
+// Time of a kernel only built in control_scalar_t, in its column and NAN in the other
+static KernelBenchResult scalarOnly(const char *name, float us) {
+#ifdef CONTROL_SCALAR_DOUBLE
+    return {name, NAN, us};
+#else
+    return {name, us, NAN};
+#endif
+}
+
+void runKernelBench(KernelBenchResult results[KERNEL_BENCH_COUNT], unsigned int iterations) {
+    results[0] = {"FIR10", benchFIR<float>(iterations), benchFIR<double>(iterations)};
+    results[1] = {"PID", benchPID<float>(iterations), benchPID<double>(iterations)};
+    results[2] = {"Resonator4", benchResonator<float>(iterations), benchResonator<double>(iterations)};
+    results[3] = {"ICO", benchICO<float>(iterations), benchICO<double>(iterations)};
+    results[4] = scalarOnly("Kinematic", benchKinematic(iterations));
+    results[5] = scalarOnly("KinematicTable", benchKinematicTable(iterations));
+}
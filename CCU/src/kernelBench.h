@@ -0,0 +1,25 @@
+#ifndef KERNEL_BENCH_H
+#define KERNEL_BENCH_H
+
+#include <Arduino.h>
+
+#define KERNEL_BENCH_COUNT 6
+
+struct KernelBenchResult {
+    const char *name;
+    float us_float;     // Microseconds per call in single precision
+    float us_double;    // Microseconds per call in double precision
+};
+
+/**
+ * @brief Time the control kernels (filters, ICO, kinematics) in float and double.
+ *
+ * Runs every kernel with both template instantiations on the same input sequence, so the
+ * ratio us_double / us_float is the speedup of the hardware FPU over software emulation.
+ * Kinematic and KinematicTable are the shipped classes, built in control_scalar_t only, so
+ * they fill the column of this build and the other one is NAN.
+ * Blocks for iterations * (sum of all kernel times), call it only while stopped.
+ */
+void runKernelBench(KernelBenchResult results[KERNEL_BENCH_COUNT], unsigned int iterations = 1000);
+
+#endif // KERNEL_BENCH_H
@@ -3,11 +3,21 @@
 Kinematic::Kinematic() {
 }
 
-void Kinematic::getVelocities_acker(float v_set, float r_set, Velocities_acker &velocities) {
-    float distance_ICR_left_rear   = ( r_set - ( d_track / 2 ) );
-    float distance_ICR_right_rear  = ( r_set + ( d_track / 2 ) );
-    float distance_ICR_left_front  = sqrt( pow( distance_ICR_left_rear, 2 ) + pow( d_wheelbase,2 ) );
-    float distance_ICR_right_front = sqrt( pow( distance_ICR_right_rear,2 ) + pow( d_wheelbase,2 ) );
+// Geometry in the control scalar type, so no double promotion in the hot path
+static const control_scalar_t half_track = d_track / 2;
+static const control_scalar_t wheelbase_sq = d_wheelbase * d_wheelbase;
+static const control_scalar_t mps_to_rpm = 60.0 / ( PI * d_wheel );
+static const control_scalar_t deg_to_rad = PI / 180.0;
+
+#define ODOMETRY_ITERATIONS 3        // Gauss-Newton steps after the rear wheel start value
+#define ODOMETRY_MIN_SPEED 0.01      // m/s, below this the front wheels carry no yaw information
+#define ODOMETRY_STRAIGHT_OMEGA 1e-3 // rad/s, below this the radius is reported as 0 (straight)
+
+void Kinematic::getVelocities_acker(control_scalar_t v_set, control_scalar_t r_set, Velocities_acker &velocities) {
+    control_scalar_t distance_ICR_left_rear   = ( r_set - half_track );
+    control_scalar_t distance_ICR_right_rear  = ( r_set + half_track );
+    control_scalar_t distance_ICR_left_front  = sqrt( distance_ICR_left_rear * distance_ICR_left_rear + wheelbase_sq );
+    control_scalar_t distance_ICR_right_front = sqrt( distance_ICR_right_rear * distance_ICR_right_rear + wheelbase_sq );
 
     velocities.v_left_front  = ( v_set * ( distance_ICR_left_front  / r_set) );
     velocities.v_right_front = ( v_set * ( distance_ICR_right_front / r_set) );
@@ -15,15 +25,86 @@ void Kinematic::getVelocities_acker(float v_set, float r_set, Velocities_acker &
     velocities.v_right_rear  = ( v_set * ( distance_ICR_right_rear / r_set ) );
 }
 
-void Kinematic::getRpms_acker(float v_set, float r_set, Velocities_acker & velocities) {
+void Kinematic::getRpms_acker(control_scalar_t v_set, control_scalar_t r_set, Velocities_acker & velocities) {
     getVelocities_acker(v_set, r_set, velocities);
-    velocities.v_left_front  = ( ( velocities.v_left_front * 60.0 )  / ( PI * d_wheel ) );
-    velocities.v_right_front = ( ( velocities.v_right_front * 60.0 ) / ( PI * d_wheel ) );
-    velocities.v_left_rear   = ( ( velocities.v_left_rear * 60.0 )   / ( PI * d_wheel ) );
-    velocities.v_right_rear  = ( ( velocities.v_right_rear * 60.0 ) / ( PI * d_wheel ) );
+    velocities.v_left_front  = ( velocities.v_left_front * mps_to_rpm );
+    velocities.v_right_front = ( velocities.v_right_front * mps_to_rpm );
+    velocities.v_left_rear   = ( velocities.v_left_rear * mps_to_rpm );
+    velocities.v_right_rear  = ( velocities.v_right_rear * mps_to_rpm );
 }
 
-void Kinematic::getVelocities_acker_omega(float v_set, float omega_set, Velocities_acker &velocities) {
-    float r_cal = ( v_set / (omega_set * PI / 180.0) ); //Convert from deg/s to rad/s
+void Kinematic::getVelocities_acker_omega(control_scalar_t v_set, control_scalar_t omega_set, Velocities_acker &velocities) {
+    control_scalar_t r_cal = ( v_set / (omega_set * deg_to_rad) ); //Convert from deg/s to rad/s
     getVelocities_acker(v_set, r_cal, velocities);
 }
+
+
+void Kinematic::getOdometry_acker(const Velocities_acker &velocities, Odometry_acker &odometry) {
+    const control_scalar_t meas[4] = { velocities.v_left_front, velocities.v_right_front,
+                                       velocities.v_left_rear, velocities.v_right_rear };
+
+    // Start value from the rear wheels: v_left_rear = v - omega * h, v_right_rear = v + omega * h
+    control_scalar_t v = ( meas[2] + meas[3] ) / 2;
+    control_scalar_t omega = ( meas[3] - meas[2] ) / ( 2 * half_track );
+
+    control_scalar_t model[4];
+    for (int iteration = 0; iteration <= ODOMETRY_ITERATIONS; iteration++) {
+        // Model and Jacobian rows d(model)/d(v, omega) of every wheel
+        control_scalar_t left = v - omega * half_track;
+        control_scalar_t right = v + omega * half_track;
+        control_scalar_t lateral_sq = omega * omega * wheelbase_sq;
+        control_scalar_t left_front = sqrt( left * left + lateral_sq );
+        control_scalar_t right_front = sqrt( right * right + lateral_sq );
+        model[0] = left_front;
+        model[1] = right_front;
+        model[2] = left;
+        model[3] = right;
+
+        if (iteration == ODOMETRY_ITERATIONS || left_front < ODOMETRY_MIN_SPEED || right_front < ODOMETRY_MIN_SPEED) {
+            break;
+        }
+
+        const control_scalar_t j_v[4] = { left / left_front, right / right_front, 1, 1 };
+        const control_scalar_t j_omega[4] = { ( omega * wheelbase_sq - left * half_track ) / left_front,
+                                              ( omega * wheelbase_sq + right * half_track ) / right_front,
+                                              -half_track, half_track };
+
+        // Normal equations (J^T J) delta = J^T residual, 2x2
+        control_scalar_t a = 0, b = 0, c = 0, g_v = 0, g_omega = 0;
+        for (int i = 0; i < 4; i++) {
+            control_scalar_t residual = meas[i] - model[i];
+            a += j_v[i] * j_v[i];
+            b += j_v[i] * j_omega[i];
+            c += j_omega[i] * j_omega[i];
+            g_v += j_v[i] * residual;
+            g_omega += j_omega[i] * residual;
+        }
+        control_scalar_t det = a * c - b * b;
+        if (det <= 0) {
+            break;
+        }
+        v += ( c * g_v - b * g_omega ) / det;
+        omega += ( a * g_omega - b * g_v ) / det;
+    }
+
+    odometry.velocity = v;
+    odometry.yaw_rate = omega / deg_to_rad;
+    odometry.radius = ( fabs(omega) > ODOMETRY_STRAIGHT_OMEGA ) ? v / omega : 0;
+    odometry.residual_left_front  = meas[0] - model[0];
+    odometry.residual_right_front = meas[1] - model[1];
+    odometry.residual_left_rear   = meas[2] - model[2];
+    odometry.residual_right_rear  = meas[3] - model[3];
+}
+
+void Kinematic::integratePose(Pose2D &pose, control_scalar_t v, control_scalar_t omega, control_scalar_t dt) {
+    control_scalar_t delta_heading = omega * deg_to_rad * dt;
+    control_scalar_t distance = v * dt;
+    // Chord of the arc in the direction of the mean heading, exact for constant v and omega
+    control_scalar_t chord = ( fabs(delta_heading) > 1e-6 ) ? distance * sin(delta_heading / 2) / (delta_heading / 2) : distance;
+    control_scalar_t mean_heading = pose.heading + delta_heading / 2;
+    pose.x += chord * cos(mean_heading);
+    pose.y += chord * sin(mean_heading);
+    pose.heading += delta_heading;
+    if (pose.heading > PI) pose.heading -= 2 * PI;
+    else if (pose.heading < -PI) pose.heading += 2 * PI;
+}
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <math.h>
+#include "controlScalar.h"
 
 #define d_track 0.17        //170mm
 #define d_wheelbase 0.29    //290mm
@@ -15,6 +16,22 @@ struct Velocities_acker {
     float v_right_rear;
 };
 
+struct Odometry_acker {
+    float velocity;             // Rear axle centre speed (m/s)
+    float yaw_rate;             // Yaw rate (deg/s), positive turning left
+    float radius;               // Turn radius (m) of the rear axle centre, 0 when driving straight
+    float residual_left_front;  // Measured - model wheel speed (m/s), slip of each wheel
+    float residual_right_front;
+    float residual_left_rear;
+    float residual_right_rear;
+};
+
+struct Pose2D {
+    float x;        // m
+    float y;        // m
+    float heading;  // rad
+};
+
 class Kinematic {
 public:
     Kinematic();
@@ -25,7 +42,7 @@ public:
      * @param r_set The desired turning radius of the vehicle (m).
      * @param velocities The structure to store the calculated wheel velocities (m/s).
      */
-    void getVelocities_acker(float v_set, float r_set, Velocities_acker &velocities);
+    void getVelocities_acker(control_scalar_t v_set, control_scalar_t r_set, Velocities_acker &velocities);
 
     /**
      * @brief Calculate the velocities for a given set velocity and radius.
@@ -34,7 +51,7 @@ public:
      * @param r_set The desired turning radius of the vehicle (m).
      * @param velocities The structure to store the calculated wheel velocities RPM.
      */
-    void getRpms_acker(float v_set, float r_set, Velocities_acker & velocities);
+    void getRpms_acker(control_scalar_t v_set, control_scalar_t r_set, Velocities_acker & velocities);
 
     /**
      * @brief Calculate the Ackermann steering velocities for a given set velocity and angular velocity.
@@ -43,7 +60,28 @@ public:
      * @param omega_set The desired angular velocity of the vehicle (deg/s).
      * @param velocities The structure to store the calculated velocities for each wheel (m/s).
      */
-    void getVelocities_acker_omega(float v_set, float omega_set, Velocities_acker & velocities);
+    void getVelocities_acker_omega(control_scalar_t v_set, control_scalar_t omega_set, Velocities_acker & velocities);
+
+    /**
+     * @brief Inverse of getVelocities_acker: estimate speed and yaw rate from measured wheel speeds.
+     * 
+     * Least squares fit of (v, omega) over all four wheels. The rear wheels are linear in
+     * (v, omega) and give the start value, a few Gauss-Newton steps then add the front wheels.
+     * 
+     * @param velocities Measured wheel velocities (m/s).
+     * @param odometry The structure to store the estimate and the per wheel residuals.
+     */
+    void getOdometry_acker(const Velocities_acker &velocities, Odometry_acker &odometry);
+
+    /**
+     * @brief Dead-reckon a pose over one sample with constant speed and yaw rate (exact arc).
+     * 
+     * @param pose The pose to advance.
+     * @param v The speed of the rear axle centre (m/s).
+     * @param omega The yaw rate (deg/s).
+     * @param dt The sample time (s).
+     */
+    void integratePose(Pose2D &pose, control_scalar_t v, control_scalar_t omega, control_scalar_t dt);
     
 
 private:
@@ -0,0 +1,85 @@
+#include "kinematicTable.h"
+#include "i2c_master.h"
+
+static const control_scalar_t half_track = d_track / 2;
+static const control_scalar_t wheelbase = d_wheelbase;
+static const control_scalar_t mps_to_rpm = 60.0 / ( PI * d_wheel );
+static const control_scalar_t deg_to_rad = PI / 180.0;
+
+KinematicTable::KinematicTable() {
+    grid_step_ = 2 * KINEMATIC_TABLE_MAX_CURVATURE / (KINEMATIC_TABLE_SIZE - 1);
+    for (int i = 0; i < KINEMATIC_TABLE_SIZE; i++) {
+        computeRatios(-KINEMATIC_TABLE_MAX_CURVATURE + i * grid_step_, grid_[i]);
+    }
+    curvature_ = 0;
+    computeRatios(curvature_, ratios_);
+}
+
+void KinematicTable::computeRatios(control_scalar_t curvature, control_scalar_t ratios[4]) {
+    control_scalar_t left_rear = 1 - curvature * half_track;
+    control_scalar_t right_rear = 1 + curvature * half_track;
+    control_scalar_t lateral = curvature * wheelbase;
+    ratios[0] = sqrt( left_rear * left_rear + lateral * lateral );
+    ratios[1] = sqrt( right_rear * right_rear + lateral * lateral );
+    ratios[2] = left_rear;
+    ratios[3] = right_rear;
+}
+
+void KinematicTable::setRadius(control_scalar_t radius) {
+    setCurvature( (radius != 0) ? 1 / radius : 0 );
+}
+
+void KinematicTable::setCurvature(control_scalar_t curvature) {
+    if (curvature != curvature_) {
+        curvature_ = curvature;
+        computeRatios(curvature_, ratios_);
+    }
+}
+
+void KinematicTable::getVelocities(control_scalar_t v_set, Velocities_acker &velocities) {
+    velocities.v_left_front  = v_set * ratios_[0];
+    velocities.v_right_front = v_set * ratios_[1];
+    velocities.v_left_rear   = v_set * ratios_[2];
+    velocities.v_right_rear  = v_set * ratios_[3];
+}
+
+void KinematicTable::getVelocitiesAt(control_scalar_t v_set, control_scalar_t radius, Velocities_acker &velocities) const {
+    control_scalar_t ratios[4];
+    computeRatios( (radius != 0) ? 1 / radius : 0, ratios );
+    velocities.v_left_front  = v_set * ratios[0];
+    velocities.v_right_front = v_set * ratios[1];
+    velocities.v_left_rear   = v_set * ratios[2];
+    velocities.v_right_rear  = v_set * ratios[3];
+}
+
+void KinematicTable::getVelocities_omega(control_scalar_t v_set, control_scalar_t omega_set, Velocities_acker &velocities) {
+    // k = omega / v, standing still has no turn so the ratios do not matter
+    control_scalar_t curvature = (v_set != 0) ? omega_set * deg_to_rad / v_set : 0;
+    control_scalar_t position = constrain( (curvature + KINEMATIC_TABLE_MAX_CURVATURE) / grid_step_,
+                                           0, KINEMATIC_TABLE_SIZE - 1 );
+    int index = (int)position;
+    if (index >= KINEMATIC_TABLE_SIZE - 1) {
+        index = KINEMATIC_TABLE_SIZE - 2;
+    }
+    control_scalar_t fraction = position - index;
+    const control_scalar_t *low = grid_[index];
+    const control_scalar_t *high = grid_[index + 1];
+
+    velocities.v_left_front  = v_set * ( low[0] + fraction * ( high[0] - low[0] ) );
+    velocities.v_right_front = v_set * ( low[1] + fraction * ( high[1] - low[1] ) );
+    velocities.v_left_rear   = v_set * ( low[2] + fraction * ( high[2] - low[2] ) );
+    velocities.v_right_rear  = v_set * ( low[3] + fraction * ( high[3] - low[3] ) );
+}
+
+void KinematicTable::getCommands(control_scalar_t v_set, WheelCommands &commands) {
+    float velocity[4];
+    float rpm[4];
+    for (int i = 0; i < 4; i++) {
+        velocity[i] = v_set * ratios_[i];
+        rpm[i] = velocity[i] * mps_to_rpm;
+        commands.mu_speed[i] = byte(constrain(velocity[i] * SCALE_FACTOR_SPEED, 0, 255));
+        commands.mu_rpm[i] = byte(constrain(rpm[i] * SCALE_FACTOR_RPM, 0, 255));
+    }
+    commands.velocity = {velocity[0], velocity[1], velocity[2], velocity[3]};
+    commands.rpm = {rpm[0], rpm[1], rpm[2], rpm[3]};
+}
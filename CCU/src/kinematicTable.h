@@ -0,0 +1,58 @@
+#ifndef KINEMATIC_TABLE_H
+#define KINEMATIC_TABLE_H
+
+#include <Arduino.h>
+#include "controlScalar.h"
+#include "kinematic.h"
+
+#define KINEMATIC_TABLE_SIZE 65            // Curvature grid points for the omega variant
+#define KINEMATIC_TABLE_MAX_CURVATURE 5.0  // 1/m, tightest turn in the grid (0.2 m radius)
+
+struct WheelCommands {
+    Velocities_acker velocity;  // Wheel velocities (m/s)
+    Velocities_acker rpm;       // Wheel RPM
+    uint8_t mu_speed[4];        // CMD_SET bytes for MU speed mode, wheel order as Velocities_acker
+    uint8_t mu_rpm[4];          // CMD_SET bytes for MU RPM mode
+};
+
+/**
+ * @brief Ackermann wheel ratios precomputed per turn, so the tick only multiplies.
+ *
+ * The ratios are a function of the curvature k = 1 / r of the rear axle centre:
+ *   rear  = 1 -+ k * track / 2
+ *   front = sqrt(rear^2 + (k * wheelbase)^2)
+ * so straight driving (r -> infinity) is k = 0 and needs no special case. For r > 0 the
+ * ratios are the ones of Kinematic::getVelocities_acker, for r < 0 the front wheels keep
+ * driving forward instead of getting the negative speed getVelocities_acker returns.
+ */
+class KinematicTable {
+public:
+    KinematicTable();
+
+    /// @brief Select the turn radius (m), 0 for straight. Only recomputes when it changed.
+    void setRadius(control_scalar_t radius);
+    /// @brief Select the turn curvature (1/m), 0 for straight. Only recomputes when it changed.
+    void setCurvature(control_scalar_t curvature);
+
+    /// @brief Wheel velocities for the selected turn, same units as v_set
+    void getVelocities(control_scalar_t v_set, Velocities_acker &velocities);
+    /// @brief Wheel velocities for another turn radius (m), leaves the selected turn alone
+    void getVelocitiesAt(control_scalar_t v_set, control_scalar_t radius, Velocities_acker &velocities) const;
+
+    /// @brief Wheel velocities for a speed (m/s) and yaw rate (deg/s), interpolated on the curvature grid
+    void getVelocities_omega(control_scalar_t v_set, control_scalar_t omega_set, Velocities_acker &velocities);
+
+    /// @brief m/s, RPM and MU setpoint bytes of all wheels in one pass for the selected turn
+    void getCommands(control_scalar_t v_set, WheelCommands &commands);
+
+private:
+    static void computeRatios(control_scalar_t curvature, control_scalar_t ratios[4]);
+
+    control_scalar_t curvature_;
+    control_scalar_t ratios_[4];    // left front, right front, left rear, right rear
+
+    control_scalar_t grid_step_;    // Curvature between grid points (1/m)
+    control_scalar_t grid_[KINEMATIC_TABLE_SIZE][4];
+};
+
+#endif // KINEMATIC_TABLE_H
@@ -4,28 +4,50 @@
 #include <SD.h>
 #include "AGTimerR4.h" //https://github.com/washiyamagiken/AGTimer_R4_Library/tree/main
 #include "wifihandler.h" 
-#include <DFRobot_BMX160.h>
+#include "imu.h"
 #include "sdLogger.h"
 #include "i2c_master.h"
-#include "SimpleKalmanFilter.h"
+#include "multiAxisKalman.h"
+#include "velocityEstimator.h"
 #include "kinematic.h"
+#include "kinematicTable.h"
 #include "torqueControl.h"
 #include "ICO_algo.h"
 #include "math.h"
 #include "filter.h"
+#include "controlScalar.h"
+#include "kernelBench.h"
+#include "icoStore.h"
+#include "setpointProgram.h"
+#include "commandParser.h"
+#include "paramRegistry.h"
+#include "imuCalibration.h"
+#include "inputCapture.h"
 #include <vector>
 
 
 #define SEND_DATA_SERIAL false
 #define AUTO_STOP_TIME 20 // seconds
-
-const double SAMPLE_FREQ = 75.0; //100Hz, 10ms sample time
+#define ICO_RESONATOR_BANK false // Feed the yaw predictive input through a resonator bank, opt-in until validated on the car
+#define YAW_FROM_ODOMETRY false // Use the wheel odometry yaw rate instead of the gyro for ICO and pose
+#define IMU_DRDY_TICK false // Tick on the BMX160 data ready edge instead of AGTimer, samples are never stale or repeated
+#define IMU_INT_PIN 2 // BMX160 INT1, external interrupt pin of the R4
+#define IMU_DRDY_TIMEOUT_MS 200 // No data ready edge this long after arming: fall back to AGTimer
+#ifndef INPUT_CAPTURE // The host tests build with -DINPUT_CAPTURE=true
+#define INPUT_CAPTURE false // Record every input of the control path to CAPTURE_FILE, replayed on the host by ccureplay
+#endif
+#define CAPTURE_FILE "inputs.bin"
+
+// The BMX160 has no 75 Hz output rate, the data ready tick runs at 100 Hz
+const control_scalar_t SAMPLE_FREQ = IMU_DRDY_TICK ? 100.0 : 75.0;
+const control_scalar_t SAMPLE_TIME = 1 / SAMPLE_FREQ;
 // WiFi Config
 //WiFiHandler wifiHandler("coolguys123", "werty123", 4242);
 //WiFiHandler wifiHandler("net", "simsimbims", 4242);
 //WiFiHandler wifiHandler("Bimso", "banjomus", 4242);
 WiFiHandler wifiHandler("Bimso", "banjomus", 4242);
-WiFiClient client;
+WiFiClient client; // Control client, the only one whose commands are processed
+#define TELEMETRY_DIVIDER 3 // Telemetry to subscribers every 3rd sample (25 Hz)
 
 // ICO algorithms
 ExponentialDecayFilter filter(0.1); // Example filter with alpha = 0.7
@@ -34,40 +56,90 @@ ExponentialDecayFilter filter2(0.8); // Example filter with alpha = 0.7
 FIRFilter firFilter({0.1, 0.2, 0.3}); // Example FIR filter with coefficients
 
 // ICO parameters
-double omega0 = 0.2;
-double omega1 = 0.4;
-double eta = 0.0001;
+control_scalar_t omega0 = 0.2;
+control_scalar_t omega1 = 0.4;
+control_scalar_t eta = 0.0001;
+
+// FIR of the yaw predictive input, tunable with SET:fir_yaw0=...
+#define FIR_YAW_TAPS 10
+control_scalar_t fir_yaw[FIR_YAW_TAPS] = {-0.014, -0.127, -0.127, 0.111, 0.383, 0.383, 0.111, -0.127, -0.127, -0.014};
 
 // Create predictive vectors and populate immediately
 std::vector<Predictive> predictive_vector_yaw = {
-    Predictive(eta, omega1, new FIRFilter({-0.014, -0.127, -0.127, 0.111, 0.383, 0.383, 0.111, -0.127, -0.127, -0.014}))
+    Predictive(eta, omega1, new FIRFilter(std::vector<control_scalar_t>(fir_yaw, fir_yaw + FIR_YAW_TAPS)))
 };
 std::vector<Predictive> predictive_vector_move = {
     Predictive(eta, omega1, new PassThroughFilter())
 };
 
+// Resonators at 0.5-4 Hz as temporal basis for anticipating yaw disturbances, one weight each
+ResonatorBank resonator_bank_yaw({0.5, 1.0, 2.0, 4.0}, 0.6, SAMPLE_TIME);
+
 // Reflexes
-Reflex reflex_yaw(omega0, 1.0 / SAMPLE_FREQ, new PIDFilter(1.24f, 5.27f, 0.0f, 1/SAMPLE_FREQ));
-Reflex reflex_move(omega1, 1.0 / SAMPLE_FREQ, new PassThroughFilter());
+Reflex reflex_yaw(omega0, SAMPLE_TIME, new PIDFilter(1.24f, 5.27f, 0.0f, SAMPLE_TIME));
+Reflex reflex_move(omega1, SAMPLE_TIME, new PassThroughFilter());
 
 // ICO algorithms
-ICOAlgo ico_yaw(eta, 1.0 / SAMPLE_FREQ, reflex_yaw, predictive_vector_yaw);
-ICOAlgo ico_move(eta, 1.0 / SAMPLE_FREQ, reflex_move, predictive_vector_move);
+ICOAlgo ico_yaw(eta, SAMPLE_TIME, reflex_yaw, predictive_vector_yaw);
+ICOAlgo ico_move(eta, SAMPLE_TIME, reflex_move, predictive_vector_move);
 
 
 
 // SD card
 const int chipselect = 10;
 SDLogger sdLogger;
+ICOStore icoStore;
+SetpointProgram program; // Timed setpoint segments, replaces the constant setpoint when enabled
+bool program_enabled = false;
+float program_accel = PROGRAM_MAX_ACCEL;        // m/s² in the velocity modes, RPM/s after scaling in mode 2
+float program_jerk = PROGRAM_MAX_JERK;          // m/s³
+float program_torque_accel = PROGRAM_MAX_ACCEL; // Torque setpoint units/s² in the torque modes
+float program_torque_jerk = PROGRAM_MAX_JERK;   // Torque setpoint units/s³
+bool program_running = false; // A program run owns setpoint and setpoint_radius until it ends
+float program_saved_setpoint = 0;
+float program_saved_radius = 0;
+CommandParser commandParser; // Binary frames and text lines from the TCP client
+bool ico_warm_start = false; // Restore the ICO snapshot for mode, setpoint and radius on START
 
 // I2C
 #define SLAVE_ADDRESS_START 0x08 // Første I2C slaveadresse
-I2CMaster i2cMaster;
+#define I2C_CLOCK_IMU 400000 // BMX160 supports fast mode
+#define I2C_CLOCK_MU 100000 // MUs stay on standard mode
+#define I2C_JOB_BUDGET_US 2000 // Time per tick for writes queued from loop()
+InputCapture inputCapture; // Records the control path's inputs with INPUT_CAPTURE, replays them on the host
+CaptureWire captureWire(Wire, inputCapture);
+I2CBus i2cBus(captureWire); // Arbiter of the shared bus, all IMU and MU traffic goes through it
+I2CMaster i2cMaster(i2cBus);
+uint8_t i2c_imu = 0xFF; // Bus device id of the BMX160
 
 // IMU
-DFRobot_BMX160 bmx160;
-sBmx160SensorData_t Ogyro_offset = {0, 0, 0};  
-sBmx160SensorData_t Oaccel_offset = {0, 0, 0}; 
+Imu bmx160(captureWire); // ImuConfig is written to the sensor by pollBegin()
+#define IMU_STILL_WINDOW 75 // Samples per stillness check (1 s at 75 Hz)
+#define IMU_STILL_GYRO_VAR 0.8 // dps², sum of the axes
+#define IMU_STILL_ACCEL_VAR 0.005 // (m/s²)², sum of the axes
+#define IMU_CAL_TIMEOUT 2250 // Ticks (30 s at 75 Hz) to find a still window, and for the FOC itself
+ImuCalibration imuCalibration(bmx160, IMU_STILL_WINDOW, IMU_STILL_GYRO_VAR, IMU_STILL_ACCEL_VAR, IMU_CAL_TIMEOUT);
+const char *const imu_cal_state_names[] = {"IDLE", "WAIT_STILL", "FOC", "DONE", "FAILED"};
+
+// Boot stages, each records millis() when it finished (0 while pending)
+enum BootStage : uint8_t { BOOT_SD, BOOT_MU, BOOT_IMU, BOOT_CONTROL, BOOT_WIFI, BOOT_STAGES };
+const char *const boot_stage_names[BOOT_STAGES] = {"SD", "MU", "IMU", "CONTROL", "WIFI"};
+unsigned long boot_stage_ms[BOOT_STAGES] = {0};
+enum ImuState : uint8_t { IMU_SEARCHING, IMU_STARTING, IMU_READY };
+ImuState imu_state = IMU_SEARCHING;
+#define IMU_RETRY_MS 1000 // Retry a missing IMU this often
+uint8_t mu_present = 0; // Bit i set if MU i acknowledged at boot
+enum TickSource : uint8_t { TICK_NONE, TICK_TIMER, TICK_DRDY };
+const char *const tick_source_names[] = {"NONE", "TIMER", "DRDY"};
+TickSource tick_source = TICK_NONE;
+volatile uint32_t tick_count = 0; // Control ticks since the tick was armed
+uint32_t tick_period_min_us = UINT32_MAX; // Spread of the tick period since START
+uint32_t tick_period_max_us = 0;
+#define MAG_DECIMATION 15 // Magnetometer read every 15th tick (5 Hz), not used by the control loop
+sBmx160SensorData_t magn_sample = {0, 0, 0}; // Last magnetometer reading (uT)
+uint64_t sensor_time_us = 0; // BMX160 clock at the last sample (us)
+bool sensor_time_valid = false; // False until the first sample after START
+#define SAMPLE_DT_MAX (4 * SAMPLE_TIME) // Longer gaps (first sample, stalled sensor) use SAMPLE_TIME
 
 bool is_active = false; // Flag til logging
 
@@ -82,56 +154,132 @@ uint8_t mode = 2;
 float setpoint = 0;                  
 float setpoint_radius = 0.5; 
 
-double actual_velocity = 0; // Initialize actual velocity
-double actual_velocity_x = 0; // Initialize actual velocity in x direction
-double actual_velocity_y = 0; // Initialize actual velocity in y direction
+control_scalar_t actual_velocity = 0; // Initialize actual velocity
 
-double logging_time_start = 0; // Initialize logging time
+unsigned long logging_time_start = 0; // Initialize logging time
 
-double setpoint_yaw_degs = 0;
-double updated_velocity = 0;
-double error_yaw = 0;
-double error_velocity = 0;
+control_scalar_t setpoint_yaw_degs = 0;
+control_scalar_t updated_velocity = 0;
+control_scalar_t velocity_correction = 0; // ico_move output, learned from actual_velocity, not applied to the wheels yet
+control_scalar_t error_yaw = 0;
+control_scalar_t error_velocity = 0;
 
 // int setpoint0 = 711; // left front
 // int setpoint1 = 916.9; // right front
 // int setpoint2 = 582.8; // left rear
 // int setpoint3 = 821.5; // right rear
 
-// Create Kalman filters for each axis with appropriate parameters
-// Gyroscope: 0.07 °/s noise
-SimpleKalmanFilter gyroFilterX(0.07, 1.0, 0.01);
-SimpleKalmanFilter gyroFilterY(0.07, 1.0, 0.01);
-SimpleKalmanFilter gyroFilterZ(0.07, 1.0, 0.01);
-
-// Accelerometer: 1.8mg noise (0.01766 m/s²)
-SimpleKalmanFilter accelFilterX(0.01766, 1.0, 0.01);
-SimpleKalmanFilter accelFilterY(0.01766, 1.0, 0.01);
-SimpleKalmanFilter accelFilterZ(0.01766, 1.0, 0.01);
+// Kalman filter for the IMU channels used by the controller, updated in one pass
+// Gyroscope: 0.07 °/s noise, accelerometer: 1.8mg noise (0.01766 m/s²)
+#define IMU_GYRO_Z  0
+#define IMU_ACCEL_X 1
+#define IMU_ACCEL_Y 2
+#define IMU_CHANNELS 3
+control_scalar_t gyro_measure_error = 0.28;
+control_scalar_t accel_measure_error = 0.01766;
+control_scalar_t imu_process_noise = 0.01;
+MultiAxisKalman<IMU_CHANNELS> imuFilter({gyro_measure_error, accel_measure_error, accel_measure_error}, 1.0, imu_process_noise);
+
+// Online gyro bias estimation of what the sensor's offset compensation leaves
+#define GYRO_BIAS_Q 1e-6             // Bias random walk per sample
+#define GYRO_STATIONARY_THRESHOLD 2.0 // Below this raw gyro rate (dps) the channel counts as stationary
+#define GYRO_STATIONARY_ERROR 0.01   // Measurement error of the zero-rate update
 
 Kinematic kinematic_model;
+KinematicTable kinematic_table; // Wheel ratios of the current turn, recomputed only when the radius changes
+WheelCommands wheel_commands; // Wheel setpoints in m/s, RPM and MU units
+VelocityEstimator velocityEstimator(SAMPLE_TIME);
+Velocities_acker wheel_speeds = {0, 0, 0, 0}; // Measured wheel speeds (m/s) from the last tick
+bool wheel_speeds_valid = false; // False in torque modes (the MUs report torque) and when a MU did not answer
+dataBlock last_sample; // Last logged sample, read by loop() for telemetry
+volatile uint32_t sample_count = 0; // Samples since boot, tells loop() a new sample is ready
+Odometry_acker odometry = {0, 0, 0, 0, 0, 0, 0}; // Inverse kinematics of the wheel speeds
+Pose2D pose = {0, 0, 0}; // Dead-reckoned pose since START
 Velocities_acker wheel_RPMs; // Struct to hold wheel velocities
 Velocities_acker Wheel_velocities; // Struct to hold wheel velocities
 
 // Torque control
 TorqueControl torque_control;
 Currents currents; // Struct to hold currents for each wheel
+control_scalar_t motor_constant = 98.1; // MU torque setpoint per ampere
 
 // Prototypes
+void sendMuParams();
+void applyICOOmega();
+void applyICOEta();
+void applyKalman();
+void applyFirYaw();
+void applyProgramLimits();
+void endProgramRun();
 void handleClientCommunication(WiFiClient &client);
-void processClientMessage(String message);
-void calbrateIMU(void);
+void publishTelemetry();
+void processCommand(const Command &command);
+void processClientMessage(const char *message);
+void bootStep();
+void bootDone(BootStage stage);
+void startControl();
+void armControlTick();
+void controlClientLost();
+void waitForTick();
+
+// Tunable parameters for GET/SET/DUMP, applied at the start of a tick
+const ParamDef param_table[] = {
+    {"kp",              PARAM_FLOAT,  0, 100,   &kp,                  sendMuParams},
+    {"ki",              PARAM_FLOAT,  0, 1000,  &ki,                  sendMuParams},
+    {"kd",              PARAM_FLOAT,  0, 10,    &kd,                  sendMuParams},
+    {"setpoint",        PARAM_FLOAT,  -2000, 2000, &setpoint,         nullptr},
+    {"setpoint_radius", PARAM_FLOAT,  -10, 10,  &setpoint_radius,     nullptr}, // 0 drives straight
+    {"omega0",          PARAM_SCALAR, 0, 10,    &omega0,              applyICOOmega},
+    {"omega1",          PARAM_SCALAR, 0, 10,    &omega1,              applyICOOmega},
+    {"eta",             PARAM_SCALAR, 0, 0.1,   &eta,                 applyICOEta},
+    {"gyro_mea_e",      PARAM_SCALAR, 1e-6, 10, &gyro_measure_error,  applyKalman},
+    {"accel_mea_e",     PARAM_SCALAR, 1e-6, 10, &accel_measure_error, applyKalman},
+    {"imu_q",           PARAM_SCALAR, 0, 10,    &imu_process_noise,   applyKalman},
+    {"motor_constant",  PARAM_SCALAR, 0, 1000,  &motor_constant,      nullptr},
+    {"fir_yaw0",        PARAM_SCALAR, -2, 2,    &fir_yaw[0],          applyFirYaw},
+    {"fir_yaw1",        PARAM_SCALAR, -2, 2,    &fir_yaw[1],          applyFirYaw},
+    {"fir_yaw2",        PARAM_SCALAR, -2, 2,    &fir_yaw[2],          applyFirYaw},
+    {"fir_yaw3",        PARAM_SCALAR, -2, 2,    &fir_yaw[3],          applyFirYaw},
+    {"fir_yaw4",        PARAM_SCALAR, -2, 2,    &fir_yaw[4],          applyFirYaw},
+    {"fir_yaw5",        PARAM_SCALAR, -2, 2,    &fir_yaw[5],          applyFirYaw},
+    {"fir_yaw6",        PARAM_SCALAR, -2, 2,    &fir_yaw[6],          applyFirYaw},
+    {"fir_yaw7",        PARAM_SCALAR, -2, 2,    &fir_yaw[7],          applyFirYaw},
+    {"fir_yaw8",        PARAM_SCALAR, -2, 2,    &fir_yaw[8],          applyFirYaw},
+    {"fir_yaw9",        PARAM_SCALAR, -2, 2,    &fir_yaw[9],          applyFirYaw},
+    {"prog_accel",      PARAM_FLOAT,  0.01, 50, &program_accel,       applyProgramLimits},
+    {"prog_jerk",       PARAM_FLOAT,  0.01, 500, &program_jerk,       applyProgramLimits},
+    {"prog_t_accel",    PARAM_FLOAT,  0.01, 1000, &program_torque_accel, applyProgramLimits},
+    {"prog_t_jerk",     PARAM_FLOAT,  0.01, 10000, &program_torque_jerk, applyProgramLimits},
+};
+ParamRegistry params(param_table, sizeof(param_table) / sizeof(param_table[0]));
 
+// Control tick, from AGTimer or the BMX160 data ready edge (IMU_DRDY_TICK)
 void timerISR() {
-    if ((millis() - logging_time_start) >= (1000*AUTO_STOP_TIME) && is_active == true)
+    static uint32_t last_tick_us = 0;
+    uint32_t now_us = micros();
+    uint32_t now_ms = millis();
+    inputCapture.tick(now_us, now_ms); // The clock of the tick, recorded or replayed
+    if (tick_count > 0) {
+        const uint32_t period = now_us - last_tick_us;
+        if (period < tick_period_min_us) tick_period_min_us = period;
+        if (period > tick_period_max_us) tick_period_max_us = period;
+    }
+    last_tick_us = now_us;
+    tick_count++;
+
+    i2cBus.tickStart();
+    params.applyPending(); // SET batches take effect between ticks, never within one
+    bool run_done = program_enabled ? program.isFinished() : (now_ms - logging_time_start) >= (1000*AUTO_STOP_TIME);
+    if (run_done && is_active == true)
     {
-        i2cMaster.sendSetpoint(SLAVE_ADDRESS_START,   0);
-        i2cMaster.sendSetpoint(SLAVE_ADDRESS_START+1, 0);
-        i2cMaster.sendSetpoint(SLAVE_ADDRESS_START+2, 0);
-        i2cMaster.sendSetpoint(SLAVE_ADDRESS_START+3, 0);
+        i2cMaster.sendSetpoint(SLAVE_ADDRESS_START,   0, I2C_PRIORITY_HIGH);
+        i2cMaster.sendSetpoint(SLAVE_ADDRESS_START+1, 0, I2C_PRIORITY_HIGH);
+        i2cMaster.sendSetpoint(SLAVE_ADDRESS_START+2, 0, I2C_PRIORITY_HIGH);
+        i2cMaster.sendSetpoint(SLAVE_ADDRESS_START+3, 0, I2C_PRIORITY_HIGH);
 
         sdLogger.close();
         is_active = false;
+        endProgramRun();
         
         // Reset all setpoints
         
@@ -141,30 +289,54 @@ void timerISR() {
 
     if(is_active){
         //Perform measurements and add to queue
-        unsigned long timestamp = millis();   
+        unsigned long timestamp = now_ms;
+
+        if (program_enabled) {
+            program.update(SAMPLE_TIME, setpoint, setpoint_radius);
+        }
 
         #ifdef SEND_DATA_CONTROL_SERIAL
         Serial.print("Timestamp: "); Serial.print(timestamp); Serial.println(" ms, ");
         #endif
         
 
-        sBmx160SensorData_t Ogyro = {0, 0, 0};  
-        sBmx160SensorData_t Oaccel = {0, 0, 0}; 
-        sBmx160SensorData_t Omagn = {0, 0, 0};  
-        //bmx160.getGyroACC(&Ogyro, &Oaccel);
-        bmx160.getAllData(&Omagn, &Ogyro, &Oaccel);
-        //sdLogger.addData({timestamp, Oaccel.x, Oaccel.y, Oaccel.z});
-        Oaccel.x -= Oaccel_offset.x; // Offset for accelerometer
-        Oaccel.y -= Oaccel_offset.y; // Offset for accelerometer
-        Oaccel.z -= Oaccel_offset.z; // Offset for accelerometer
-        //Ogyro.x -= Ogyro_offset.x; // Offset for gyroscope
-        //Ogyro.y -= Ogyro_offset.y; // Offset for gyroscope
-        //Ogyro.z -= Ogyro_offset.z; // Offset for gyroscope
-
-        // Apply Kalman filtering
-        float filtered_gyro_z = gyroFilterZ.updateEstimate(Ogyro.z) * 4;
-        float filtered_accel_x = accelFilterX.updateEstimate(Oaccel.x);
-        float filtered_accel_y = accelFilterY.updateEstimate(Oaccel.y);
+        // The last good sample, a failed read holds it instead of feeding zeros to the filters
+        static sBmx160SensorData_t Ogyro = {0, 0, 0};
+        static sBmx160SensorData_t Oaccel = {0, 0, 0};
+        // Gyro, accel and SENSORTIME every tick (15 bytes), the magnetometer on its own slower
+        // schedule. The IMU is the first transaction of the tick, so its sample phase stays fixed.
+        bool imu_ok = false;
+        if (i2cBus.begin(i2c_imu)) {
+            imu_ok = bmx160.getData(eBmx160ChannelGyro | eBmx160ChannelAccel | eBmx160ChannelTime, NULL, &Ogyro, &Oaccel);
+            i2cBus.end(i2c_imu, 15, imu_ok);
+        }
+        const uint32_t mcu_us = inputCapture.clock(micros());
+
+        // True time since the previous sample from the sensor clock, jitter and missed ticks
+        // do not leak into the integrated velocity and pose. Without a new sample the sensor
+        // time stays at the last good one, the next good sample spans the gap.
+        control_scalar_t dt = SAMPLE_TIME;
+        if (imu_ok) {
+            const uint64_t sample_time_us = bmx160.getSensorTime();
+            if (sensor_time_valid && sample_time_us > sensor_time_us) {
+                dt = (sample_time_us - sensor_time_us) * 1e-6;
+                if (dt > SAMPLE_DT_MAX) dt = SAMPLE_TIME;
+            }
+            sensor_time_us = sample_time_us;
+            sensor_time_valid = true;
+        }
+        if (sample_count % MAG_DECIMATION == 0 && i2cBus.begin(i2c_imu)) {
+            bool ok = bmx160.getData(eBmx160ChannelMagn, &magn_sample, NULL, NULL);
+            i2cBus.end(i2c_imu, 6, ok);
+        }
+        // No offset subtraction, the sensor applies its calibrated offset registers
+
+        // Apply Kalman filtering, the gyro bias is estimated by the filter
+        control_scalar_t imu_samples[IMU_CHANNELS] = {Ogyro.z, Oaccel.x, Oaccel.y};
+        imuFilter.update(imu_samples, imu_samples);
+        float filtered_gyro_z = imu_samples[IMU_GYRO_Z];
+        float filtered_accel_x = imu_samples[IMU_ACCEL_X];
+        float filtered_accel_y = imu_samples[IMU_ACCEL_Y];
         
         #ifdef SEND_DATA_CONTROL_SERIAL
         Serial.print("Filtered Gyro Z: "); Serial.print(filtered_gyro_z); Serial.println(" °/s, ");
@@ -172,12 +344,18 @@ void timerISR() {
         Serial.print("Filtered Accel Y: "); Serial.print(filtered_accel_y); Serial.println(" m/s²");
         #endif
 
-        actual_velocity_x += filtered_accel_x * (1.0 / SAMPLE_FREQ);
-        actual_velocity_y += filtered_accel_y * (1.0 / SAMPLE_FREQ);
+        // Fuse the forward acceleration (IMU y axis) with the wheel speeds of the last tick
+        velocityEstimator.update(filtered_accel_y, filtered_gyro_z, wheel_speeds, wheel_speeds_valid, dt);
+        actual_velocity = velocityEstimator.getVelocity();
 
-        actual_velocity = sqrt(actual_velocity_x * actual_velocity_x + actual_velocity_y * actual_velocity_y); // Calculate the magnitude of the velocity vector
+        // Wheel odometry and dead-reckoned pose (cross-check for the vision pipeline)
+        if (wheel_speeds_valid) {
+            kinematic_model.getOdometry_acker(wheel_speeds, odometry);
+        }
+        control_scalar_t yaw_rate = YAW_FROM_ODOMETRY ? odometry.yaw_rate : velocityEstimator.getYawRate();
+        kinematic_model.integratePose(pose, actual_velocity, yaw_rate, dt);
 
-        double setpoint_yaw_degs = (setpoint / setpoint_radius) * 180/PI;
+        control_scalar_t setpoint_yaw_degs = (setpoint_radius != 0) ? (setpoint / setpoint_radius) * static_cast<control_scalar_t>(RAD_TO_DEG) : 0;
         
         #ifdef SEND_DATA_CONTROL_SERIAL
         Serial.print("Setpoint: "); Serial.print(setpoint); Serial.println(" m/s, ");
@@ -189,13 +367,16 @@ void timerISR() {
         error_yaw = ico_yaw.getError(); // Used for datalogging
         error_velocity = setpoint - actual_velocity;
 
-        double yaw_input = constrain(filtered_gyro_z, 0, 500);
+        control_scalar_t yaw_input = constrain(YAW_FROM_ODOMETRY ? yaw_rate : filtered_gyro_z, 0, 500);
         //double updated_yaw = ico_yaw.computeChange(yaw_input, yaw_input , setpoint_yaw_degs);
         //double updated_system = ico_system.computeChange(updated_yaw,yaw_input, setpoint_yaw_degs);
         //updated_yaw = constrain(updated_yaw, 0, 3000); // Constrain updated_yaw between 0 and 300 deg/s
         //updated_yaw = constrain(updated_yaw, 0, 3000); // Constrain updated_yaw between 0 and 230 deg/s
-        //double updated_velocity = ico_move.computeChange(actual_velocity, setpoint);
-        double updated_yaw = 1;
+        // Speed feedback for ico_move, the setpoint is a speed (m/s) only in modes 0 and 3
+        if (mode == 0 || mode == 3) {
+            velocity_correction = ico_move.computeChange(actual_velocity, actual_velocity, setpoint);
+        }
+        control_scalar_t updated_yaw = 1;
         updated_velocity = ico_yaw.computeChange(yaw_input, yaw_input, setpoint_yaw_degs); // Constrain updated_velocity between 0 and 300 deg/s
 
         #ifdef SEND_DATA_CONTROL_SERIAL
@@ -208,8 +389,10 @@ void timerISR() {
                 // If setpoint is velocity
                 
         
-                //kinematic_model.getVelocities_acker_omega(updated_velocity, updated_yaw, Wheel_velocities);
-                kinematic_model.getVelocities_acker(updated_velocity, 0.5, Wheel_velocities); // 0.5 radius of circle
+                //kinematic_table.getVelocities_omega(updated_velocity, updated_yaw, Wheel_velocities);
+                kinematic_table.setRadius(0.5); // 0.5 radius of circle
+                kinematic_table.getCommands(updated_velocity, wheel_commands);
+                Wheel_velocities = wheel_commands.velocity;
                 
                 #ifdef SEND_DATA_CONTROL_SERIAL
                 Serial.print("Wheel Velocities: ");
@@ -219,17 +402,14 @@ void timerISR() {
                 Serial.print("Right Rear: "); Serial.print(Wheel_velocities.v_right_rear); Serial.println(" m/s");
                 #endif
         
-                i2cMaster.sendSetpoint(SLAVE_ADDRESS_START, Wheel_velocities.v_left_front);
-                i2cMaster.sendSetpoint(SLAVE_ADDRESS_START + 1, Wheel_velocities.v_right_front);
-                i2cMaster.sendSetpoint(SLAVE_ADDRESS_START + 2, Wheel_velocities.v_left_rear);
-                i2cMaster.sendSetpoint(SLAVE_ADDRESS_START + 3, Wheel_velocities.v_right_rear); 
+                for (int i = 0; i < 4; i++) {
+                    i2cMaster.sendSetpointRaw(SLAVE_ADDRESS_START + i, wheel_commands.mu_speed[i]);
+                }
                 break; 
             }
             case 1: {// Torque
                 torque_control.calculateCurrents(updated_velocity, currents);
 
-                double motor_constant = 98.1;
-                
                 i2cMaster.sendSetpoint(SLAVE_ADDRESS_START, currents.current_left_front * motor_constant);
                 i2cMaster.sendSetpoint(SLAVE_ADDRESS_START + 1, currents.current_right_front * motor_constant);
                 i2cMaster.sendSetpoint(SLAVE_ADDRESS_START + 2, currents.current_left_rear * motor_constant);
@@ -238,7 +418,8 @@ void timerISR() {
             }
             case 2: {// RPM
                 // If setpoint is RPM
-                kinematic_model.getVelocities_acker(setpoint, setpoint_radius, wheel_RPMs);
+                kinematic_table.setRadius(setpoint_radius);
+                kinematic_table.getVelocities(setpoint, wheel_RPMs);
                 i2cMaster.sendSetpoint(SLAVE_ADDRESS_START, wheel_RPMs.v_left_front);
                 i2cMaster.sendSetpoint(SLAVE_ADDRESS_START + 1, wheel_RPMs.v_right_front);
                 i2cMaster.sendSetpoint(SLAVE_ADDRESS_START + 2, wheel_RPMs.v_left_rear);
@@ -248,20 +429,19 @@ void timerISR() {
             case 3: { // Disable ICO algorithms and use velocity control
                 // If setpoint is velocity, set pid reflex, if reflex filter is PID
                 
-                kinematic_model.getVelocities_acker(setpoint, 0.5, Wheel_velocities); // 0.5 radius of circle
+                kinematic_table.setRadius(0.5); // 0.5 radius of circle
+                kinematic_table.getCommands(setpoint, wheel_commands);
+                Wheel_velocities = wheel_commands.velocity;
 
-                i2cMaster.sendSetpoint(SLAVE_ADDRESS_START, Wheel_velocities.v_left_front);
-                i2cMaster.sendSetpoint(SLAVE_ADDRESS_START + 1, Wheel_velocities.v_right_front);
-                i2cMaster.sendSetpoint(SLAVE_ADDRESS_START + 2, Wheel_velocities.v_left_rear);
-                i2cMaster.sendSetpoint(SLAVE_ADDRESS_START + 3, Wheel_velocities.v_right_rear);
+                for (int i = 0; i < 4; i++) {
+                    i2cMaster.sendSetpointRaw(SLAVE_ADDRESS_START + i, wheel_commands.mu_speed[i]);
+                }
                 break; 
             }
             case 4: { // Disable ICO algorithms and use torque control
                 // If setpoint is torque, set pid reflex
                 torque_control.calculateCurrents(setpoint, currents);
 
-                double motor_constant = 98.1;
-                
                 i2cMaster.sendSetpoint(SLAVE_ADDRESS_START, currents.current_left_front * motor_constant);
                 i2cMaster.sendSetpoint(SLAVE_ADDRESS_START + 1, currents.current_right_front * motor_constant);
                 i2cMaster.sendSetpoint(SLAVE_ADDRESS_START + 2, currents.current_left_rear * motor_constant);
@@ -275,28 +455,76 @@ void timerISR() {
         }
         
         
-        MUData MU0;
-        MUData MU1;
-        MUData MU2;
-        MUData MU3;
-        i2cMaster.requestData(SLAVE_ADDRESS_START, MU0);
-        i2cMaster.requestData(SLAVE_ADDRESS_START + 1, MU1);
-        i2cMaster.requestData(SLAVE_ADDRESS_START + 2, MU2);
-        i2cMaster.requestData(SLAVE_ADDRESS_START + 3, MU3);
-
-        sdLogger.addData({
+        // A MU that does not answer reads as zero, its wheel speed is not used this tick
+        MUData MU0 = {0, 0, 0};
+        MUData MU1 = {0, 0, 0};
+        MUData MU2 = {0, 0, 0};
+        MUData MU3 = {0, 0, 0};
+        bool mu_ok = i2cMaster.requestData(SLAVE_ADDRESS_START, MU0);
+        mu_ok &= i2cMaster.requestData(SLAVE_ADDRESS_START + 1, MU1);
+        mu_ok &= i2cMaster.requestData(SLAVE_ADDRESS_START + 2, MU2);
+        mu_ok &= i2cMaster.requestData(SLAVE_ADDRESS_START + 3, MU3);
+
+        // Wheel speeds in m/s for the velocity estimate of the next tick
+        switch (mode) {
+            case 0:
+            case 3:
+                wheel_speeds = {(float)MU0.value_recv, (float)MU1.value_recv, (float)MU2.value_recv, (float)MU3.value_recv};
+                wheel_speeds_valid = mu_ok;
+                break;
+            case 2: {
+                const float rpm_to_mps = PI * d_wheel / 60.0;
+                wheel_speeds = {(float)(MU0.value_recv * rpm_to_mps), (float)(MU1.value_recv * rpm_to_mps),
+                                (float)(MU2.value_recv * rpm_to_mps), (float)(MU3.value_recv * rpm_to_mps)};
+                wheel_speeds_valid = mu_ok;
+                break;
+            }
+            default:
+                wheel_speeds_valid = false;
+                break;
+        }
+
+        last_sample = {
             timestamp, 
             mode, setpoint, setpoint_radius, 
             filtered_accel_x, filtered_accel_y, filtered_gyro_z,
-            actual_velocity,
+            static_cast<float>(actual_velocity),
             kp, ki, kd,
             MU0, MU1, MU2, MU3,
-            error_yaw, error_velocity,
-            updated_yaw, updated_velocity,
+            static_cast<float>(error_yaw), static_cast<float>(error_velocity),
+            static_cast<float>(updated_yaw), static_cast<float>(updated_velocity),
             static_cast<float>(ico_yaw.getOmega1()), 
             static_cast<float>(ico_yaw.getPredictiveSum()),
-        });
+            odometry.velocity, odometry.yaw_rate, odometry.radius,
+            fmaxf(fmaxf(fabsf(odometry.residual_left_front), fabsf(odometry.residual_right_front)),
+                  fmaxf(fabsf(odometry.residual_left_rear), fabsf(odometry.residual_right_rear))),
+            pose.x, pose.y, pose.heading,
+            static_cast<float>(dt), sensor_time_us, mcu_us,
+        };
+        sample_count++;
+        sdLogger.addData(last_sample);
+        if (inputCapture.active()) {
+            // Outputs of the tick besides the I2C writes, compared by ccureplay
+            static control_scalar_t ico_state[ICO_STORE_MAX_VALUES];
+            uint8_t packed[DATABLOCK_PACKED_SIZE];
+            inputCapture.check(packed, packDataBlock(last_sample, packed));
+            inputCapture.check(ico_state, ico_yaw.getState(ico_state, ICO_STORE_MAX_VALUES) * sizeof(control_scalar_t));
+        }
+    } else if (imuCalibration.pending() && i2cBus.begin(i2c_imu)) {
+        // Idle ticks feed the calibration, one short transaction each
+        sBmx160SensorData_t Ogyro = {0, 0, 0};
+        sBmx160SensorData_t Oaccel = {0, 0, 0};
+        bool ok = bmx160.getData(eBmx160ChannelGyro | eBmx160ChannelAccel, NULL, &Ogyro, &Oaccel);
+        bool calibrated = ok && imuCalibration.update(Ogyro, Oaccel);
+        i2cBus.end(i2c_imu, 12, ok);
+        if (calibrated) {
+            imuFilter.setBias(IMU_GYRO_Z, 0); // The sensor removes the offset now, the estimate starts over
+        }
     }
+
+    // Writes queued from loop() (PID, STOP, CAL_SPEED...) after the tick's own transactions
+    i2cBus.runQueue(I2C_JOB_BUDGET_US);
+    inputCapture.endTick();
 }
 
 void setup() {
@@ -304,93 +532,294 @@ void setup() {
     Serial.begin(115200);
     pinMode(chipselect, OUTPUT); // Set the CS pin to output
     
+    // Everything that answers at once is brought up here, the IMU and WiFi continue in loop()
     i2cMaster.begin();
-    wifiHandler.connectToWiFi();
-    wifiHandler.startTCPServer();
+    i2c_imu = i2cBus.addDevice("IMU", 0x68, I2C_CLOCK_IMU);
+    for (int i = 0; i < 4; i++) {
+        static const char *const mu_names[4] = {"MU0", "MU1", "MU2", "MU3"};
+        i2cBus.addDevice(mu_names[i], SLAVE_ADDRESS_START + i, I2C_CLOCK_MU);
+    }
     sdLogger.init(chipselect, "data.csv");
-    delay(1000); // Wait for SD card to initialize
+    if (INPUT_CAPTURE) {
+        inputCapture.open(CAPTURE_FILE); // Starts with the control tick
+    }
+    i2cBus.setWaitHook(waitForTick);
+    torque_control.loadMaps(); // Per wheel current maps, linear fit if missing
+    bootDone(BOOT_SD);
 
-    // Initialize Timer1 to trigger every 10ms
-    AGTimer.init(SAMPLE_FREQ, timerISR);
-    AGTimer.start();
+    for (int i = 0; i < 4; i++) {
+        if (i2cMaster.probe(SLAVE_ADDRESS_START + i)) {
+            mu_present |= 1 << i;
+        }
+    }
+    bootDone(BOOT_MU);
 
-    if (!bmx160.begin()) {
-        Serial.println("Sensor init fejlede!");
-        while (1);
+    imuFilter.enableBias(IMU_GYRO_Z, GYRO_BIAS_Q, GYRO_STATIONARY_THRESHOLD, GYRO_STATIONARY_ERROR);
+    if (ICO_RESONATOR_BANK) {
+        ico_yaw.setResonatorBank(&resonator_bank_yaw);
     }
-    Serial.println("Setup complete!");
-    bmx160.setGyroRange(eGyroRange_500DPS); // Gyro range
-    bmx160.setAccelRange(eAccelRange_2G); // Accel range
 
     //predictive_vector_yaw.emplace_back(eta, omega1, &filter2);
     //predictive_vector_move.emplace_back(eta, omega1, &filter2);
 
 }
 
+// Next boot step, returns at once. The control timer is armed as soon as the IMU is ready,
+// WiFi is started afterwards because WiFi.begin() holds loop() until the modem answers.
+void bootStep() {
+    static unsigned long imu_next_try = 0;
+
+    switch (imu_state) {
+    case IMU_SEARCHING:
+        if ((long)(millis() - imu_next_try) < 0) break;
+        if (bmx160.beginAsync()) {
+            imu_state = IMU_STARTING;
+        } else {
+            Serial.println("Sensor init fejlede!");
+            imu_next_try = millis() + IMU_RETRY_MS;
+        }
+        break;
+    case IMU_STARTING:
+        if (!bmx160.pollBegin()) break;
+        startControl();
+        break;
+    case IMU_READY:
+        // INT1 not wired or not configured, keep the car controllable on the timer
+        if (tick_source == TICK_DRDY && tick_count == 0 &&
+            millis() - boot_stage_ms[BOOT_CONTROL] > IMU_DRDY_TIMEOUT_MS) {
+            detachInterrupt(digitalPinToInterrupt(IMU_INT_PIN));
+            Serial.println("No IMU data ready edge, control tick on the timer");
+            AGTimer.init(SAMPLE_FREQ, timerISR);
+            AGTimer.start();
+            tick_source = TICK_TIMER;
+        }
+        break;
+    }
+
+    // WiFi only between IMU steps, a missing IMU does not keep the car offline
+    if (imu_state != IMU_STARTING && boot_stage_ms[BOOT_WIFI] == 0 && wifiHandler.pollConnect()) {
+        bootDone(BOOT_WIFI);
+    }
+}
+
+// IMU ready: arm the control tick. A capture starts here, ccureplay continues from this point.
+void startControl() {
+    imu_state = IMU_READY;
+    bootDone(BOOT_IMU);
+
+    armControlTick();
+    bootDone(BOOT_CONTROL);
+    inputCapture.start();
+    imuCalibration.request(); // The car usually stands still at power-up
+}
+
+// Start the control tick at SAMPLE_FREQ, paced by the sensor's data ready pin or by AGTimer
+void armControlTick() {
+    if (IMU_DRDY_TICK) {
+        bmx160.enableDataReadyInterrupt(eBmx160Int1);
+        pinMode(IMU_INT_PIN, INPUT);
+        i2cBus.setTickRunning(true); // From now on loop() only queues bus transactions
+        attachInterrupt(digitalPinToInterrupt(IMU_INT_PIN), timerISR, RISING);
+        tick_source = TICK_DRDY;
+    } else {
+        AGTimer.init(SAMPLE_FREQ, timerISR);
+        i2cBus.setTickRunning(true);
+        AGTimer.start();
+        tick_source = TICK_TIMER;
+    }
+}
+
+void bootDone(BootStage stage) {
+    boot_stage_ms[stage] = millis();
+    if (boot_stage_ms[stage] == 0) boot_stage_ms[stage] = 1; // 0 means pending
+    Serial.print("Boot: ");
+    Serial.print(boot_stage_names[stage]);
+    Serial.print(" ready at ");
+    Serial.print(boot_stage_ms[stage]);
+    Serial.println(" ms");
+    if (stage == BOOT_MU) {
+        Serial.print("MUs present: 0x");
+        Serial.println(mu_present, HEX);
+    }
+}
+
 void loop() {
-    client = wifiHandler.acceptClient();
-    if (client) {
-        Serial.println("Client connected!");
-        while (client.connected()) {
-            handleClientCommunication(client);
-        }
-        client.stop();
-        is_active = false; // Reset is_active flag when client disconnects
-        Serial.println("Client disconnected.");
+    static ImuCalState imu_cal_reported = IMU_CAL_IDLE;
+
+    bootStep();
+    if (imuCalibration.state() != imu_cal_reported) {
+        imu_cal_reported = imuCalibration.state();
+        Serial.print("IMU calibration: ");
+        Serial.println(imu_cal_state_names[imu_cal_reported]);
+    }
+    if (!wifiHandler.isListening()) return;
+
+    // One pass over all clients, nothing in here waits for a client
+    wifiHandler.poll();
+    if (wifiHandler.controlClientLost()) {
+        controlClientLost();
+    }
+    // A capture holds the commands until it runs, a replay starts from that state
+    if (wifiHandler.hasControlClient() && (!INPUT_CAPTURE || inputCapture.active())) {
+        client = wifiHandler.getControlClient();
+        handleClientCommunication(client);
     }
+    publishTelemetry();
+}
+
+void publishTelemetry() {
+    static uint32_t published_count = 0; // Last sample sent to the TCP subscribers
+    static uint32_t udp_count = 0;       // Last sample sent over UDP
+    if (!is_active) return;
+
+    const uint32_t count = sample_count;
+    const bool udp_due = wifiHandler.udpActive() && count != udp_count;
+    const bool tcp_due = wifiHandler.getSubscriberCount() > 0 && count - published_count >= TELEMETRY_DIVIDER;
+    if (!udp_due && !tcp_due) return;
+
+    noInterrupts();
+    dataBlock sample = last_sample;
+    interrupts();
+
+    if (udp_due) { // Every sample, a skipped sample shows up as a gap in the sample timestamps
+        udp_count = count;
+        uint8_t payload[DATABLOCK_PACKED_SIZE];
+        wifiHandler.sendUDP(payload, packDataBlock(sample, payload));
+    }
+    if (!tcp_due) return;
+    published_count = count;
+
+    // TEL:timestamp,mode,setpoint,setpoint_radius,gyro_z,actual_velocity,pose_x,pose_y,pose_heading
+    String line = String("TEL:") + String(sample.timestamp) + "," + String(sample.mode) + "," +
+                  String(sample.setpoint, 3) + "," + String(sample.setpoint_radius, 3) + "," +
+                  String(sample.gyro_z, 2) + "," + String(sample.actual_velocity, 3) + "," +
+                  String(sample.pose_x, 3) + "," + String(sample.pose_y, 3) + "," + String(sample.pose_heading, 3);
+    wifiHandler.publish(line.c_str());
 }
 
 void handleClientCommunication(WiFiClient &client) {
-    if (client.available()) {
-        String message = client.readStringUntil('\n');
-        processClientMessage(message);
+    // Take what has arrived without waiting, a command may complete over several calls
+    Command command;
+    uint8_t buffer[CAPTURE_TCP_CHUNK];
+    while (client.available()) {
+        int length = client.read(buffer, sizeof(buffer));
+        if (length <= 0) break;
+        inputCapture.tcp(buffer, length);
+        for (int i = 0; i < length; i++) {
+            if (commandParser.push(buffer[i], command)) {
+                processCommand(command);
+            }
+        }
     }
 }
 
-void processClientMessage(String message) {
+void controlClientLost() {
+    inputCapture.disconnect();
+    commandParser.reset(); // A half-received frame or line must not prefix the next client's command
+    is_active = false; // Reset is_active flag when the control client disconnects
+    endProgramRun();
+}
+
+// While loop() waits for the tick to take the bus, the replay runs the recorded tick here
+void waitForTick() {
+    inputCapture.pump();
+    if (inputCapture.failed() || inputCapture.ended()) {
+        i2cBus.setTickRunning(false); // The replay ended, no tick drains the queue any more
+    }
+}
+
+void processCommand(const Command &command) {
+    if (command.type == CMD_TEXT) {
+        processClientMessage(command.text);
+        return;
+    }
     Serial.print("Received: ");
-    Serial.println(message);
+    if (command.binary) {
+        Serial.print("frame ");
+        Serial.println(command.type);
+    } else {
+        Serial.println(command.text);
+    }
 
-    if (message == "START") {
+    switch (command.type) {
+    case CMD_START:
+        if (imu_state != IMU_READY || imuCalibration.busy()) {
+            client.println("ERROR:START");
+            Serial.println("Error: IMU not ready or calibrating");
+            break;
+        }
+        imuCalibration.abort(); // The car is about to move
+        if (program_enabled && program.size() == 0) {
+            client.println("ERROR:START");
+            Serial.println("Error: program enabled but empty");
+            break;
+        }
+        if (program_enabled && (mode == 1 || mode == 4) && program.usesYawRate()) {
+            client.println("ERROR:START");
+            Serial.println("Error: yaw_rate segments need a speed mode, the torque modes have no speed");
+            break;
+        }
         client.println("ACK:START");
+        if (program_enabled) {
+            applyProgramLimits(); // The mode may have changed since the last SET
+            if (!program_running) { // A restart keeps the values of before the first START
+                program_saved_setpoint = setpoint;
+                program_saved_radius = setpoint_radius;
+                program_running = true;
+            }
+            program.start(0); // The car starts at rest
+        }
         ico_move.clearFilters(); // Reset filters for ICO
         ico_yaw.clearFilters(); // Reset filters for ICO
+        velocityEstimator.reset();
+        wheel_speeds_valid = false;
+        odometry = {0, 0, 0, 0, 0, 0, 0};
+        pose = {0, 0, 0};
+        if (ico_warm_start) {
+            icoStore.load(mode, setpoint, setpoint_radius, ico_yaw, ico_move); // Start from converged weights if a snapshot exists
+        }
         is_active = true;
         Serial.println("Logging started!");
-        logging_time_start = millis(); // Start logging time
+        logging_time_start = inputCapture.clock(millis()); // Start logging time
+        tick_period_min_us = UINT32_MAX;
+        tick_period_max_us = 0;
+        sensor_time_valid = false; // The first sample of a run integrates over SAMPLE_TIME
+        break;
 
-    } else if (message == "STOP") {
+    case CMD_STOP:
         client.println("ACK:STOP");
         is_active = false;
+        endProgramRun();
         sdLogger.close();
-        // Reset all setpoints
-        i2cMaster.sendSetpoint(SLAVE_ADDRESS_START,   0);
-        i2cMaster.sendSetpoint(SLAVE_ADDRESS_START+1, 0);
-        i2cMaster.sendSetpoint(SLAVE_ADDRESS_START+2, 0);
-        i2cMaster.sendSetpoint(SLAVE_ADDRESS_START+3, 0);
+        // Reset all setpoints, ahead of anything else waiting for the bus
+        i2cMaster.sendSetpoint(SLAVE_ADDRESS_START,   0, I2C_PRIORITY_HIGH);
+        i2cMaster.sendSetpoint(SLAVE_ADDRESS_START+1, 0, I2C_PRIORITY_HIGH);
+        i2cMaster.sendSetpoint(SLAVE_ADDRESS_START+2, 0, I2C_PRIORITY_HIGH);
+        i2cMaster.sendSetpoint(SLAVE_ADDRESS_START+3, 0, I2C_PRIORITY_HIGH);
         Serial.println("Logging stopped!");
+        Serial.print("Velocity estimator max: "); Serial.print(velocityEstimator.getMaxMicros()); Serial.println(" us");
+        Serial.print("Tick period ("); Serial.print(tick_source_names[tick_source]); Serial.print("): ");
+        Serial.print(tick_period_min_us); Serial.print(" - "); Serial.print(tick_period_max_us); Serial.println(" us");
+        if (inputCapture.recording()) {
+            Serial.print("Capture bytes lost: "); Serial.println(inputCapture.getLost());
+        }
+        if (wifiHandler.udpActive()) {
+            Serial.print("UDP datagrams: "); Serial.print(wifiHandler.getUdpSequence());
+            Serial.print(", send errors: "); Serial.println(wifiHandler.getUdpErrors());
+        }
 
-        calbrateIMU(); // Calibrate IMU after stopping logging
-        Serial.println("IMU calibrated!");
-        
-    } else if (message.startsWith("PID:")) {
-        client.println("ACK:PID");
-        message.remove(0, 4);
-        int comma1 = message.indexOf(',');
-        int comma2 = message.indexOf(',', comma1 + 1);
-        int comma3 = message.indexOf(',', comma2 + 1);
-        int comma4 = message.indexOf(',', comma3 + 1);
-
-        if (comma1 == -1 || comma2 == -1 || comma3 == -1 || comma4 == -1) {
-            Serial.println("Fejl: Forkert PID-format");
-            return;
+        if (imu_state == IMU_READY) {
+            imuCalibration.request(); // Runs in the idle ticks once the car stands still
         }
+        break;
 
-        kp = message.substring(0, comma1).toFloat();
-        ki = message.substring(comma1 + 1, comma2).toFloat();
-        kd = message.substring(comma2 + 1, comma3).toFloat();
-        setpoint = message.substring(comma3 + 1, comma4).toFloat();
-        mode = message.substring(comma4 + 1).toInt();
+    case CMD_PID: { // PID:kp,ki,kd,setpoint,mode
+        client.println("ACK:PID");
+        kp = command.pid.kp;
+        ki = command.pid.ki;
+        kd = command.pid.kd;
+        setpoint = command.pid.setpoint;
+        mode = command.pid.mode;
 
         Serial.print("Parsed PID: ");
         Serial.print("Setpoint: "); Serial.print(setpoint);
@@ -399,28 +828,15 @@ void processClientMessage(String message) {
         Serial.print(" Ki: "); Serial.print(ki);
         Serial.print(" Kd: "); Serial.println(kd);
 
-        int mu_mode = 0;
-        if (mode <= 2)
-            mu_mode = mode;
-        else if (mode == 3) //If 3 disable, ico algorithms and use velocity control
-            mu_mode = 0;
-        else if (mode == 4) //If 4 disable, ico algorithms and use Torque control
-            mu_mode = 1;
+        sendMuParams();
 
-        for (int i = 0; i < 4; i++) {
-            bool success = i2cMaster.sendParam(SLAVE_ADDRESS_START + i, mu_mode, kp, ki, kd);
-            if (!success) {
-                Serial.println("I2C communication failed!");
-            }
-        }
-        
         if (mode == 0) {
             // If mode is velocity, set pid reflex, if reflex filter is PID
             if (reflex_move.getFilter()->getType() == "PID") {
                 static_cast<PIDFilter*>(reflex_move.getFilter())->setParameters(1.24f, 5.27f, 0.0f);
             } else {
                 Serial.println("Reflex filter is not PID, no PID reflex set.");
-                return;
+                break;
             }
         } else if (mode == 1) {
             // If mode is torque, set pid reflex
@@ -428,23 +844,26 @@ void processClientMessage(String message) {
                 static_cast<PIDFilter*>(reflex_yaw.getFilter())->setParameters(1.24f, 5.27f, 0.0f); // 19.35f, 45.98f, 0.0f Legacy
             } else {
                 Serial.println("Reflex filter is not PID, no PID reflex set.");
-                return;
+                break;
             }
         } else {
             Serial.println("Mode not 0 or 1, no PID reflex set.");
-            return;
+            break;
         }
 
-        kinematic_model.getVelocities_acker(setpoint, setpoint_radius, wheel_RPMs);
-        Serial.print("M0: "); Serial.println(wheel_RPMs.v_left_front);
-        Serial.print("M1: "); Serial.println(wheel_RPMs.v_right_front);
-        Serial.print("M2: "); Serial.println(wheel_RPMs.v_left_rear);
-        Serial.print("M3: "); Serial.println(wheel_RPMs.v_right_rear);
-
+        // Not through the selected turn, that state belongs to the tick
+        Velocities_acker preview;
+        kinematic_table.getVelocitiesAt(setpoint, setpoint_radius, preview);
+        Serial.print("M0: "); Serial.println(preview.v_left_front);
+        Serial.print("M1: "); Serial.println(preview.v_right_front);
+        Serial.print("M2: "); Serial.println(preview.v_left_rear);
+        Serial.print("M3: "); Serial.println(preview.v_right_rear);
+        break;
+    }
 
-    } else if (message.startsWith("SETPOINT:")) {
+    case CMD_SETPOINT: // SETPOINT:value
         client.println("ACK:SETPOINT");
-        setpoint = message.substring(9).toFloat();
+        setpoint = command.setpoint.setpoint;
         Serial.print("Setpoint modtaget: ");
         Serial.println(setpoint);
 
@@ -454,28 +873,21 @@ void processClientMessage(String message) {
                 Serial.println("I2C communication failed!");
             }
         }
-    } else if (message.startsWith("ICO:")){ //Format to recieve: Received: ICO:0.5,0.9,0.0001
+        break;
+
+    case CMD_ICO: //Format to recieve: Received: ICO:0.5,0.9,0.0001
         client.println("ACK:ICO");
-        message.remove(0, 4);
-        int comma0 = message.indexOf(',');
-        int comma1 = message.indexOf(',', comma0 + 1);
+        omega0 = command.ico.omega0;
+        omega1 = command.ico.omega1;
+        eta = command.ico.eta;
 
-        if (comma0 == -1 || comma1 == -1) {
-            Serial.println("Error: Invalid ICO format. Expected 'ICO:omega0,omega1'");
-            return;
-        }
-        
-        omega0 = message.substring(0, comma0).toFloat();
-        omega1 = message.substring(comma0 + 1).toFloat();
-        eta = message.substring(comma1 + 1).toFloat();
-        
         if (omega1 <= omega0) {
             Serial.println("Warning: omega1 should be greater than omega0");
         }
-        
-        Serial.print("Updated ICO parameters - omega0: "); 
+
+        Serial.print("Updated ICO parameters - omega0: ");
         Serial.print(omega0);
-        Serial.print(", omega1: "); 
+        Serial.print(", omega1: ");
         Serial.println(omega1);
         Serial.print("Updated ICO eta: ");
         Serial.println(eta);
@@ -483,49 +895,289 @@ void processClientMessage(String message) {
         if (is_active) {
             Serial.println("Warning: Updating ICO parameters during active operation");
         }
-        
-        ico_yaw.updateOmegaValues(omega0, omega1); 
-        ico_move.updateOmegaValues(omega0, omega1);
-        ico_yaw.setEta(eta);
-        ico_move.setEta(eta);
+
+        applyICOOmega();
+        applyICOEta();
         ico_yaw.resetICO();
         ico_move.resetICO();
+        break;
+
+    default: // CMD_INVALID: bad checksum, unknown frame type or malformed numbers
+        client.println("ERROR:PARSE");
+        Serial.print("Error: invalid command ");
+        Serial.println(command.text);
+        break;
     }
 }
 
-void calbrateIMU(void)
-{// If not active, calibrate the IMU
-    sBmx160SensorData_t Ogyro = {0, 0, 0};  
-    sBmx160SensorData_t Oaccel = {0, 0, 0}; 
-    sBmx160SensorData_t Omagn = {0, 0, 0}; 
+void processClientMessage(const char *message) {
+    Serial.print("Received: ");
+    Serial.println(message);
 
-    float gyro_x_sum = 0;
-    float gyro_y_sum = 0;
-    float gyro_z_sum = 0;
+    if (strncmp(message, "PROG_", 5) == 0) { // PROG_CLEAR | PROG_ADD:<segment> | PROG_LOAD:<file> | PROG_RUN:1|0 | PROG_INFO
+        if (is_active) {
+            client.println("ERROR:PROG");
+            Serial.println("Error: program changes only while stopped");
+            return;
+        }
+        bool success = true;
+        if (strcmp(message, "PROG_CLEAR") == 0) {
+            program.clear();
+        } else if (strncmp(message, "PROG_ADD:", 9) == 0) {
+            success = program.addSegment(message + 9);
+        } else if (strncmp(message, "PROG_LOAD:", 10) == 0) {
+            success = program.loadFile(message + 10);
+        } else if (strncmp(message, "PROG_RUN:", 9) == 0) {
+            program_enabled = atoi(message + 9) != 0;
+        } else if (strcmp(message, "PROG_INFO") != 0) {
+            success = false;
+        }
+        client.println(success ? "ACK:PROG" : "ERROR:PROG");
+        client.println("PROG:" + String(program.size()) + "," + String(program.duration(), 2) + "," + String(program_enabled ? 1 : 0));
 
-    float accel_x_sum = 0;
-    float accel_y_sum = 0;
-    float accel_z_sum = 0;
+    } else if (strncmp(message, "TQMAP", 5) == 0) { // TQMAP:<wheel>,<v_min>,<v_max>,<c0>,... | TQMAP_LOAD | TQMAP_CLEAR
+        if (is_active) {
+            client.println("ERROR:TQMAP");
+            Serial.println("Error: torque maps only while stopped");
+            return;
+        }
+        bool success = true;
+        if (strncmp(message, "TQMAP:", 6) == 0) {
+            success = torque_control.setMap(message + 6);
+        } else if (strcmp(message, "TQMAP_LOAD") == 0) {
+            success = torque_control.loadMaps() > 0;
+        } else if (strcmp(message, "TQMAP_CLEAR") == 0) {
+            torque_control.clearMaps();
+        } else {
+            success = false;
+        }
+        client.println(success ? "ACK:TQMAP" : "ERROR:TQMAP");
 
-    for (int i = 0; i < 100; i++) {
-        bmx160.getAllData(&Omagn, &Ogyro, &Oaccel);
-        gyro_x_sum += Ogyro.x;
-        gyro_y_sum += Ogyro.y;
-        gyro_z_sum += Ogyro.z;
+    } else if (strcmp(message, "ICO_SAVE") == 0 || strcmp(message, "ICO_LOAD") == 0) {
+        if (is_active) {
+            client.print("ERROR:");
+            client.println(message);
+            Serial.println("Error: ICO snapshots only while stopped");
+            return;
+        }
+        bool success = (strcmp(message, "ICO_SAVE") == 0) ? icoStore.save(mode, setpoint, setpoint_radius, ico_yaw, ico_move)
+                                                           : icoStore.load(mode, setpoint, setpoint_radius, ico_yaw, ico_move);
+        client.print(success ? "ACK:" : "ERROR:");
+        client.println(message);
+
+    } else if (strncmp(message, "ICO_WARM:", 9) == 0) { //Format: ICO_WARM:1 or ICO_WARM:0
+        client.println("ACK:ICO_WARM");
+        ico_warm_start = atoi(message + 9) != 0;
+        Serial.print("ICO warm start: ");
+        Serial.println(ico_warm_start ? "on" : "off");
+
+    } else if (strncmp(message, "UDP_SUB:", 8) == 0) { // UDP_SUB:<port> | UDP_SUB:<ip>,<port> | UDP_SUB:0
+        const char *args = message + 8;
+        const char *comma = strchr(args, ',');
+        IPAddress ip = client.remoteIP(); // Default: the control client
+        if (comma) {
+            char ip_text[16] = {0};
+            size_t length = comma - args;
+            if (length >= sizeof(ip_text) || !ip.fromString(strncpy(ip_text, args, length))) {
+                client.println("ERROR:UDP_SUB");
+                return;
+            }
+            args = comma + 1;
+        }
+        long port = atol(args);
+        if (port < 0 || port > 65535) {
+            client.println("ERROR:UDP_SUB");
+            return;
+        }
+        if (port == 0) {
+            wifiHandler.stopUDP();
+        } else {
+            wifiHandler.startUDP(ip, port);
+        }
+        client.println("ACK:UDP_SUB");
 
-        accel_x_sum += Oaccel.x;
-        accel_y_sum += Oaccel.y;
-        accel_z_sum += Oaccel.z;
+    } else if (strncmp(message, "SET:", 4) == 0) { // SET:name=value,name=value,... applied together at the next tick
+        String error;
+        if (params.stage(message + 4, error)) {
+            client.println("ACK:SET");
+        } else {
+            client.println("ERROR:SET," + error);
+        }
 
-        delay(5); // Wait for 5ms between samples
+    } else if (strncmp(message, "GET:", 4) == 0) { // GET:name,name,... -> GET:name=value,...
+        String reply = "GET:";
+        const char *p = message + 4;
+        while (*p) {
+            const char *comma = strchr(p, ',');
+            size_t length = comma ? (size_t)(comma - p) : strlen(p);
+            char name[24];
+            if (length >= sizeof(name)) length = sizeof(name) - 1;
+            memcpy(name, p, length);
+            name[length] = '\0';
+            int index = params.find(name);
+            if (index < 0) {
+                client.println(String("ERROR:GET,") + name);
+                return;
+            }
+            if (reply.length() > 4) reply += ",";
+            reply += String(name) + "=" + params.format(index);
+            p = comma ? comma + 1 : p + length;
+        }
+        client.println(reply);
+
+    } else if (strcmp(message, "DUMP") == 0) { // PARAM:name,min,max,value per parameter, then ACK:DUMP
+        for (uint8_t i = 0; i < params.size(); i++) {
+            const ParamDef &param = params.at(i);
+            client.println(String("PARAM:") + param.name + "," + String(param.min, 6) + "," +
+                           String(param.max, 6) + "," + params.format(i));
+        }
+        client.println("ACK:DUMP");
+
+    } else if (strcmp(message, "BOOT") == 0) { // BOOT:<stage>,<ms> per stage (0 = pending), BOOT:MU_PRESENT,<mask>, BOOT:TICK,<source>,<ticks>
+        for (int i = 0; i < BOOT_STAGES; i++) {
+            client.println(String("BOOT:") + boot_stage_names[i] + "," + String(boot_stage_ms[i]));
+        }
+        client.println("BOOT:MU_PRESENT," + String(mu_present));
+        client.println(String("BOOT:TICK,") + tick_source_names[tick_source] + "," + String(tick_count));
+        client.println("ACK:BOOT");
+
+    } else if (strcmp(message, "IMU_CAL") == 0) { // Calibrate once the car stands still
+        if (imu_state != IMU_READY || is_active) {
+            client.println("ERROR:IMU_CAL");
+            return;
+        }
+        imuCalibration.request();
+        client.println("ACK:IMU_CAL");
+
+    } else if (strcmp(message, "IMU_CAL_STATUS") == 0) { // IMU_CAL:<state>,<count>,<gyro var>,<accel var>, IMU_OFFSETS:<accel x,y,z>,<gyro x,y,z>
+        client.println(String("IMU_CAL:") + imu_cal_state_names[imuCalibration.state()] + "," +
+                       String(imuCalibration.getCount()) + "," +
+                       String(imuCalibration.getGyroVariance(), 5) + "," +
+                       String(imuCalibration.getAccelVariance(), 5));
+        if (imu_state == IMU_READY && !is_active && !imuCalibration.pending()) {
+            int8_t accel[3] = {0, 0, 0};
+            int16_t gyro[3] = {0, 0, 0};
+            i2cBus.acquire();
+            if (i2cBus.begin(i2c_imu)) {
+                bmx160.getOffsets(accel, gyro);
+                i2cBus.end(i2c_imu, 7);
+            }
+            i2cBus.release();
+            client.println("IMU_OFFSETS:" + String(accel[0]) + "," + String(accel[1]) + "," + String(accel[2]) + "," +
+                           String(gyro[0]) + "," + String(gyro[1]) + "," + String(gyro[2]));
+        }
+        client.println("ACK:IMU_CAL_STATUS");
+
+    } else if (strcmp(message, "I2C_STATS") == 0) { // I2C:<name>,<addr>,<clock>,<n>,<bytes>,<errors>,<busy us>,<max us>,<max wait us>,<phase min>,<phase max>
+        for (uint8_t i = 0; i < i2cBus.deviceCount(); i++) {
+            const I2CDeviceStats &stats = i2cBus.getStats(i);
+            client.println(String("I2C:") + stats.name + "," + String(stats.address) + "," +
+                           String(stats.clock) + "," + String(stats.transactions) + "," +
+                           String(stats.bytes) + "," + String(stats.errors) + "," +
+                           String(stats.busy_us) + "," + String(stats.max_us) + "," +
+                           String(stats.max_wait_us) + "," +
+                           String(stats.transactions ? stats.phase_min_us : 0) + "," +
+                           String(stats.phase_max_us));
+        }
+        client.println("I2C:BUS," + String(i2cBus.utilisation() * 100, 2) + "," +
+                       String(i2cBus.queued()) + "," + String(i2cBus.getDropped()));
+        client.println("ACK:I2C_STATS");
+
+    } else if (strcmp(message, "I2C_RESET") == 0) {
+        i2cBus.resetStats();
+        client.println("ACK:I2C_RESET");
+
+    } else if (strcmp(message, "BENCH") == 0) { // Time the control kernels in float and double
+        if (is_active) {
+            client.println("ERROR:BENCH");
+            return;
+        }
+        client.println("ACK:BENCH");
+        KernelBenchResult results[KERNEL_BENCH_COUNT];
+        runKernelBench(results);
+        for (int i = 0; i < KERNEL_BENCH_COUNT; i++) {
+            String line = String("BENCH:") + results[i].name + "," +
+                          String(results[i].us_float, 3) + "," +
+                          String(results[i].us_double, 3) + "," +
+                          String(results[i].us_double / results[i].us_float, 2);
+            client.println(line);
+            Serial.println(line);
+        }
+
+    } else {
+        Serial.println("Error: unknown command");
+    }
+}
+
+void sendMuParams() {
+    int mu_mode = 0;
+    if (mode <= 2)
+        mu_mode = mode;
+    else if (mode == 3) //If 3 disable, ico algorithms and use velocity control
+        mu_mode = 0;
+    else if (mode == 4) //If 4 disable, ico algorithms and use Torque control
+        mu_mode = 1;
+
+    for (int i = 0; i < 4; i++) {
+        bool success = i2cMaster.sendParam(SLAVE_ADDRESS_START + i, mu_mode, kp, ki, kd);
+        if (!success) {
+            Serial.println("I2C communication failed!");
+        }
     }
-    double gyro_x_offset = gyro_x_sum / 100;
-    double gyro_y_offset = gyro_y_sum / 100;
-    double gyro_z_offset = gyro_z_sum / 100;
-    double accel_x_offset = accel_x_sum / 100;
-    double accel_y_offset = accel_y_sum / 100;
-    double accel_z_offset = accel_z_sum / 100;
-
-    Ogyro_offset = {gyro_x_offset, gyro_y_offset, gyro_z_offset};
-    Oaccel_offset = {accel_x_offset, accel_y_offset, 9.82 - accel_z_offset};
-}
\ No newline at end of file
+}
+
+void applyICOOmega() {
+    ico_yaw.updateOmegaValues(omega0, omega1);
+    ico_move.updateOmegaValues(omega0, omega1);
+}
+
+void applyICOEta() {
+    ico_yaw.setEta(eta);
+    ico_move.setEta(eta);
+}
+
+void applyKalman() {
+    imuFilter.setMeasurementError(IMU_GYRO_Z, gyro_measure_error);
+    imuFilter.setMeasurementError(IMU_ACCEL_X, accel_measure_error);
+    imuFilter.setMeasurementError(IMU_ACCEL_Y, accel_measure_error);
+    for (int i = 0; i < IMU_CHANNELS; i++) {
+        imuFilter.setProcessNoise(i, imu_process_noise);
+    }
+}
+
+void applyFirYaw() {
+    FIRFilter *fir = static_cast<FIRFilter*>(predictive_vector_yaw[0].getFilter());
+    for (int k = 0; k < FIR_YAW_TAPS; k++) {
+        fir->setCoefficient(k, fir_yaw[k]);
+    }
+}
+
+// The program limits and speed scale in the setpoint units of the current mode
+void applyProgramLimits() {
+    switch (mode) {
+        case 1:
+        case 4: // Torque
+            program.setLimits(program_torque_accel, program_torque_jerk);
+            program.setSpeedScale(0);
+            break;
+        case 2: { // RPM of the wheels
+            const float mps_to_rpm = 60.0 / (PI * d_wheel);
+            program.setLimits(program_accel * mps_to_rpm, program_jerk * mps_to_rpm);
+            program.setSpeedScale(1 / mps_to_rpm);
+            break;
+        }
+        default: // m/s
+            program.setLimits(program_accel, program_jerk);
+            program.setSpeedScale(1);
+            break;
+    }
+}
+
+// Give setpoint and setpoint_radius back after a program run, later runs and ICO_SAVE use them
+void endProgramRun() {
+    if (program_running) {
+        program_running = false;
+        setpoint = program_saved_setpoint;
+        setpoint_radius = program_saved_radius;
+    }
+}
@@ -0,0 +1,119 @@
+/*
+ * MultiAxisKalman - SimpleKalmanFilter for N channels in one pass.
+ *
+ * State is stored per field across channels (SoA), so one update call runs the same
+ * arithmetic over all channels without per-object call overhead.
+ * Every channel is a 2-state model x = [rate, bias] measured as z = rate + bias.
+ * The rate update is the SimpleKalmanFilter update on z - bias: gain from the estimate
+ * error, then the process noise q * |change of estimate| is added for the next sample.
+ * With bias estimation disabled (default) the bias stays at its seed value.
+ * With bias estimation enabled the bias is a random walk (q_bias per sample) and is only
+ * updated by a zero-rate measurement while the channel is stationary, i.e. the bias-free
+ * measurement stayed below the threshold for STATIONARY_SAMPLES samples. Rate and bias
+ * are kept uncorrelated so a manoeuvre can not pull the bias.
+ */
+
+#ifndef MULTI_AXIS_KALMAN_H
+#define MULTI_AXIS_KALMAN_H
+
+#include <Arduino.h>
+#include <math.h>
+#include "controlScalar.h"
+
+template <size_t N>
+class MultiAxisKalman {
+public:
+    static const uint16_t STATIONARY_SAMPLES = 25; // ~1/3 s at 75 Hz, longer than a zero crossing of a turn
+
+    /// @param mea_e Measurement error per channel
+    /// @param est_e Initial estimate error (all channels)
+    /// @param q Process noise scale (all channels)
+    MultiAxisKalman(const control_scalar_t (&mea_e)[N], control_scalar_t est_e, control_scalar_t q) {
+        for (size_t i = 0; i < N; i++) {
+            err_measure_[i] = mea_e[i];
+            q_[i] = q;
+            p_rate_[i] = est_e;
+            p_bias_[i] = 0;
+            rate_[i] = 0;
+            bias_[i] = 0;
+            q_bias_[i] = 0;
+            stationary_threshold_[i] = 0;
+            err_stationary_[i] = 0;
+            stationary_count_[i] = 0;
+        }
+    }
+
+    /// @brief Enable online bias estimation on one channel
+    /// @param q_bias Random walk variance of the bias per sample
+    /// @param stationary_threshold Max |measurement - bias| counted as stationary
+    /// @param stationary_error Measurement error of the zero-rate update
+    void enableBias(size_t channel, control_scalar_t q_bias, control_scalar_t stationary_threshold,
+                    control_scalar_t stationary_error) {
+        q_bias_[channel] = q_bias;
+        stationary_threshold_[channel] = stationary_threshold;
+        err_stationary_[channel] = stationary_error;
+        p_bias_[channel] = stationary_error;
+    }
+
+    void setMeasurementError(size_t channel, control_scalar_t mea_e) { err_measure_[channel] = mea_e; }
+    void setProcessNoise(size_t channel, control_scalar_t q) { q_[channel] = q; }
+
+    /// @brief Seed the bias of a channel, e.g. from a standstill calibration
+    void setBias(size_t channel, control_scalar_t bias) {
+        bias_[channel] = bias;
+    }
+
+    /// @brief Update all channels with one sample each
+    /// @param mea Measurements, N values
+    /// @param estimate Bias-free rate estimates, N values (may alias mea)
+    void update(const control_scalar_t *mea, control_scalar_t *estimate) {
+        for (size_t i = 0; i < N; i++) {
+            const control_scalar_t z = mea[i];
+            const control_scalar_t last_rate = rate_[i];
+
+            // Rate update with the measurement z = rate + bias
+            const control_scalar_t k_rate = p_rate_[i] / (p_rate_[i] + err_measure_[i]);
+            rate_[i] = last_rate + k_rate * (z - bias_[i] - last_rate);
+            p_rate_[i] = (1 - k_rate) * p_rate_[i];
+
+            // Bias update while stationary, the zero-rate measurement makes z = bias
+            if (stationary_threshold_[i] > 0) {
+                if (fabs(z - bias_[i]) < stationary_threshold_[i]) {
+                    if (stationary_count_[i] < STATIONARY_SAMPLES) stationary_count_[i]++;
+                } else {
+                    stationary_count_[i] = 0;
+                }
+                if (stationary_count_[i] >= STATIONARY_SAMPLES) {
+                    const control_scalar_t k_bias = p_bias_[i] / (p_bias_[i] + err_stationary_[i]);
+                    bias_[i] += k_bias * (z - bias_[i]);
+                    p_bias_[i] = (1 - k_bias) * p_bias_[i];
+                }
+            }
+
+            // Process noise for the next sample
+            p_rate_[i] += fabs(last_rate - rate_[i]) * q_[i];
+            p_bias_[i] += q_bias_[i];
+
+            estimate[i] = rate_[i];
+        }
+    }
+
+    control_scalar_t getEstimate(size_t channel) const { return rate_[channel]; }
+    control_scalar_t getBias(size_t channel) const { return bias_[channel]; }
+    control_scalar_t getEstimateError(size_t channel) const { return p_rate_[channel]; }
+    bool isStationary(size_t channel) const { return stationary_count_[channel] >= STATIONARY_SAMPLES; }
+
+private:
+    control_scalar_t rate_[N];
+    control_scalar_t bias_[N];
+    control_scalar_t p_rate_[N];     // Covariance of the rate (SimpleKalmanFilter estimate error)
+    control_scalar_t p_bias_[N];     // Covariance of the bias
+    control_scalar_t err_measure_[N];
+    control_scalar_t q_[N];
+    control_scalar_t q_bias_[N];
+    control_scalar_t stationary_threshold_[N]; // 0 disables bias estimation
+    control_scalar_t err_stationary_[N];
+    uint16_t stationary_count_[N];
+};
+
+#endif // MULTI_AXIS_KALMAN_H
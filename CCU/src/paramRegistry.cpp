@@ -0,0 +1,125 @@
+#include "paramRegistry.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+ParamRegistry::ParamRegistry(const ParamDef *table, uint8_t count)
+    : _table(table), _count(count), _batchCount(0), _pending(false) {}
+
+int ParamRegistry::find(const char *name) const {
+    for (uint8_t i = 0; i < _count; i++) {
+        if (strcmp(_table[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+bool ParamRegistry::stage(const char *assignments, String &error) {
+    if (_pending) {
+        error = "busy";
+        return false;
+    }
+
+    uint8_t count = 0;
+    const char *p = assignments;
+    while (*p) {
+        const char *equals = strchr(p, '=');
+        if (!equals || equals == p) {
+            error = "format";
+            return false;
+        }
+        char name[24];
+        size_t length = equals - p;
+        if (length >= sizeof(name)) {
+            error = "name";
+            return false;
+        }
+        memcpy(name, p, length);
+        name[length] = '\0';
+
+        int index = find(name);
+        if (index < 0) {
+            error = name;
+            return false;
+        }
+        char *end;
+        double value = strtod(equals + 1, &end);
+        if (end == equals + 1 || (*end != ',' && *end != '\0') ||
+            value < _table[index].min || value > _table[index].max) {
+            error = name;
+            return false;
+        }
+        if (count >= PARAM_MAX_BATCH) {
+            error = "batch";
+            return false;
+        }
+        _batchIndex[count] = index;
+        _batchValue[count] = value;
+        count++;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    if (count == 0) {
+        error = "format";
+        return false;
+    }
+
+    noInterrupts(); // Also a compiler barrier, the batch is complete before the flag is seen
+    _batchCount = count;
+    _pending = true; // Hand over to the tick, the batch is not touched again until applied
+    interrupts();
+    return true;
+}
+
+void ParamRegistry::applyPending() {
+    if (!_pending) return;
+
+    for (uint8_t i = 0; i < _batchCount; i++) {
+        write(_batchIndex[i], _batchValue[i]);
+    }
+    // Each hook once, even if the batch set several of its parameters
+    for (uint8_t i = 0; i < _batchCount; i++) {
+        ParamApply apply = _table[_batchIndex[i]].apply;
+        if (!apply) continue;
+        bool done = false;
+        for (uint8_t k = 0; k < i && !done; k++) {
+            done = _table[_batchIndex[k]].apply == apply;
+        }
+        if (!done) apply();
+    }
+    _batchCount = 0;
+    _pending = false;
+}
+
+void ParamRegistry::write(uint8_t index, double value) {
+    const ParamDef &param = _table[index];
+    switch (param.type) {
+        case PARAM_FLOAT:  *static_cast<float *>(param.value) = value; break;
+        case PARAM_SCALAR: *static_cast<control_scalar_t *>(param.value) = value; break;
+        case PARAM_UINT8:  *static_cast<uint8_t *>(param.value) = (uint8_t)lround(value); break;
+    }
+}
+
+double ParamRegistry::read(uint8_t index) const {
+    const ParamDef &param = _table[index];
+    switch (param.type) {
+        case PARAM_FLOAT:  return *static_cast<const float *>(param.value);
+        case PARAM_SCALAR: return *static_cast<const control_scalar_t *>(param.value);
+        case PARAM_UINT8:  return *static_cast<const uint8_t *>(param.value);
+    }
+    return 0;
+}
+
+String ParamRegistry::format(uint8_t index) const {
+    double value = read(index);
+    if (_table[index].type == PARAM_UINT8) {
+        return String((int)value);
+    }
+    // 4 significant digits after the leading zeros
+    int decimals = 4;
+    if (value != 0) {
+        decimals = 3 - (int)floor(log10(fabs(value)));
+        if (decimals < 3) decimals = 3;
+        if (decimals > 12) decimals = 12;
+    }
+    return String(value, decimals);
+}
@@ -0,0 +1,65 @@
+#ifndef PARAM_REGISTRY_H
+#define PARAM_REGISTRY_H
+
+#include <Arduino.h>
+#include "controlScalar.h"
+
+#define PARAM_MAX_BATCH 16  // Assignments in one SET
+
+enum ParamType : uint8_t {
+    PARAM_FLOAT,            // float
+    PARAM_SCALAR,           // control_scalar_t
+    PARAM_UINT8             // uint8_t, value rounded
+};
+
+typedef void (*ParamApply)(void);
+
+// One tunable value. The table is const and lives in flash, the values stay in their globals.
+struct ParamDef {
+    const char *name;
+    ParamType type;
+    float min;
+    float max;
+    void *value;
+    ParamApply apply;       // Called once per batch after the values are written, may be nullptr
+};
+
+/**
+ * @brief Name based GET/SET over a compile-time table of tunable globals.
+ *
+ * SET stages a whole batch after checking every name and range, nothing is written if one
+ * assignment is invalid. The control loop calls applyPending() at the start of a tick, which
+ * writes the batch and runs each affected apply hook once, so a tick never sees half a batch.
+ * The command side and the tick side hand the batch over with one flag, a new batch is
+ * refused until the previous one was applied.
+ */
+class ParamRegistry {
+public:
+    ParamRegistry(const ParamDef *table, uint8_t count);
+
+    /// @brief Stage "name=value,name=value,...", false with error set to the reason or offending name
+    bool stage(const char *assignments, String &error);
+    /// @brief Write the staged batch and run its hooks, call at a tick boundary
+    void applyPending();
+    bool hasPending() const { return _pending; }
+
+    int find(const char *name) const;
+    uint8_t size() const { return _count; }
+    const ParamDef &at(uint8_t index) const { return _table[index]; }
+    double read(uint8_t index) const;
+    /// @brief Value with enough decimals for small values like eta
+    String format(uint8_t index) const;
+
+private:
+    void write(uint8_t index, double value);
+
+    const ParamDef *_table;
+    uint8_t _count;
+
+    uint8_t _batchIndex[PARAM_MAX_BATCH];
+    double _batchValue[PARAM_MAX_BATCH];
+    uint8_t _batchCount;
+    volatile bool _pending;
+};
+
+#endif // PARAM_REGISTRY_H
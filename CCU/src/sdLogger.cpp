@@ -1,5 +1,17 @@
 #include "sdLogger.h"
 
+// String() has no 64 bit overload
+static String u64ToString(uint64_t value) {
+    char buffer[21];
+    char *p = buffer + sizeof(buffer) - 1;
+    *p = '\0';
+    do {
+        *--p = '0' + value % 10;
+        value /= 10;
+    } while (value);
+    return String(p);
+}
+
 SDLogger::SDLogger(void) {
 }
 
@@ -56,7 +68,17 @@ void SDLogger::addData(const dataBlock& data) {
             String(data.updated_yaw) + ", " +
             String(data.updated_velocity) + ", " +
             String(data.omega_yaw, 5U) + ", " +
-            String(data.omega_move, 5U);
+            String(data.omega_move, 5U) + ", " +
+            String(data.odo_velocity, 3U) + ", " +
+            String(data.odo_yaw_rate) + ", " +
+            String(data.odo_radius, 3U) + ", " +
+            String(data.odo_slip, 3U) + ", " +
+            String(data.pose_x, 3U) + ", " +
+            String(data.pose_y, 3U) + ", " +
+            String(data.pose_heading, 3U) + ", " +
+            String(data.dt, 6U) + ", " +
+            u64ToString(data.sensor_time_us) + ", " +
+            String(data.mcu_us);
         _dataFile.println(line);
         //Serial.println(line);
     }else{
@@ -70,3 +92,28 @@ void SDLogger::close() {
         _fileOpen = false;
     }
 }
+
+size_t packDataBlock(const dataBlock& data, uint8_t* buffer) {
+    const float values[DATABLOCK_PACKED_FLOATS] = {
+        data.setpoint, data.setpoint_radius,
+        data.acc_x, data.acc_y, data.gyro_z,
+        data.actual_velocity,
+        data.Kp, data.Ki, data.Kd,
+        (float)data.MU0.setpoint_recv, (float)data.MU0.value_recv, (float)data.MU0.current_recv,
+        (float)data.MU1.setpoint_recv, (float)data.MU1.value_recv, (float)data.MU1.current_recv,
+        (float)data.MU2.setpoint_recv, (float)data.MU2.value_recv, (float)data.MU2.current_recv,
+        (float)data.MU3.setpoint_recv, (float)data.MU3.value_recv, (float)data.MU3.current_recv,
+        data.error_yaw, data.error_velocity, data.updated_yaw, data.updated_velocity,
+        data.omega_yaw, data.omega_move,
+        data.odo_velocity, data.odo_yaw_rate, data.odo_radius, data.odo_slip,
+        data.pose_x, data.pose_y, data.pose_heading,
+        data.dt
+    };
+    const uint32_t timestamp = data.timestamp;
+    memcpy(buffer, &timestamp, 4); // RA4M1 is little endian, as the frame
+    buffer[4] = data.mode;
+    memcpy(buffer + 5, values, sizeof(values));
+    memcpy(buffer + 5 + sizeof(values), &data.sensor_time_us, 8);
+    memcpy(buffer + 5 + sizeof(values) + 8, &data.mcu_us, 4);
+    return DATABLOCK_PACKED_SIZE;
+}
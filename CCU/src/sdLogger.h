@@ -35,8 +35,27 @@ struct dataBlock {
 
     float omega_yaw;
     float omega_move;
+
+    float odo_velocity;         // Wheel odometry speed (m/s)
+    float odo_yaw_rate;         // Wheel odometry yaw rate (deg/s)
+    float odo_radius;           // Wheel odometry turn radius (m), 0 when straight
+    float odo_slip;             // Largest wheel residual (m/s)
+    float pose_x;               // Dead-reckoned pose (m)
+    float pose_y;
+    float pose_heading;         // (rad)
+
+    float dt;                   // Time since the previous sample from the sensor clock (s)
+    uint64_t sensor_time_us;    // BMX160 clock at the sample (us)
+    uint32_t mcu_us;            // micros() right after the IMU read, pairs the two clocks
 };
 
+// Packed little endian dataBlock for telemetry: uint32 timestamp, uint8 mode, then the fields
+// up to dt as float32 in the column order of the CSV header (MU values narrowed to float),
+// then uint64 sensor_time_us and uint32 mcu_us
+#define DATABLOCK_PACKED_FLOATS 35
+#define DATABLOCK_PACKED_SIZE (4 + 1 + 4 * DATABLOCK_PACKED_FLOATS + 8 + 4)
+size_t packDataBlock(const dataBlock& data, uint8_t* buffer);
+
 class SDLogger {
 public:
     SDLogger(void);
@@ -47,7 +66,7 @@ private:
     File _dataFile;
     const char* _filename;
     bool _fileOpen = false;
-    String _dataHeader = ("timestamp, mode, setpoint, setpoint_radius, acc_x, acc_y, gyro_z, actual_velocity, Kp, Ki, Kd, MU0setpoint, MU0value, MU0current, MU1setpoint, MU1value, MU1current, MU2setpoint, MU2value, MU2current, MU3setpoint, MU3value, MU3current, error_yaw, error_velocity, updated_yaw, updated_velocity, omega_yaw, omega_move");
+    String _dataHeader = ("timestamp, mode, setpoint, setpoint_radius, acc_x, acc_y, gyro_z, actual_velocity, Kp, Ki, Kd, MU0setpoint, MU0value, MU0current, MU1setpoint, MU1value, MU1current, MU2setpoint, MU2value, MU2current, MU3setpoint, MU3value, MU3current, error_yaw, error_velocity, updated_yaw, updated_velocity, omega_yaw, omega_move, odo_velocity, odo_yaw_rate, odo_radius, odo_slip, pose_x, pose_y, pose_heading, dt, sensor_time_us, mcu_us");
 };
 
 #endif
\ No newline at end of file
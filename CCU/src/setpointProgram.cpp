@@ -0,0 +1,174 @@
+#include "setpointProgram.h"
+
+SetpointProgram::SetpointProgram() {
+}
+
+void SetpointProgram::clear() {
+    _count = 0;
+    _index = 0;
+}
+
+bool SetpointProgram::addSegment(const char *line) {
+    if (_count >= PROGRAM_MAX_SEGMENTS) {
+        return false;
+    }
+
+    ProgramSegment segment;
+    if (strncmp(line, "STEP,", 5) == 0) {
+        segment.shape = SEGMENT_STEP;
+    } else if (strncmp(line, "RAMP,", 5) == 0) {
+        segment.shape = SEGMENT_RAMP;
+    } else if (strncmp(line, "CHIRP,", 6) == 0) {
+        segment.shape = SEGMENT_CHIRP;
+    } else {
+        return false;
+    }
+
+    float values[7] = {0, 0, 0, 0, 0, 0, 0}; // duration, speed, radius, yaw_rate, amplitude, f0, f1
+    int count = 0;
+    const char *p = strchr(line, ',') + 1;
+    char *end = const_cast<char *>(p);
+    while (count < 7) {
+        values[count] = strtod(p, &end);
+        if (end == p) {
+            return false;
+        }
+        count++;
+        while (*end == ' ') end++;
+        if (*end != ',') {
+            break;
+        }
+        p = end + 1;
+    }
+    while (*end == ' ' || *end == '\r' || *end == '\n') end++;
+    if (*end != '\0' || count < 4 || values[0] <= 0) {
+        return false;
+    }
+    if (segment.shape == SEGMENT_CHIRP && count < 7) {
+        return false;
+    }
+
+    segment.duration = values[0];
+    segment.speed = values[1];
+    segment.radius = values[2];
+    segment.yaw_rate = values[3];
+    segment.amplitude = values[4];
+    segment.f0 = values[5];
+    segment.f1 = values[6];
+    _segments[_count++] = segment;
+    return true;
+}
+
+bool SetpointProgram::loadFile(const char *filename) {
+    File file = SD.open(filename, FILE_READ);
+    if (!file) {
+        Serial.print("No program file ");
+        Serial.println(filename);
+        return false;
+    }
+
+    clear();
+    bool ok = true;
+    char line[96];
+    while (file.available()) {
+        size_t length = file.readBytesUntil('\n', line, sizeof(line) - 1);
+        line[length] = '\0';
+        if (length == 0 || line[0] == '#' || line[0] == '\r') {
+            continue;
+        }
+        if (!addSegment(line)) {
+            Serial.print("Invalid program line: ");
+            Serial.println(line);
+            ok = false;
+            break;
+        }
+    }
+    file.close();
+    if (!ok) {
+        clear();
+    }
+    return ok && _count > 0;
+}
+
+float SetpointProgram::duration() {
+    float total = 0;
+    for (uint8_t i = 0; i < _count; i++) {
+        total += _segments[i].duration;
+    }
+    return total;
+}
+
+void SetpointProgram::setLimits(float max_accel, float max_jerk) {
+    if (max_accel > 0) _max_accel = max_accel;
+    if (max_jerk > 0) _max_jerk = max_jerk;
+}
+
+bool SetpointProgram::usesYawRate() {
+    for (uint8_t i = 0; i < _count; i++) {
+        if (_segments[i].radius == 0 && _segments[i].yaw_rate != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SetpointProgram::start(float initial_speed) {
+    _index = 0;
+    _segment_time = 0;
+    _start_speed = initial_speed;
+    _speed = initial_speed;
+    _accel = 0;
+}
+
+float SetpointProgram::segmentSpeed(const ProgramSegment &segment, float t) {
+    switch (segment.shape) {
+        case SEGMENT_RAMP:
+            return _start_speed + (segment.speed - _start_speed) * (t / segment.duration);
+        case SEGMENT_CHIRP: {
+            // Phase of a linear sweep: 2 pi (f0 t + (f1 - f0) t² / (2 T))
+            float phase = 2 * PI * (segment.f0 * t + (segment.f1 - segment.f0) * t * t / (2 * segment.duration));
+            return segment.speed + segment.amplitude * sin(phase);
+        }
+        default:
+            return segment.speed;
+    }
+}
+
+bool SetpointProgram::update(float dt, float &speed, float &radius) {
+    if (_index >= _count) {
+        return false;
+    }
+
+    const ProgramSegment &segment = _segments[_index];
+    float target = segmentSpeed(segment, _segment_time);
+
+    // Jerk limited tracking: accelerate towards the target, but never faster than what
+    // can still be braked to zero acceleration at the target with the jerk limit
+    float error = target - _speed;
+    if (fabs(error) < _max_jerk * dt * dt && fabs(_accel) <= _max_jerk * dt) {
+        _speed = target; // Settled, snapping is within one jerk step and avoids chattering
+        _accel = 0;
+        error = 0;
+    }
+    float stop_accel = sqrt(2 * _max_jerk * fabs(error));
+    float wanted_accel = constrain(error >= 0 ? stop_accel : -stop_accel, -_max_accel, _max_accel);
+    _accel += constrain(wanted_accel - _accel, -_max_jerk * dt, _max_jerk * dt);
+    _speed += _accel * dt;
+
+    speed = _speed;
+    if (segment.radius != 0) {
+        radius = segment.radius;
+    } else if (segment.yaw_rate != 0 && _mps_per_unit != 0) {
+        radius = _speed * _mps_per_unit / (segment.yaw_rate * DEG_TO_RAD); // Same yaw rate at every speed
+    } else {
+        radius = 0;
+    }
+
+    _segment_time += dt;
+    if (_segment_time >= segment.duration) {
+        _segment_time = 0;
+        _start_speed = (segment.shape == SEGMENT_CHIRP) ? segment.speed : segmentSpeed(segment, segment.duration);
+        _index++;
+    }
+    return true;
+}
@@ -0,0 +1,88 @@
+#ifndef SETPOINT_PROGRAM_H
+#define SETPOINT_PROGRAM_H
+
+#include <Arduino.h>
+#include <SD.h>
+
+#define PROGRAM_MAX_SEGMENTS 32
+#define PROGRAM_MAX_ACCEL 2.0   // Setpoint units/s², default limit of the jerk limited interpolation
+#define PROGRAM_MAX_JERK 10.0   // Setpoint units/s³
+
+enum SegmentShape : uint8_t {
+    SEGMENT_STEP,   // Jump to speed at the segment start
+    SEGMENT_RAMP,   // Linear from the previous speed to speed over the duration
+    SEGMENT_CHIRP   // speed + amplitude * sin, frequency swept linearly from f0 to f1
+};
+
+struct ProgramSegment {
+    uint8_t shape;      // SegmentShape
+    float duration;     // s
+    float speed;        // Setpoint units of the mode (m/s, torque or RPM)
+    float radius;       // m, 0 to use yaw_rate
+    float yaw_rate;     // deg/s, used when radius is 0, both 0 is straight
+    float amplitude;    // Chirp amplitude (setpoint units)
+    float f0;           // Chirp start frequency (Hz)
+    float f1;           // Chirp end frequency (Hz)
+};
+
+/**
+ * @brief Timed setpoint program executed at the control rate.
+ *
+ * Segments are kept in a fixed buffer and run back to back from START. The speed is
+ * passed through a jerk limited interpolation, so steps become smooth S-curves and every
+ * run of a program is excited the same way. The limits are in the setpoint units of the
+ * mode, setLimits() scales them to it (a m/s² limit is far too slow for RPM).
+ *
+ * Segment line format (PROG_ADD: command and SD program files, '#' starts a comment):
+ *   STEP|RAMP|CHIRP,duration,speed,radius,yaw_rate[,amplitude,f0,f1]
+ */
+class SetpointProgram {
+public:
+    SetpointProgram();
+
+    void clear();
+    /// @brief Parse and append one segment line, false if malformed or the buffer is full
+    bool addSegment(const char *line);
+    /// @brief Replace the program with the segment lines of an SD file, false on any error
+    bool loadFile(const char *filename);
+
+    /// @brief Acceleration (units/s²) and jerk (units/s³) limits, non-positive values are ignored
+    void setLimits(float max_accel, float max_jerk);
+    /// @brief m/s per setpoint unit for the yaw_rate segments, 0 when the setpoint is no speed
+    void setSpeedScale(float mps_per_unit) { _mps_per_unit = mps_per_unit; }
+    /// @brief True if a segment turns by yaw_rate, which needs a speed scale
+    bool usesYawRate();
+
+    /// @brief Restart the program, the interpolation starts from initial_speed
+    void start(float initial_speed);
+    /**
+     * @brief Advance by one sample.
+     * 
+     * @param dt Sample time (s).
+     * @param speed Output speed setpoint.
+     * @param radius Output radius setpoint (m), 0 when driving straight.
+     * @return false when the program has finished (outputs are left unchanged).
+     */
+    bool update(float dt, float &speed, float &radius);
+
+    uint8_t size() { return _count; }
+    float duration();
+    bool isFinished() { return _index >= _count; }
+
+private:
+    float segmentSpeed(const ProgramSegment &segment, float t);
+
+    ProgramSegment _segments[PROGRAM_MAX_SEGMENTS];
+    uint8_t _count = 0;
+
+    uint8_t _index = 0;         // Running segment
+    float _segment_time = 0;    // Time in the running segment (s)
+    float _start_speed = 0;     // Speed at the start of the running segment (ramp start)
+    float _speed = 0;           // Jerk limited speed
+    float _accel = 0;           // Jerk limited acceleration
+    float _max_accel = PROGRAM_MAX_ACCEL;   // Setpoint units/s²
+    float _max_jerk = PROGRAM_MAX_JERK;     // Setpoint units/s³
+    float _mps_per_unit = 1;                // m/s per setpoint unit
+};
+
+#endif // SETPOINT_PROGRAM_H
@@ -1,11 +1,105 @@
 #include "torqueControl.h"
 
-TorqueControl::TorqueControl() {}
+TorqueControl::TorqueControl() {
+    clearMaps();
+}
 
-void TorqueControl::calculateCurrents(float velocity, Currents &currents) {
+float TorqueControl::linearCurrent(float velocity) {
     // Beregning af strøm baseret på lineære funktioner givet af brugeren
-    currents.current_left_front  = (0.4482 * velocity + 0.8415)/4; //(0.038 * velocity + 0.219)/2; // 0.027 * velocity + 0.181;  // MU0
-    currents.current_right_front = currents.current_left_front;
-    currents.current_left_rear   = currents.current_left_front;
-    currents.current_right_rear  = currents.current_left_front;
+    return (0.4482 * velocity + 0.8415)/4; //(0.038 * velocity + 0.219)/2; // 0.027 * velocity + 0.181;  // MU0
+}
+
+float TorqueControl::lookup(const CurrentMap &map, float velocity) {
+    float position = (velocity - map.v_min) * map.inv_step;
+    if (position <= 0) {
+        return map.current[0];
+    }
+    int index = (int)position;
+    if (index >= map.count - 1) {
+        return map.current[map.count - 1];
+    }
+    float fraction = position - index;
+    return map.current[index] + fraction * (map.current[index + 1] - map.current[index]);
+}
+
+void TorqueControl::calculateCurrents(float velocity, Currents &currents) {
+    float linear = linearCurrent(velocity);
+    currents.current_left_front  = hasMap(0) ? lookup(_maps[0], velocity) : linear;
+    currents.current_right_front = hasMap(1) ? lookup(_maps[1], velocity) : linear;
+    currents.current_left_rear   = hasMap(2) ? lookup(_maps[2], velocity) : linear;
+    currents.current_right_rear  = hasMap(3) ? lookup(_maps[3], velocity) : linear;
+}
+
+bool TorqueControl::setMap(const char *line) {
+    char *end;
+    long wheel = strtol(line, &end, 10);
+    if (end == line || *end != ',' || wheel < 0 || wheel > 3) {
+        return false;
+    }
+
+    float values[TORQUE_MAP_POINTS + 2]; // v_min, v_max, currents
+    int count = 0;
+    const char *p = end + 1;
+    while (count < TORQUE_MAP_POINTS + 2) {
+        values[count] = strtod(p, &end);
+        if (end == p) {
+            return false;
+        }
+        count++;
+        while (*end == ' ') end++;
+        if (*end != ',') {
+            break;
+        }
+        p = end + 1;
+    }
+    while (*end == ' ' || *end == '\r' || *end == '\n') end++;
+    int points = count - 2;
+    if (*end != '\0' || points < 2 || values[1] <= values[0]) {
+        return false;
+    }
+
+    CurrentMap &map = _maps[wheel];
+    map.v_min = values[0];
+    map.count = points;
+    for (int i = 0; i < points; i++) {
+        map.current[i] = values[i + 2];
+    }
+    map.inv_step = (points - 1) / (values[1] - values[0]);
+    return true;
+}
+
+int TorqueControl::loadMaps() {
+    File file = SD.open(TORQUE_MAP_FILE, FILE_READ);
+    if (!file) {
+        Serial.println("No torque map " TORQUE_MAP_FILE ", using linear fit");
+        return 0;
+    }
+
+    int loaded = 0;
+    char line[200];
+    while (file.available()) {
+        size_t length = file.readBytesUntil('\n', line, sizeof(line) - 1);
+        line[length] = '\0';
+        if (length == 0 || line[0] == '#') {
+            continue;
+        }
+        if (setMap(line)) {
+            loaded++;
+        } else {
+            Serial.print("Invalid torque map line: ");
+            Serial.println(line);
+        }
+    }
+    file.close();
+    Serial.print("Torque maps loaded: ");
+    Serial.println(loaded);
+    return loaded;
+}
+
+void TorqueControl::clearMaps() {
+    for (int i = 0; i < 4; i++) {
+        _maps[i].v_min = 0;
+        _maps[i].inv_step = 0;
+        _maps[i].count = 0;
+    }
 }
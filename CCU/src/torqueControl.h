@@ -2,6 +2,10 @@
 #define TORQUE_CONTROL_H
 
 #include <Arduino.h>
+#include <SD.h>
+
+#define TORQUE_MAP_POINTS 16          // Max breakpoints per wheel
+#define TORQUE_MAP_FILE "TQMAP.TXT"   // One map line per wheel, written by Torque-Measurements/fit_current_map.py
 
 struct Currents {
     float current_left_front;
@@ -10,10 +14,42 @@ struct Currents {
     float current_right_rear;
 };
 
+// Speed -> current map of one wheel, breakpoints uniformly spaced from v_min to v_max
+struct CurrentMap {
+    float v_min;
+    float inv_step;                     // 1 / breakpoint spacing, 0 if the map is not loaded
+    uint8_t count;
+    float current[TORQUE_MAP_POINTS];
+};
+
+/**
+ * @brief Current setpoint of each wheel for a driving speed.
+ *
+ * Each wheel (MU order: left front, right front, left rear, right rear) has its own
+ * piecewise-linear map fitted from logged MU currents. The bins are uniform, so the lookup
+ * is one multiply and one interpolation. Speeds outside the map use the end points.
+ * Wheels without a map use the shared linear fit.
+ *
+ * Map line format (SD file and TQMAP: command): wheel,v_min,v_max,c0,c1,...,cN-1
+ */
 class TorqueControl {
 public:
     TorqueControl();
     void calculateCurrents(float velocity, Currents &currents);
+
+    /// @brief Parse and install one map line, false if malformed (the old map is kept)
+    bool setMap(const char *line);
+    /// @brief Install the map lines of TORQUE_MAP_FILE, returns the number of wheels loaded
+    int loadMaps();
+    /// @brief Forget all maps, back to the shared linear fit
+    void clearMaps();
+    bool hasMap(uint8_t wheel) { return wheel < 4 && _maps[wheel].inv_step > 0; }
+
+private:
+    float lookup(const CurrentMap &map, float velocity);
+    float linearCurrent(float velocity);
+
+    CurrentMap _maps[4];
 };
 
 #endif // TORQUE_CONTROL_H
@@ -0,0 +1,172 @@
+"""
+Receive the CCU's UDP telemetry and report loss, reordering and latency.
+
+Datagram (little endian), see WiFiHandler::sendUDP() and packDataBlock():
+
+    uint16 magic 0x5443 | uint8 version | uint8 payload length | uint32 sequence | uint32 send time (us)
+    payload: uint32 timestamp (ms) | uint8 mode | 35 x float32 in the CSV column order (up to dt)
+             | uint64 sensor_time_us | uint32 mcu_us
+
+The CCU and this PC have no common clock. The one-way latency is therefore reported
+relative to the fastest datagram of the run (offset = min(receive - send)), which shows
+the queueing and retransmit delays on top of the best case. The CCU side delay from the
+sample in timerISR() (mcu_us, right after the IMU read) to the send in loop() is exact,
+both use the CCU clock.
+
+Usage:
+    python udp_telemetry.py --port 4243                       # then send UDP_SUB:<pc ip>,4243
+    python udp_telemetry.py --port 4243 --ccu 192.168.137.249 # registers itself over TCP
+    python udp_telemetry.py --port 4243 --csv run.csv --duration 30
+"""
+
+import argparse
+import csv
+import socket
+import struct
+import time
+
+MAGIC = 0x5443
+VERSION = 2         # UDP_TELEMETRY_VERSION in wifihandler.h
+HEADER = struct.Struct('<HBBII')
+PAYLOAD = struct.Struct('<IB35fQI')
+TCP_PORT = 4242
+COLUMNS = ("timestamp, mode, setpoint, setpoint_radius, acc_x, acc_y, gyro_z, actual_velocity, Kp, Ki, Kd, "
+           "MU0setpoint, MU0value, MU0current, MU1setpoint, MU1value, MU1current, MU2setpoint, MU2value, "
+           "MU2current, MU3setpoint, MU3value, MU3current, error_yaw, error_velocity, updated_yaw, "
+           "updated_velocity, omega_yaw, omega_move, odo_velocity, odo_yaw_rate, odo_radius, odo_slip, "
+           "pose_x, pose_y, pose_heading, dt, sensor_time_us, mcu_us").split(', ')
+
+
+def local_ip_towards(host):
+    """Address of the interface that routes to host."""
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as s:
+        s.connect((host, TCP_PORT))
+        return s.getsockname()[0]
+
+
+def subscribe(ccu, port):
+    """Send UDP_SUB over TCP, works when no other control client is connected."""
+    with socket.create_connection((ccu, TCP_PORT), timeout=5) as tcp:
+        tcp.sendall(f"UDP_SUB:{local_ip_towards(ccu)},{port}\n".encode())
+        try:
+            reply = tcp.recv(64).decode().strip()
+        except socket.timeout:
+            # Connected as a read-only subscriber, the control client has to send UDP_SUB
+            print("No reply, another control client is connected.")
+            return False
+        print(f"CCU: {reply}")
+        return reply.startswith("ACK:")
+
+
+def histogram(values_ms, edges):
+    counts = [0] * (len(edges) + 1)
+    for v in values_ms:
+        k = 0
+        while k < len(edges) and v >= edges[k]:
+            k += 1
+        counts[k] += 1
+    labels = [f"< {edges[0]} ms"] + [f"{edges[k]}-{edges[k + 1]} ms" for k in range(len(edges) - 1)]
+    labels.append(f">= {edges[-1]} ms")
+    return list(zip(labels, counts))
+
+
+def print_histogram(title, values_ms, edges):
+    if not values_ms:
+        return
+    values = sorted(values_ms)
+    print(f"\n{title}: median {values[len(values) // 2]:.2f} ms, "
+          f"p99 {values[int(len(values) * 0.99)]:.2f} ms, max {values[-1]:.2f} ms")
+    for label, count in histogram(values, edges):
+        bar = '#' * int(50 * count / len(values))
+        print(f"  {label:>12} {count:7d} {bar}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="CCU UDP telemetry receiver")
+    parser.add_argument('--port', type=int, default=4243, help="Local UDP port")
+    parser.add_argument('--ccu', help="CCU address, send UDP_SUB over TCP before receiving")
+    parser.add_argument('--duration', type=float, default=0, help="Stop after this many seconds (0: Ctrl+C)")
+    parser.add_argument('--csv', help="Write the decoded samples to this file")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(('', args.port))
+    sock.settimeout(0.5)
+    if args.ccu and not subscribe(args.ccu, args.port):
+        return
+
+    writer = None
+    csv_file = None
+    if args.csv:
+        csv_file = open(args.csv, 'w', newline='')
+        writer = csv.writer(csv_file)
+        writer.writerow(['sequence', 'send_us', 'receive_s'] + COLUMNS)
+
+    received = set()
+    first_seq = None
+    highest_seq = -1
+    reordered = duplicates = malformed = 0
+    transit = []        # receive - send in ms, PC clock minus CCU clock
+    ccu_delay = []      # send - sample time on the CCU in ms
+    last_send_us = None # send_us unwrapped over the 32 bit micros() of the CCU
+    start = time.monotonic()
+
+    print(f"Listening on UDP port {args.port}...")
+    try:
+        while not args.duration or time.monotonic() - start < args.duration:
+            try:
+                data, _ = sock.recvfrom(512)
+            except socket.timeout:
+                continue
+            receive = time.monotonic()
+            if len(data) < HEADER.size:
+                malformed += 1
+                continue
+            magic, version, length, seq, send_us = HEADER.unpack_from(data)
+            if magic != MAGIC or version != VERSION or length != PAYLOAD.size or len(data) != HEADER.size + length:
+                malformed += 1
+                continue
+            sample = PAYLOAD.unpack_from(data, HEADER.size)
+
+            if first_seq is None or seq < first_seq:
+                first_seq = seq
+            if seq in received:
+                duplicates += 1
+                continue
+            received.add(seq)
+            if seq < highest_seq:
+                reordered += 1
+            highest_seq = max(highest_seq, seq)
+
+            # micros() wraps after 71 min, the signed step from the last datagram also takes reordering
+            if last_send_us is None:
+                last_send_us = send_us
+            else:
+                last_send_us += (send_us - last_send_us + (1 << 31)) % (1 << 32) - (1 << 31)
+            transit.append(receive * 1000.0 - last_send_us / 1000.0)
+            ccu_delay.append(((send_us - sample[-1]) % (1 << 32)) / 1000.0)  # micros() wraps after 71 min
+            if writer:
+                writer.writerow([seq, send_us, f"{receive - start:.6f}"] + [v if isinstance(v, int) else f"{v:.6g}" for v in sample])
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if csv_file:
+            csv_file.close()
+
+    if not received:
+        print("No datagrams received.")
+        return
+
+    expected = highest_seq - first_seq + 1
+    lost = expected - len(received)
+    print(f"\nDatagrams: {len(received)} received, {expected} sent in range {first_seq}..{highest_seq}")
+    print(f"Lost: {lost} ({100.0 * lost / expected:.2f} %), reordered: {reordered}, "
+          f"duplicates: {duplicates}, malformed: {malformed}")
+
+    offset = min(transit)
+    print_histogram("Latency above the fastest datagram", [t - offset for t in transit], [1, 2, 5, 10, 20, 50, 100])
+    print_histogram("CCU sample to send", ccu_delay, [1, 2, 5, 10, 14, 20])
+
+
+if __name__ == '__main__':
+    main()
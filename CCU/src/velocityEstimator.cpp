@@ -0,0 +1,43 @@
+#include "velocityEstimator.h"
+
+static const control_scalar_t rad_to_deg = 180.0 / PI;
+
+VelocityEstimator::VelocityEstimator(control_scalar_t sampleTime, control_scalar_t wheel_gain,
+                                     control_scalar_t yaw_gain, control_scalar_t leak_time)
+    : sampleTime_(sampleTime), wheel_gain_(wheel_gain), yaw_gain_(yaw_gain),
+      leak_time_(leak_time) {}
+
+void VelocityEstimator::update(control_scalar_t accel_forward, control_scalar_t gyro_z,
+                               const Velocities_acker &wheel_speeds, bool wheels_valid, control_scalar_t dt) {
+    unsigned long start = micros();
+
+    if (dt <= 0) dt = sampleTime_;
+    velocity_ += accel_forward * dt;
+    if (wheels_valid) {
+        control_scalar_t wheel_velocity = (wheel_speeds.v_left_rear + wheel_speeds.v_right_rear) / 2;
+        control_scalar_t wheel_yaw_rate = (wheel_speeds.v_right_rear - wheel_speeds.v_left_rear)
+                                        / static_cast<control_scalar_t>(d_track) * rad_to_deg;
+        velocity_ += wheel_gain_ * (wheel_velocity - velocity_);
+        if (fabs(wheel_yaw_rate) < STRAIGHT_YAW_RATE && fabs(gyro_z - gyro_offset_) < STRAIGHT_YAW_RATE) {
+            // Only trust the wheel yaw rate when wheels and gyro agree on driving straight,
+            // in turns the wheels slip and the quantised MU speeds are too coarse
+            gyro_offset_ += yaw_gain_ * ((gyro_z - wheel_yaw_rate) - gyro_offset_);
+        }
+    } else {
+        velocity_ -= dt / leak_time_ * velocity_;
+    }
+    yaw_rate_ = gyro_z - gyro_offset_;
+
+    last_micros_ = micros() - start;
+    if (last_micros_ > max_micros_) {
+        max_micros_ = last_micros_;
+    }
+}
+
+void VelocityEstimator::reset() {
+    velocity_ = 0;
+    yaw_rate_ = 0;
+    gyro_offset_ = 0;
+    last_micros_ = 0;
+    max_micros_ = 0;
+}
@@ -0,0 +1,62 @@
+#ifndef VELOCITY_ESTIMATOR_H
+#define VELOCITY_ESTIMATOR_H
+
+#include <Arduino.h>
+#include "controlScalar.h"
+#include "kinematic.h"
+
+/**
+ * @brief Planar velocity and yaw rate estimate from wheel speeds, gyro and accelerometer.
+ *
+ * Complementary filter with a fixed amount of work per tick:
+ * - Velocity: the forward acceleration is integrated and corrected towards the wheel speed
+ *   (mean of the rear wheels, which is the rear axle speed under Ackermann). Without wheel
+ *   speeds (torque modes) the integral leaks towards 0 so the drift stays bounded.
+ * - Yaw rate: the gyro is used directly, its slowly varying offset against the rear wheel
+ *   speed difference is estimated and removed while wheels and gyro agree on driving straight.
+ */
+class VelocityEstimator {
+public:
+    static constexpr control_scalar_t STRAIGHT_YAW_RATE = 10; // deg/s, yaw rate counted as straight
+
+    /// @param sampleTime Sample time (s)
+    /// @param wheel_gain Fraction of the velocity error to the wheel speed corrected per tick
+    /// @param yaw_gain Fraction of the gyro / wheel yaw rate difference tracked per tick
+    /// @param leak_time Time constant (s) of the velocity decay without wheel speeds
+    VelocityEstimator(control_scalar_t sampleTime, control_scalar_t wheel_gain = 0.1,
+                      control_scalar_t yaw_gain = 0.01, control_scalar_t leak_time = 2.0);
+
+    /**
+     * @brief Update the estimate with one sample.
+     *
+     * @param accel_forward Acceleration along the driving direction (m/s²)
+     * @param gyro_z Yaw rate from the gyro (deg/s)
+     * @param wheel_speeds Wheel speeds (m/s) in MU order: left front, right front, left rear, right rear
+     * @param wheels_valid False if the MUs do not report a speed (torque control)
+     * @param dt Time since the previous sample (s), e.g. from the sensor clock, 0 for the nominal sample time
+     */
+    void update(control_scalar_t accel_forward, control_scalar_t gyro_z,
+                const Velocities_acker &wheel_speeds, bool wheels_valid, control_scalar_t dt = 0);
+    void reset();
+
+    control_scalar_t getVelocity() { return velocity_; }         // m/s
+    control_scalar_t getYawRate() { return yaw_rate_; }          // deg/s
+    control_scalar_t getGyroOffset() { return gyro_offset_; }    // deg/s
+    unsigned long getLastMicros() { return last_micros_; }       // Cost of the last update
+    unsigned long getMaxMicros() { return max_micros_; }         // Worst update since reset
+
+private:
+    control_scalar_t sampleTime_;
+    control_scalar_t wheel_gain_;
+    control_scalar_t yaw_gain_;
+    control_scalar_t leak_time_;
+
+    control_scalar_t velocity_ = 0;
+    control_scalar_t yaw_rate_ = 0;
+    control_scalar_t gyro_offset_ = 0;
+
+    unsigned long last_micros_ = 0;
+    unsigned long max_micros_ = 0;
+};
+
+#endif // VELOCITY_ESTIMATOR_H
@@ -84,6 +84,10 @@ def send_ico():
     except ValueError:
         print("Error: Invalid input for ICO parameters")
 
+def send_ico_warm():
+    """Enable or disable ICO warm start from the SD snapshot."""
+    send_command(f"ICO_WARM:{ico_warm.get()}")
+
 # Function to send only the setpoint
 def send_setpoint_only():
     """Send only the setpoint to the Arduino (keep PID parameters unchanged)."""
@@ -263,6 +267,17 @@ button_start.grid(row=11, column=0, padx=10, pady=5, sticky="w")
 button_stop = tk.Button(root, text="Stop", command=stop_logging)
 button_stop.grid(row=12, column=0, padx=10, pady=5, sticky="w")
 
+# UI elements for ICO snapshots (keyed by mode and setpoint on the car)
+button_ico_save = tk.Button(root, text="Save ICO", command=lambda: send_command("ICO_SAVE"))
+button_ico_save.grid(row=13, column=0, padx=10, pady=5, sticky="w")
+
+button_ico_load = tk.Button(root, text="Load ICO", command=lambda: send_command("ICO_LOAD"))
+button_ico_load.grid(row=13, column=1, padx=10, pady=5, sticky="w")
+
+ico_warm = tk.IntVar(value=0)
+check_ico_warm = tk.Checkbutton(root, text="ICO warm start", variable=ico_warm, command=send_ico_warm)
+check_ico_warm.grid(row=14, column=0, columnspan=2, padx=10, pady=5, sticky="w")
+
 
 
 # Text box for logging
@@ -2,7 +2,17 @@
 
 // Constructor
 WiFiHandler::WiFiHandler(const char* ssid, const char* password, int tcpPort)
-    : ssid(ssid), password(password), tcpPort(tcpPort), server(tcpPort) {}
+    : ssid(ssid), password(password), tcpPort(tcpPort), server(tcpPort), serverStarted(false),
+      connectAttempted(false), lastAttempt(0), controlSlot(-1), controlLost(false),
+      udpPort(0), udpSequence(0), udpErrors(0) {
+    for (int i = 0; i < WIFI_MAX_CLIENTS; i++) {
+        slots[i].used = false;
+        slots[i].control = false;
+        slots[i].head = 0;
+        slots[i].count = 0;
+        slots[i].dropped = 0;
+    }
+}
 
 // Connect to Wi-Fi
 void WiFiHandler::connectToWiFi() {
@@ -28,10 +38,189 @@ void WiFiHandler::connectToWiFi() {
 // Start the TCP server
 void WiFiHandler::startTCPServer() {
     server.begin();
+    udp.begin(tcpPort); // Local port of the telemetry datagrams
+    serverStarted = true;
     Serial.println("TCP Server is listening...");
 }
 
-// Check for client connections
-WiFiClient WiFiHandler::acceptClient() {
-    return server.available();
-}
\ No newline at end of file
+bool WiFiHandler::pollConnect() {
+    if (serverStarted) return true;
+
+    if (WiFi.status() == WL_CONNECTED) {
+        Serial.println("\nConnected to WiFi!");
+        Serial.print("IP Address: ");
+        Serial.println(WiFi.localIP());
+        startTCPServer();
+        return true;
+    }
+    if (connectAttempted && millis() - lastAttempt < WIFI_RETRY_MS) return false;
+
+    connectAttempted = true;
+    lastAttempt = millis();
+    Serial.println("Connecting to WiFi...");
+    if (WiFi.begin(ssid, password) != WL_CONNECTED) {
+        Serial.println("WiFi not connected, retrying later.");
+    }
+    return false;
+}
+
+void WiFiHandler::poll() {
+    acceptClients();
+
+    for (int i = 0; i < WIFI_MAX_CLIENTS; i++) {
+        ClientSlot &slot = slots[i];
+        if (!slot.used) continue;
+
+        if (!slot.client.connected()) {
+            closeSlot(i);
+            continue;
+        }
+        if (slot.control) continue; // The caller reads and answers the control client
+
+        // Subscribers are read-only, discard what they send so their receive buffer never fills
+        uint8_t discard[16];
+        while (slot.client.available()) {
+            slot.client.read(discard, sizeof(discard));
+        }
+        sendQueued(slot);
+    }
+}
+
+void WiFiHandler::acceptClients() {
+    WiFiClient newClient = server.accept();
+    if (!newClient) return;
+
+    for (int i = 0; i < WIFI_MAX_CLIENTS; i++) {
+        ClientSlot &slot = slots[i];
+        if (slot.used) continue;
+
+        slot.client = newClient;
+        slot.used = true;
+        slot.control = (controlSlot < 0);
+        slot.head = 0;
+        slot.count = 0;
+        slot.dropped = 0;
+        if (slot.control) {
+            controlSlot = i;
+            Serial.println("Client connected!");
+        } else {
+            Serial.print("Subscriber connected: ");
+            Serial.println(newClient.remoteIP());
+        }
+        return;
+    }
+
+    Serial.println("No free client slot, connection refused.");
+    newClient.stop();
+}
+
+void WiFiHandler::sendQueued(ClientSlot &slot) {
+    // At most WIFI_SEND_BUDGET bytes, in up to two writes when the queue wraps
+    uint16_t budget = WIFI_SEND_BUDGET;
+    while (slot.count > 0 && budget > 0) {
+        uint16_t length = WIFI_TX_QUEUE - slot.head; // Up to the end of the ring
+        if (length > slot.count) length = slot.count;
+        if (length > budget) length = budget;
+        size_t written = slot.client.write(&slot.queue[slot.head], length);
+        if (written == 0) return; // Socket busy, retry on the next poll
+        slot.head = (slot.head + written) % WIFI_TX_QUEUE;
+        slot.count -= written;
+        budget -= written;
+    }
+}
+
+void WiFiHandler::closeSlot(int i) {
+    slots[i].client.stop();
+    slots[i].used = false;
+    if (slots[i].control) {
+        slots[i].control = false;
+        controlSlot = -1;
+        controlLost = true;
+        Serial.println("Client disconnected.");
+    } else {
+        Serial.println("Subscriber disconnected.");
+    }
+}
+
+bool WiFiHandler::controlClientLost() {
+    bool lost = controlLost;
+    controlLost = false;
+    return lost;
+}
+
+void WiFiHandler::publish(const char* line) {
+    uint16_t length = strlen(line);
+    for (int i = 0; i < WIFI_MAX_CLIENTS; i++) {
+        ClientSlot &slot = slots[i];
+        if (!slot.used || slot.control) continue;
+
+        // Whole lines only, a viewer behind by more than the queue loses lines instead of bytes
+        if (slot.count + length + 1 > WIFI_TX_QUEUE) {
+            slot.dropped++;
+            continue;
+        }
+        uint16_t tail = (slot.head + slot.count) % WIFI_TX_QUEUE;
+        for (uint16_t k = 0; k < length; k++) {
+            slot.queue[tail] = line[k];
+            tail = (tail + 1) % WIFI_TX_QUEUE;
+        }
+        slot.queue[tail] = '\n';
+        slot.count += length + 1;
+    }
+}
+
+uint8_t WiFiHandler::getSubscriberCount() const {
+    uint8_t count = 0;
+    for (int i = 0; i < WIFI_MAX_CLIENTS; i++) {
+        if (slots[i].used && !slots[i].control) count++;
+    }
+    return count;
+}
+
+uint32_t WiFiHandler::getDroppedLines() const {
+    uint32_t dropped = 0;
+    for (int i = 0; i < WIFI_MAX_CLIENTS; i++) {
+        dropped += slots[i].dropped;
+    }
+    return dropped;
+}
+
+void WiFiHandler::startUDP(const IPAddress &ip, uint16_t port) {
+    udpTarget = ip;
+    udpPort = port;
+    udpSequence = 0;
+    udpErrors = 0;
+    Serial.print("UDP telemetry to ");
+    Serial.print(ip);
+    Serial.print(":");
+    Serial.println(port);
+}
+
+void WiFiHandler::stopUDP() {
+    udpPort = 0;
+    Serial.println("UDP telemetry stopped.");
+}
+
+bool WiFiHandler::sendUDP(const uint8_t* payload, uint8_t length) {
+    if (udpPort == 0 || length > UDP_MAX_PAYLOAD) return false;
+
+    // Header and payload in one buffer, WiFiS3 forwards every write to the coprocessor
+    uint8_t datagram[UDP_HEADER_SIZE + UDP_MAX_PAYLOAD];
+    const uint16_t magic = UDP_TELEMETRY_MAGIC;
+    const uint32_t sequence = udpSequence++;
+    const uint32_t sendTime = micros();
+    memcpy(&datagram[0], &magic, 2);
+    datagram[2] = UDP_TELEMETRY_VERSION;
+    datagram[3] = length;
+    memcpy(&datagram[4], &sequence, 4);
+    memcpy(&datagram[8], &sendTime, 4);
+    memcpy(&datagram[UDP_HEADER_SIZE], payload, length);
+
+    if (!udp.beginPacket(udpTarget, udpPort) ||
+        udp.write(datagram, UDP_HEADER_SIZE + length) != (size_t)(UDP_HEADER_SIZE + length) ||
+        !udp.endPacket()) {
+        udpErrors++;
+        return false;
+    }
+    return true;
+}
@@ -3,18 +3,92 @@
 
 #include <WiFiS3.h>  // Change from <WiFi.h> to <WiFiS3.h>
 
+#define WIFI_MAX_CLIENTS 4      // One control client and up to three telemetry subscribers
+#define WIFI_TX_QUEUE 256       // Send queue per subscriber (bytes)
+#define WIFI_SEND_BUDGET 64     // Bytes written per subscriber per poll()
+#define WIFI_RETRY_MS 5000      // Wait between connection attempts
+
+// UDP telemetry datagram, little endian:
+//   uint16 magic | uint8 version | uint8 length of payload | uint32 sequence | uint32 send time (us) | payload
+#define UDP_TELEMETRY_MAGIC 0x5443
+#define UDP_TELEMETRY_VERSION 2
+#define UDP_HEADER_SIZE 12
+#define UDP_MAX_PAYLOAD 200
+
+/*
+ * Non-blocking TCP server with a fixed number of client slots.
+ * The first client to connect while there is no control client becomes the control client,
+ * its commands are read and answered by the caller. Every later client is a read-only
+ * subscriber: its input is discarded and telemetry is queued per subscriber and sent with a
+ * fixed byte budget per poll(), so a slow viewer only fills (and drops) its own queue.
+ */
 class WiFiHandler {
 private:
-    const char* ssid;      
-    const char* password;  
-    int tcpPort;           
-    WiFiServer server;     
+    struct ClientSlot {
+        WiFiClient client;
+        bool used;
+        bool control;
+        uint16_t head;          // Oldest queued byte
+        uint16_t count;         // Queued bytes
+        uint32_t dropped;       // Lines dropped because the queue was full
+        uint8_t queue[WIFI_TX_QUEUE];
+    };
+
+    const char* ssid;
+    const char* password;
+    int tcpPort;
+    WiFiServer server;
+    bool serverStarted;
+    bool connectAttempted;
+    unsigned long lastAttempt;  // millis() of the last WiFi.begin()
+    ClientSlot slots[WIFI_MAX_CLIENTS];
+    int controlSlot;            // -1 without control client
+    bool controlLost;
+
+    WiFiUDP udp;
+    IPAddress udpTarget;
+    uint16_t udpPort;           // 0 while UDP telemetry is off
+    uint32_t udpSequence;       // Sequence number of the next datagram
+    uint32_t udpErrors;         // Datagrams the coprocessor did not accept
+
+    void acceptClients();
+    void sendQueued(ClientSlot &slot);
+    void closeSlot(int i);
 
 public:
     WiFiHandler(const char* ssid, const char* password, int tcpPort);
     void connectToWiFi();
     void startTCPServer();
-    WiFiClient acceptClient();
+
+    /// @brief Connect step by step from loop(), starts the TCP server once connected
+    /// @return true when connected and listening
+    /// WiFi.begin() on the WiFiS3 modem still takes up to its connect timeout, the timer ISR
+    /// keeps running meanwhile. A failed attempt is retried after WIFI_RETRY_MS.
+    bool pollConnect();
+    bool isListening() const { return serverStarted; }
+
+    /// @brief Accept new clients, drop closed ones and send queued telemetry, never waits
+    void poll();
+
+    /// @brief Control client, only valid while hasControlClient()
+    WiFiClient &getControlClient() { return slots[controlSlot].client; }
+    bool hasControlClient() const { return controlSlot >= 0; }
+    /// @brief True once after the control client disconnected
+    bool controlClientLost();
+
+    /// @brief Queue a line for every subscriber, dropped for subscribers whose queue is full
+    void publish(const char* line);
+    uint8_t getSubscriberCount() const;
+    uint32_t getDroppedLines() const;
+
+    /// @brief Send telemetry datagrams to ip:port, restarts the sequence at 0
+    void startUDP(const IPAddress &ip, uint16_t port);
+    void stopUDP();
+    bool udpActive() const { return udpPort != 0; }
+    /// @brief Send one payload with header, never retried (a lost datagram is a gap in the sequence)
+    bool sendUDP(const uint8_t* payload, uint8_t length);
+    uint32_t getUdpSequence() const { return udpSequence; }
+    uint32_t getUdpErrors() const { return udpErrors; }
 };
 
 #endif
@@ -0,0 +1,43 @@
+// Host test of the control filters (src/filter.cpp).
+// Build and run: make test
+
+#include "src/filter.h"
+
+#include <cmath>
+#include <cstdio>
+
+static int failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+// A Q the resonators cannot realise is clamped to the critically damped one, every output stays finite
+template <typename T>
+static void testResonatorQ() {
+    const double qs[] = {0.6, 0.5, 0.3, 0.0, -1.0, NAN, INFINITY};
+    for (double q : qs) {
+        ResonatorBankT<T> bank({0.5, 1.0, 2.0, 4.0}, q, 1.0 / 75.0);
+        CHECK(bank.getQ() >= RESONATOR_MIN_Q && std::isfinite(bank.getQ()));
+        T sum = 0;
+        bool finite = true;
+        for (int i = 0; i < 75 * 20; i++) {
+            sum = bank.filter(1.0); // Step, settles at the unit DC gain of each resonator
+            finite = finite && std::isfinite((double)sum);
+        }
+        CHECK(finite);
+        CHECK(std::fabs((double)sum - bank.size()) < 1e-2);
+    }
+    CHECK(ResonatorBankT<T>({1.0}, 0.6, 1.0 / 75.0).getQ() == 0.6);
+    CHECK(ResonatorBankT<T>({1.0}, 0.3, 1.0 / 75.0).getQ() == RESONATOR_MIN_Q);
+}
+
+int main() {
+    testResonatorQ<float>();
+    testResonatorQ<double>();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("filter_test: all checks passed\n");
+    return 0;
+}
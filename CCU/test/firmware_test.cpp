@@ -0,0 +1,250 @@
+// Host test of the CCU firmware (src/main.cpp) through its control client.
+// Build and run: make test
+
+#include <Arduino.h>
+#include <SD.h>
+#include <WiFiS3.h>
+#include "src/commandParser.h"
+#include "src/kinematicTable.h"
+#include "src/paramRegistry.h"
+#include "src/setpointProgram.h"
+#include "src/torqueControl.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// From src/main.cpp
+void setup();
+void handleClientCommunication(WiFiClient &client);
+void controlClientLost();
+extern WiFiClient client;
+extern ParamRegistry params;
+extern SetpointProgram program;
+extern uint8_t mode;
+extern KinematicTable kinematic_table;
+
+static int failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+// The control client's bytes through the firmware, returns its reply lines
+static std::vector<std::string> send(const std::string &bytes) {
+    client.feed(reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size());
+    handleClientCommunication(client);
+    std::vector<std::string> lines;
+    const std::string sent = client.takeSent();
+    size_t start = 0;
+    while (start < sent.size()) {
+        size_t end = sent.find("\r\n", start);
+        if (end == std::string::npos) end = sent.size();
+        lines.push_back(sent.substr(start, end - start));
+        start = end + 2;
+    }
+    return lines;
+}
+
+// Every command ends its reply with exactly one ACK: or ERROR: line of its own name
+static void testCommandAcks() {
+    const struct { const char *command; const char *terminator; } pairs[] = {
+        {"BOOT", "ACK:BOOT"},
+        {"IMU_CAL", "ERROR:IMU_CAL"},           // The IMU is not ready without a sensor
+        {"IMU_CAL_STATUS", "ACK:IMU_CAL_STATUS"},
+        {"I2C_STATS", "ACK:I2C_STATS"},
+        {"I2C_RESET", "ACK:I2C_RESET"},
+        {"DUMP", "ACK:DUMP"},
+        {"SET:gyro_mea_e=0.5", "ACK:SET"},
+        {"STOP", "ACK:STOP"},
+    };
+    for (const auto &pair : pairs) {
+        const std::vector<std::string> lines = send(std::string(pair.command) + "\n");
+        int terminators = 0;
+        for (const std::string &line : lines) {
+            if (line.rfind("ACK:", 0) == 0 || line.rfind("ERROR:", 0) == 0) terminators++;
+        }
+        CHECK(!lines.empty() && lines.back() == pair.terminator);
+        CHECK(terminators == 1);
+        if (lines.empty() || lines.back() != pair.terminator || terminators != 1) {
+            printf("  %s ->", pair.command);
+            for (const std::string &line : lines) printf(" [%s]", line.c_str());
+            printf("\n");
+        }
+    }
+}
+
+// A full batch at DUMP precision (all FIR taps among them) and a full torque map fit in a line
+static void testLongestLines() {
+    params.applyPending(); // Staged by an earlier test, no tick runs here
+    const char *const assignments[PARAM_MAX_BATCH] = {
+        "setpoint_radius=-9.999", "motor_constant=999.900", "accel_mea_e=0.0001234",
+        "gyro_mea_e=0.0001234", "setpoint=-1999.000", "omega0=0.0001234",
+        "fir_yaw0=-1.999", "fir_yaw1=-1.999", "fir_yaw2=-1.999", "fir_yaw3=-1.999", "fir_yaw4=-1.999",
+        "fir_yaw5=-1.999", "fir_yaw6=-1.999", "fir_yaw7=-1.999", "fir_yaw8=-1.999", "fir_yaw9=-1.999",
+    };
+    std::string set = "SET:";
+    for (int i = 0; i < PARAM_MAX_BATCH; i++) {
+        set += (i ? "," : "") + std::string(assignments[i]);
+    }
+    CHECK(set.size() < CMD_MAX_TEXT);
+    std::vector<std::string> lines = send(set + "\r\n");
+    CHECK(lines.size() == 1 && lines[0] == "ACK:SET");
+    params.applyPending();
+    lines = send("GET:fir_yaw9,setpoint_radius\n");
+    CHECK(lines.size() == 1 && lines[0] == "GET:fir_yaw9=-1.999,setpoint_radius=-9.999");
+
+    std::string tqmap = "TQMAP:3,-1.500,1.500";
+    for (int i = 0; i < TORQUE_MAP_POINTS; i++) {
+        tqmap += ",-2.345";
+    }
+    lines = send(tqmap + "\n");
+    CHECK(lines.size() == 1 && lines[0] == "ACK:TQMAP");
+
+    // Longer lines are still dropped whole, the next line is parsed on its own
+    lines = send("SET:" + std::string(CMD_MAX_TEXT, '0') + "\nBOOT\n");
+    CHECK(!lines.empty() && lines.front() == "ERROR:PARSE" && lines.back() == "ACK:BOOT");
+}
+
+// The next client starts clean after a client dropped in the middle of a frame or a line
+static void testClientLostResetsParser() {
+    std::vector<std::string> lines = send(std::string("\xA5\x04\x04\x00", 4)); // SETPOINT frame, half its payload
+    CHECK(lines.empty());
+    controlClientLost();
+    client = WiFiClient();
+    lines = send("BOOT\n");
+    CHECK(!lines.empty() && lines.back() == "ACK:BOOT");
+
+    lines = send("SET:fir_ya");
+    CHECK(lines.empty());
+    controlClientLost();
+    client = WiFiClient();
+    lines = send("STOP\n");
+    CHECK(lines.size() == 1 && lines[0] == "ACK:STOP");
+}
+
+// The program's limits follow the mode, a step of 1000 RPM settles as fast as one of 3.5 m/s
+static void testProgramLimitsPerMode() {
+    const uint8_t saved_mode = mode;
+    mode = 2;
+    CHECK(send("SET:prog_accel=2,prog_jerk=10\n") == std::vector<std::string>{"ACK:SET"});
+    params.applyPending();
+
+    float speed = 0;
+    float radius = 0;
+    program.clear();
+    CHECK(program.addSegment("STEP,3,1000,0,0"));
+    program.start(0);
+    while (program.update(1.0 / 75, speed, radius)) {
+    }
+    CHECK(fabs(speed - 1000) < 1);
+
+    // A yaw_rate segment turns at that yaw rate whatever unit the speed is in, 1 m/s at 1 rad/s is 1 m
+    const float mps_to_rpm = 60.0 / (PI * d_wheel);
+    program.clear();
+    CHECK(program.addSegment((std::string("STEP,3,") + std::to_string(mps_to_rpm) + ",0,57.29578").c_str()));
+    program.start(0);
+    while (program.update(1.0 / 75, speed, radius)) {
+    }
+    CHECK(fabs(radius - 1) < 1e-2);
+
+    mode = saved_mode;
+    program.clear();
+}
+
+// Only the file of the same mode, setpoint and radius restores, a file under another key's name does not
+static void testIcoSnapshotKey() {
+    namespace fs = std::filesystem;
+    const fs::path card = fs::temp_directory_path() / "firmware_test_sd";
+    fs::remove_all(card);
+    fs::create_directories(card);
+    SD.setRoot(card.string());
+
+    auto setKey = [](const char *assignments) {
+        CHECK(send(std::string("SET:") + assignments + "\n") == std::vector<std::string>{"ACK:SET"});
+        params.applyPending();
+    };
+    auto only = [](const char *line) { return std::vector<std::string>{line}; };
+
+    setKey("setpoint=1,setpoint_radius=0.5");
+    CHECK(send("ICO_SAVE\n") == only("ACK:ICO_SAVE"));
+    CHECK(send("ICO_LOAD\n") == only("ACK:ICO_LOAD"));
+    std::vector<fs::path> files{fs::directory_iterator(card), fs::directory_iterator()};
+    CHECK(files.size() == 1);
+
+    setKey("setpoint_radius=-0.5"); // Same |setpoint|, the other turn
+    CHECK(send("ICO_LOAD\n") == only("ERROR:ICO_LOAD"));
+    setKey("setpoint=-1,setpoint_radius=0.5");
+    CHECK(send("ICO_LOAD\n") == only("ERROR:ICO_LOAD"));
+
+    // The first key's snapshot under the name of this key, as a hash collision would leave it
+    CHECK(send("ICO_SAVE\n") == only("ACK:ICO_SAVE"));
+    for (const fs::directory_entry &entry : fs::directory_iterator(card)) {
+        if (!files.empty() && entry.path() != files[0]) {
+            fs::copy_file(files[0], entry.path(), fs::copy_options::overwrite_existing);
+        }
+    }
+    CHECK(send("ICO_LOAD\n") == only("ERROR:ICO_LOAD"));
+
+    // A truncated file
+    setKey("setpoint=1,setpoint_radius=0.5");
+    if (!files.empty()) fs::resize_file(files[0], fs::file_size(files[0]) - 1);
+    CHECK(send("ICO_LOAD\n") == only("ERROR:ICO_LOAD"));
+
+    setKey("setpoint=0,setpoint_radius=0.5");
+    SD.setRoot("");
+    fs::remove_all(card);
+}
+
+// PID prints the wheel split of setpoint_radius without changing the turn the tick selected
+static void testPidLeavesTickTurn() {
+    kinematic_table.setRadius(0.5); // As the tick in modes 0 and 3
+    CHECK(send("SET:setpoint_radius=2\n") == std::vector<std::string>{"ACK:SET"});
+    params.applyPending();
+    CHECK(send("PID:1,10,0.01,0,1\n") == std::vector<std::string>{"ACK:PID"});
+
+    Velocities_acker selected;
+    Velocities_acker expected;
+    kinematic_table.getVelocities(1, selected);
+    kinematic_table.getVelocitiesAt(1, 0.5, expected);
+    CHECK(selected.v_left_front == expected.v_left_front && selected.v_right_rear == expected.v_right_rear);
+
+    CHECK(send("PID:1,10,0.01,0,2\n") == std::vector<std::string>{"ACK:PID"}); // Back to the defaults
+    CHECK(send("SET:setpoint_radius=0.5\n") == std::vector<std::string>{"ACK:SET"});
+    params.applyPending();
+}
+
+// An over-long frame is skipped by its length, the binary frame right after it still counts
+static void testOversizedFrameSkipped() {
+    std::string bytes = {(char)CMD_FRAME_START, (char)(CMD_MAX_PAYLOAD + 8), (char)CMD_SETPOINT};
+    bytes += std::string(CMD_MAX_PAYLOAD + 8, 'x');
+    bytes += '\0'; // Checksum, not looked at
+    Command stop = {};
+    stop.type = CMD_STOP;
+    uint8_t frame[8];
+    const size_t length = CommandParser::encode(stop, frame, sizeof(frame));
+    bytes.append(reinterpret_cast<const char *>(frame), length);
+
+    std::vector<std::string> lines = send(bytes);
+    CHECK(lines.size() == 2 && lines[0] == "ERROR:PARSE" && lines[1] == "ACK:STOP");
+}
+
+int main() {
+    Serial.quiet = true;
+    SD.setRoot(""); // No card
+    hostClockSet(0, 0);
+    setup();
+
+    testCommandAcks();
+    testLongestLines();
+    testClientLostResetsParser();
+    testProgramLimitsPerMode();
+    testIcoSnapshotKey();
+    testPidLeavesTickTurn();
+    testOversizedFrameSkipped();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("firmware_test: all checks passed\n");
+    return 0;
+}
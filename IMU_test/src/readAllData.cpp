@@ -25,28 +25,11 @@ void setup(){
     Serial.println("init false");
     while(1);
   }
-  //bmx160.setLowPower();   //disable the gyroscope and accelerometer sensor
-  //bmx160.wakeUp();        //enable the gyroscope and accelerometer sensor
-  //bmx160.softReset();     //reset the sensor
-  
-  /** 
-   * enum{eGyroRange_2000DPS,
-   *       eGyroRange_1000DPS,
-   *       eGyroRange_500DPS,
-   *       eGyroRange_250DPS,
-   *       eGyroRange_125DPS
-   *       }eGyroRange_t;
-   **/
-  //bmx160.setGyroRange(eGyroRange_500DPS);
-  
   /**
-   *  enum{eAccelRange_2G,
-   *       eAccelRange_4G,
-   *       eAccelRange_8G,
-   *       eAccelRange_16G
-   *       }eAccelRange_t;
+   * Ranges and output data rates are fixed at compile time, DFRobot_BMX160 is
+   * +-2 g, +-500 dps, 100 Hz. For others declare the sensor as e.g.
+   * BMX160<TwoWire, BMX160Config<eAccelRange_4G, eGyroRange_500DPS>> bmx160(Wire);
    */
-  //bmx160.setAccelRange(eAccelRange_4G);
   delay(100);
 }
 
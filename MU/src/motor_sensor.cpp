@@ -3,7 +3,7 @@
 MotorSensor* MotorSensor::instance = nullptr;
 
 MotorSensor::MotorSensor(int RPMpin, int filterSizeRPM, int currentSensePin, int filterSizeCurrent)
-    : RPMpin_(RPMpin), filterSizeRPM_(filterSizeRPM), currentSensePin_(currentSensePin), filterSizeCurrent_(filterSizeCurrent) , lastTime(0), timeBetweenSensors(0), rpmIndex(0) {
+    : RPMpin_(RPMpin), filterSizeRPM_(filterSizeRPM), currentSensePin_(currentSensePin), filterSizeCurrent_(filterSizeCurrent) , lastTime(0), timeBetweenSensors(0), rpmIndex(0), currentIndex(0) {
     if (filterSizeRPM_ > MAX_FILTER_SIZE) {
         filterSizeRPM_ = MAX_FILTER_SIZE;
     }
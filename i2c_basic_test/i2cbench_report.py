@@ -0,0 +1,92 @@
+"""Summarise the I2C benchmark CSV of simplei2c_master (serial log) or i2cbenchsim (stdout).
+
+    python i2cbench_report.py serial_log.txt [--tick-hz 75] [--mus 4] [--share 0.5]
+    ./simplei2c_master/i2cbenchsim | python i2cbench_report.py -
+
+Lines outside the CSV (firmware messages, '#' comments) are skipped; when a log holds several
+runs the last row of every case and clock counts. Prints the results per clock and how many
+MU round trips fit into one control tick at their p99 latency.
+"""
+
+import argparse
+import csv
+import math
+import sys
+
+HEADER = 'case'
+ROUND_TRIPS = ['mu_setpoint', 'burst_stop', 'burst_restart']
+
+
+def read_rows(lines):
+    rows = {}
+    header = None
+    for row in csv.reader(line.strip() for line in lines):
+        if not row or row[0].startswith('#'):
+            continue
+        if row[0] == HEADER:
+            header = row
+            continue
+        if header is None or len(row) != len(header):
+            continue
+        record = dict(zip(header, row))
+        try:
+            for key in header[1:]:
+                record[key] = float(record[key])
+        except ValueError:
+            continue
+        rows[(record['case'], int(record['clock_hz']))] = record
+    return rows
+
+
+def error_rate(record):
+    failed = record['nacks'] + record['short_reads'] + record['data_errors']
+    return failed / record['transactions'] if record['transactions'] else math.nan
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('log', help="CSV or serial log, '-' for stdin")
+    parser.add_argument('--tick-hz', type=float, default=75.0, help='control tick rate (default 75)')
+    parser.add_argument('--mus', type=int, default=4, help='MUs polled every tick (default 4)')
+    parser.add_argument('--share', type=float, default=0.5,
+                        help='share of the tick the MU traffic may take (default 0.5)')
+    args = parser.parse_args()
+
+    if args.log == '-':
+        rows = read_rows(sys.stdin)
+    else:
+        with open(args.log, newline='') as log:
+            rows = read_rows(log)
+    if not rows:
+        sys.exit('No benchmark rows found')
+
+    clocks = sorted({clock for _, clock in rows})
+    cases = list(dict.fromkeys(case for case, _ in rows))
+    for clock in clocks:
+        print(f'\n{clock / 1000:g} kHz')
+        print(f"{'case':<14} {'tx/s':>8} {'mean':>6} {'p50':>6} {'p90':>6} {'p99':>6} {'max':>6} {'errors':>8}")
+        for case in cases:
+            record = rows.get((case, clock))
+            if record is None:
+                continue
+            print(f"{case:<14} {record['tx_per_s']:8.0f} {record['mean_us']:6.0f} {record['p50_us']:6.0f} "
+                  f"{record['p90_us']:6.0f} {record['p99_us']:6.0f} {record['max_us']:6.0f} "
+                  f"{100 * error_rate(record):7.2f}%")
+
+    tick_us = 1e6 / args.tick_hz
+    budget_us = tick_us * args.share
+    print(f'\nMU round trips per {tick_us:.0f} us tick ({args.tick_hz:g} Hz), '
+          f'{100 * args.share:g} % of it for the bus, p99 latency')
+    print(f"{'case':<14} {'clock':>8} {'per tick':>9} {f'max Hz, {args.mus} MUs':>15} {'errors':>8}")
+    for clock in clocks:
+        for case in ROUND_TRIPS:
+            record = rows.get((case, clock))
+            if record is None or record['p99_us'] <= 0:
+                continue
+            per_tick = int(budget_us // record['p99_us'])
+            max_hz = args.share * 1e6 / (args.mus * record['p99_us'])
+            print(f"{case:<14} {clock / 1000:6g}k {per_tick:9d} {max_hz:15.0f} {100 * error_rate(record):7.2f}%")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,106 @@
+/*
+ * i2cbenchsim - the benchmark master (src/i2c_master.cpp) against the slave's responder on
+ * the CCU's virtual bus (CCU/host), on Linux.
+ *
+ * Usage: i2cbenchsim [options]
+ *   --transactions N   Per case and clock                   (default 2000)
+ *   --clock HZ         Bus clock, repeat for several        (default 100000, 400000, 1000000)
+ *   --latency US       Slave time per transaction           (default 0)
+ *   --nack P           Probability of an address NACK       (default 0)
+ *   --bit-error P      Probability of a flipped data bit    (default 0)
+ *   --seed N           Random seed of the faults            (default 1)
+ *
+ * The clock is frozen and every transaction moves it on by its bytes at the bus clock plus
+ * the latency, so the numbers are the floor set by the bus; the firmware pair on the car's
+ * hardware adds what the AVR's interrupt and the R4's Wire driver really take. CSV on stdout
+ * as the firmware prints it, for ../i2cbench_report.py.
+ */
+
+#include "src/i2c_master.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/// @brief The benchmark slave (simplei2c_slave) as a device on the virtual bus
+class SimBenchSlave : public HostI2CDevice {
+public:
+    bool receive(const uint8_t *data, uint8_t length) override {
+        _responder.receive(data, length);
+        return true;
+    }
+
+    uint8_t request(uint8_t *data, uint8_t length) override {
+        uint8_t reply[I2C_BENCH_BUFFER];
+        const uint8_t count = _responder.reply(reply);
+        // The master clocks out length bytes, the AVR sends 0xFF past its reply
+        for (uint8_t i = 0; i < length; i++) {
+            data[i] = i < count ? reply[i] : 0xFF;
+        }
+        return length;
+    }
+
+private:
+    I2CBenchResponder _responder;
+};
+
+int main(int argc, char **argv) {
+    unsigned transactions = 2000;
+    std::vector<uint32_t> clocks;
+    HostWireFaults faults = {};
+    unsigned seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--transactions") && i + 1 < argc) transactions = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--clock") && i + 1 < argc) clocks.push_back(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--latency") && i + 1 < argc) faults.latency_us = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--nack") && i + 1 < argc) faults.nack = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--bit-error") && i + 1 < argc) faults.bit_error = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Usage: %s [--transactions N] [--clock HZ]... [--latency US] [--nack P] "
+                            "[--bit-error P] [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (transactions == 0 || transactions > 65535) {
+        fprintf(stderr, "--transactions must be 1..65535\n");
+        return 1;
+    }
+    if (faults.nack < 0 || faults.nack > 1 || faults.bit_error < 0 || faults.bit_error > 1) {
+        fprintf(stderr, "--nack and --bit-error are probabilities\n");
+        return 1;
+    }
+    for (uint32_t clock : clocks) {
+        if (clock == 0) {
+            fprintf(stderr, "--clock must be positive\n");
+            return 1;
+        }
+    }
+    if (clocks.empty()) clocks = {100000, 400000, 1000000};
+
+    hostClockSet(0, 0);
+    SimBenchSlave slave;
+    Wire.attach(I2C_BENCH_ADDRESS, &slave);
+    Wire.seedFaults(seed);
+
+    I2CMaster master;
+    master.begin();
+    if (!master.probe()) {
+        fprintf(stderr, "The slave does not answer\n");
+        return 1;
+    }
+    // Faults only for the benchmark, the counters of the slave are read through them too
+    Wire.setFaults(I2C_BENCH_ADDRESS, faults);
+
+    BenchResult result;
+    I2CMaster::printHeader(Serial);
+    for (uint32_t clock : clocks) {
+        for (uint8_t i = 0; i < BENCH_CASE_COUNT; i++) {
+            master.run(BENCH_CASES[i], clock, transactions, result);
+            I2CMaster::printResult(Serial, result);
+        }
+    }
+    return 0;
+}
@@ -1,6 +1,24 @@
 #include "i2c_master.h"
 
-I2CMaster::I2CMaster() {}
+const BenchCase BENCH_CASES[] = {
+    {"mu_setpoint", BENCH_MU_SETPOINT, 0},
+    {"mu_param", BENCH_MU_PARAM, 0},
+    {"burst_stop", BENCH_BURST_STOP, 0},
+    {"burst_restart", BENCH_BURST_RESTART, 0},
+    {"write_2", BENCH_WRITE, 2},
+    {"write_4", BENCH_WRITE, 4},
+    {"write_8", BENCH_WRITE, 8},
+    {"write_16", BENCH_WRITE, 16},
+    {"write_32", BENCH_WRITE, 32},
+    {"read_2", BENCH_READ, 2},
+    {"read_4", BENCH_READ, 4},
+    {"read_8", BENCH_READ, 8},
+    {"read_16", BENCH_READ, 16},
+    {"read_32", BENCH_READ, 32},
+};
+const uint8_t BENCH_CASE_COUNT = sizeof(BENCH_CASES) / sizeof(BENCH_CASES[0]);
+
+I2CMaster::I2CMaster(uint8_t slave_address) : _slaveAddress(slave_address), _seq(0) {}
 
 void I2CMaster::begin() {
     Wire.begin();
@@ -8,35 +26,176 @@ void I2CMaster::begin() {
     Serial.println("I2C Master Ready!");
 }
 
-void I2CMaster::sendData(uint8_t slave_adress, uint8_t setpoint, uint8_t kp, uint8_t ki, uint8_t kd) {
-    Wire.beginTransmission(slave_adress);
-    Wire.write(setpoint);
-    Wire.write(kp);
-    Wire.write(ki);
-    Wire.write(kd);
-    Wire.endTransmission();
+bool I2CMaster::probe() {
+    Wire.beginTransmission(_slaveAddress);
+    return Wire.endTransmission() == 0;
+}
+
+void I2CMaster::run(const BenchCase &bench, uint32_t clock, uint16_t transactions, BenchResult &result) {
+    Wire.setClock(clock);
+    result = {};
+    result.name = bench.name;
+    result.clock = clock;
+    result.transactions = transactions;
+    switch (bench.layout) {
+        case BENCH_MU_SETPOINT: result.tx_bytes = I2C_BENCH_MU_SETPOINT_WRITE; result.rx_bytes = I2C_BENCH_MU_REPLY; break;
+        case BENCH_MU_PARAM: result.tx_bytes = I2C_BENCH_MU_PARAM_WRITE; break;
+        case BENCH_BURST_STOP:
+        case BENCH_BURST_RESTART: result.tx_bytes = I2C_BENCH_BURST_WRITE; result.rx_bytes = I2C_BENCH_BURST_REPLY; break;
+        case BENCH_WRITE: result.tx_bytes = bench.size; break;
+        case BENCH_READ: result.rx_bytes = bench.size; break;
+    }
+
+    // Restart the slave's counters, and tell it the frame length of the reads
+    uint16_t frames, bad;
+    readStats(frames, bad);
+    if (bench.layout == BENCH_READ) {
+        const uint8_t frame[2] = {I2C_BENCH_CMD_STREAM, bench.size};
+        Wire.beginTransmission(_slaveAddress);
+        Wire.write(frame, sizeof(frame));
+        Wire.endTransmission();
+    }
+
+    memset(_hist, 0, sizeof(_hist));
+    uint16_t timed = 0;
+    uint64_t sum_us = 0;
+    const uint32_t start_us = micros();
+    for (uint16_t i = 0; i < transactions; i++) {
+        const uint32_t t0_us = micros();
+        const Outcome outcome = transaction(bench);
+        const uint32_t dt_us = micros() - t0_us;
+        switch (outcome) {
+            case OUTCOME_OK: {
+                timed++;
+                sum_us += dt_us;
+                if (dt_us > result.max_us) result.max_us = dt_us;
+                const uint32_t bin = dt_us / BENCH_HIST_BIN_US;
+                _hist[bin < BENCH_HIST_BINS ? bin : BENCH_HIST_BINS - 1]++;
+                break;
+            }
+            case OUTCOME_NACK: result.nacks++; break;
+            case OUTCOME_SHORT: result.short_reads++; break;
+            case OUTCOME_DATA: result.data_errors++; break;
+        }
+    }
+    result.elapsed_us = micros() - start_us;
+
+    // Writes the slave found corrupt were acknowledged, they are only known here
+    result.ok = timed;
+    if (readStats(frames, bad) && bad <= result.ok) {
+        result.ok -= bad;
+        result.data_errors += bad;
+    }
+
+    if (timed > 0) {
+        result.tx_per_s = result.ok * 1e6f / result.elapsed_us;
+        result.mean_us = sum_us / timed;
+        result.p50_us = percentile(timed, 0.5f, result.max_us);
+        result.p90_us = percentile(timed, 0.9f, result.max_us);
+        result.p99_us = percentile(timed, 0.99f, result.max_us);
+    }
+}
+
+I2CMaster::Outcome I2CMaster::transaction(const BenchCase &bench) {
+    uint8_t frame[I2C_BENCH_BUFFER];
+    uint8_t reply[I2C_BENCH_BUFFER];
+    const uint8_t seq = _seq++;
+    Outcome outcome;
 
-    Serial.println("Data sent!");
+    switch (bench.layout) {
+        case BENCH_MU_SETPOINT: {
+            Wire.beginTransmission(_slaveAddress);
+            Wire.write(I2C_BENCH_CMD_MU_SETPOINT);
+            Wire.write(seq);
+            if (Wire.endTransmission() != 0) return OUTCOME_NACK;
+            if ((outcome = read(reply, I2C_BENCH_MU_REPLY)) != OUTCOME_OK) return outcome;
+            return reply[0] == seq && reply[2] == (uint8_t)~reply[1] ? OUTCOME_OK : OUTCOME_DATA;
+        }
+        case BENCH_MU_PARAM: {
+            // Mode 2 and the MUs' default gains, as the CCU sends them
+            const uint8_t param[I2C_BENCH_MU_PARAM_WRITE] = {I2C_BENCH_CMD_MU_PARAM, 2, 0x01, 0x2C, 0x0F, 0xA0, 0x00, 0x00};
+            Wire.beginTransmission(_slaveAddress);
+            Wire.write(param, sizeof(param));
+            return Wire.endTransmission() == 0 ? OUTCOME_OK : OUTCOME_NACK;
+        }
+        case BENCH_BURST_STOP:
+        case BENCH_BURST_RESTART: {
+            frame[0] = I2C_BENCH_CMD_BURST;
+            frame[1] = seq;
+            frame[2] = (uint8_t)~seq;
+            frame[3] = i2cBenchCrc8(frame + 1, 2);
+            Wire.beginTransmission(_slaveAddress);
+            Wire.write(frame, I2C_BENCH_BURST_WRITE);
+            if (Wire.endTransmission(bench.layout == BENCH_BURST_STOP) != 0) return OUTCOME_NACK;
+            if ((outcome = read(reply, I2C_BENCH_BURST_REPLY)) != OUTCOME_OK) return outcome;
+            const bool good = reply[6] == i2cBenchCrc8(reply, 6) && reply[0] == frame[1] && reply[1] == frame[2];
+            return good ? OUTCOME_OK : OUTCOME_DATA;
+        }
+        case BENCH_WRITE:
+            frame[0] = I2C_BENCH_CMD_SINK;
+            i2cBenchFrame(frame + 1, bench.size - 1, seq);
+            Wire.beginTransmission(_slaveAddress);
+            Wire.write(frame, bench.size);
+            return Wire.endTransmission() == 0 ? OUTCOME_OK : OUTCOME_NACK;
+        case BENCH_READ:
+            if ((outcome = read(reply, bench.size)) != OUTCOME_OK) return outcome;
+            return i2cBenchCheck(reply, bench.size) ? OUTCOME_OK : OUTCOME_DATA;
+    }
+    return OUTCOME_DATA;
 }
 
-void I2CMaster::requestData(uint8_t slave_adress) {
-    Wire.requestFrom(slave_adress, 4); // Request 4 bytes
+I2CMaster::Outcome I2CMaster::read(uint8_t *data, uint8_t length) {
+    const uint8_t received = Wire.requestFrom(_slaveAddress, length);
+    uint8_t count = 0;
+    while (Wire.available() && count < length) {
+        data[count++] = Wire.read();
+    }
+    if (received == 0) return OUTCOME_NACK; // Wire does not tell an address NACK apart
+    return count == length ? OUTCOME_OK : OUTCOME_SHORT;
+}
 
-    if (Wire.available() >= 4) {
-        uint8_t setpoint_recv = Wire.read();
-        float kp_recv = Wire.read();
-        float ki_recv = Wire.read();
-        float kd_recv = Wire.read();
+bool I2CMaster::readStats(uint16_t &frames, uint16_t &bad) {
+    uint8_t reply[I2C_BENCH_STATS_REPLY];
+    Wire.beginTransmission(_slaveAddress);
+    Wire.write(I2C_BENCH_CMD_STATS);
+    if (Wire.endTransmission() != 0 || read(reply, sizeof(reply)) != OUTCOME_OK) return false;
+    frames = (reply[0] << 8) | reply[1];
+    bad = (reply[2] << 8) | reply[3];
+    return true;
+}
 
-        Serial.print("Received back: Setpoint = ");
-        Serial.print(setpoint_recv);
-        Serial.print(", Kp = ");
-        Serial.print(kp_recv);
-        Serial.print(", Ki = ");
-        Serial.print(ki_recv);
-        Serial.print(", Kd = ");
-        Serial.println(kd_recv);
-    } else {
-        Serial.println("Error: Did not receive expected data from slave!");
+uint32_t I2CMaster::percentile(uint16_t count, float fraction, uint32_t max_us) const {
+    const uint32_t rank = (uint32_t)ceilf(count * fraction);
+    uint32_t seen = 0;
+    uint16_t bin = 0;
+    for (; bin < BENCH_HIST_BINS - 1; bin++) {
+        seen += _hist[bin];
+        if (seen >= rank) break;
     }
+    const uint32_t edge_us = (bin + 1) * BENCH_HIST_BIN_US;
+    return edge_us < max_us ? edge_us : max_us; // The bin's edge can be past the slowest
+}
+
+void I2CMaster::printHeader(Print &out) {
+    out.println("case,clock_hz,tx_bytes,rx_bytes,transactions,ok,nacks,short_reads,data_errors,"
+                "elapsed_us,tx_per_s,mean_us,p50_us,p90_us,p99_us,max_us");
+}
+
+void I2CMaster::printResult(Print &out, const BenchResult &result) {
+    out.print(result.name); out.print(',');
+    out.print(result.clock); out.print(',');
+    out.print(result.tx_bytes); out.print(',');
+    out.print(result.rx_bytes); out.print(',');
+    out.print(result.transactions); out.print(',');
+    out.print(result.ok); out.print(',');
+    out.print(result.nacks); out.print(',');
+    out.print(result.short_reads); out.print(',');
+    out.print(result.data_errors); out.print(',');
+    out.print(result.elapsed_us); out.print(',');
+    out.print(result.tx_per_s, 1); out.print(',');
+    out.print(result.mean_us); out.print(',');
+    out.print(result.p50_us); out.print(',');
+    out.print(result.p90_us); out.print(',');
+    out.print(result.p99_us); out.print(',');
+    out.println(result.max_us);
 }
@@ -3,16 +3,77 @@
 
 #include <Wire.h>
 #include <Arduino.h>
+#include <I2CBench.h>
 
+#define BENCH_HIST_BIN_US 10
+#define BENCH_HIST_BINS 1000        // 10 ms, slower transactions count in the last bin
+
+enum BenchLayout : uint8_t {
+    BENCH_MU_SETPOINT,              // The CCU today: setpoint write, stop, 3 byte read
+    BENCH_MU_PARAM,                 // The CCU's 8 byte parameter write
+    BENCH_BURST_STOP,               // Candidate: 16 bit setpoint + CRC, stop, 16 bit values + CRC
+    BENCH_BURST_RESTART,            // The same with a repeated start instead of stop and start
+    BENCH_WRITE,                    // SINK frame of size bytes (command included, at least 2)
+    BENCH_READ                      // STREAM frame of size bytes
+};
+
+struct BenchCase {
+    const char *name;
+    BenchLayout layout;
+    uint8_t size;                   // BENCH_WRITE and BENCH_READ only
+};
+
+struct BenchResult {
+    const char *name;
+    uint32_t clock;                 // Hz asked of Wire.setClock()
+    uint8_t tx_bytes;               // Per transaction, address bytes not counted
+    uint8_t rx_bytes;
+    uint16_t transactions;
+    uint16_t ok;
+    uint16_t nacks;                 // endTransmission() did not return 0
+    uint16_t short_reads;           // requestFrom() returned fewer bytes than asked
+    uint16_t data_errors;           // Check failed at the master, or bad frames seen by the slave
+    uint32_t elapsed_us;            // All transactions back to back, failed ones included
+    float tx_per_s;                 // Good transactions per second
+    uint32_t mean_us;               // Latency of the transactions good at the master
+    uint32_t p50_us;
+    uint32_t p90_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+};
+
+extern const BenchCase BENCH_CASES[];
+extern const uint8_t BENCH_CASE_COUNT;
+
+/**
+ * @brief Benchmark master: times transactions of one layout against the slave (I2CBench.h).
+ *
+ * A transaction is timed with micros() from beginTransmission() to the last byte read, so a
+ * round trip includes both stops and the slave's callbacks stretching the clock. The latency
+ * histogram has BENCH_HIST_BIN_US bins, percentiles are the upper edge of their bin,
+ * at most the slowest transaction.
+ */
 class I2CMaster {
 public:
-    I2CMaster();
+    I2CMaster(uint8_t slave_address = I2C_BENCH_ADDRESS);
     void begin();
-    void sendData(uint8_t slave_adress,uint8_t setpoint, uint8_t kp, uint8_t ki, uint8_t kd);
-    void requestData(uint8_t slave_adress);
+    bool probe(); // True if the slave acknowledges its address
+    void run(const BenchCase &bench, uint32_t clock, uint16_t transactions, BenchResult &result);
+
+    static void printHeader(Print &out);
+    static void printResult(Print &out, const BenchResult &result);
 
 private:
+    enum Outcome : uint8_t { OUTCOME_OK, OUTCOME_NACK, OUTCOME_SHORT, OUTCOME_DATA };
+
+    Outcome transaction(const BenchCase &bench);
+    Outcome read(uint8_t *data, uint8_t length);
+    bool readStats(uint16_t &frames, uint16_t &bad);
+    uint32_t percentile(uint16_t count, float fraction, uint32_t max_us) const;
+
     uint8_t _slaveAddress;
+    uint8_t _seq;
+    uint16_t _hist[BENCH_HIST_BINS];
 };
 
 #endif
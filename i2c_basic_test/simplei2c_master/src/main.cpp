@@ -1,15 +1,38 @@
 #include "i2c_master.h"
 
+#define BENCH_TRANSACTIONS 2000     // Per case and clock
+
+// The R4 supports these, the Nano's TWI is specified up to 400 kHz
+static const uint32_t bench_clocks[] = {100000, 400000, 1000000};
+
 I2CMaster i2cMaster; // Define the master instance globally
 
+// CSV on Serial, for i2c_basic_test/i2cbench_report.py
+void runBench() {
+    BenchResult result;
+    I2CMaster::printHeader(Serial);
+    for (uint32_t clock : bench_clocks) {
+        for (uint8_t i = 0; i < BENCH_CASE_COUNT; i++) {
+            i2cMaster.run(BENCH_CASES[i], clock, BENCH_TRANSACTIONS, result);
+            I2CMaster::printResult(Serial, result);
+        }
+    }
+    Wire.setClock(100000);
+    Serial.println("# Done, send any character to run again");
+}
+
 void setup() {
     i2cMaster.begin();
+    while (!i2cMaster.probe()) {
+        Serial.println("# Waiting for the slave...");
+        delay(1000);
+    }
+    runBench();
 }
 
 void loop() {
-    delay(1000); // Send data every second
-
-    i2cMaster.sendData(0x42, 100, 10, 5, 1); 
-    delay(50);
-    i2cMaster.requestData(0x42);
+    if (Serial.available()) {
+        while (Serial.available()) Serial.read();
+        runBench();
+    }
 }
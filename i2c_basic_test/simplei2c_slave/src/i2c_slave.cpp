@@ -2,7 +2,7 @@
 
 I2CSlave* I2CSlave::instance = nullptr; // Initialize instance pointer
 
-I2CSlave::I2CSlave(uint8_t address) : _address(address), _receivedValue(0) {
+I2CSlave::I2CSlave(uint8_t address) : _address(address) {
     instance = this; // Store instance reference
 }
 
@@ -14,24 +14,18 @@ void I2CSlave::begin() {
 
 void I2CSlave::receiveEvent(int bytes) {
     if (instance) {
-        Serial.print("Received: ");
-        int index = 0;
-        while (Wire.available() && index < 4) { // Read all bytes
-            instance->_receivedData[index] = Wire.read();
-            Serial.print(instance->_receivedData[index]); // Print received value
-            Serial.print(" ");
-            index++;
+        uint8_t frame[I2C_BENCH_BUFFER];
+        uint8_t length = 0;
+        while (Wire.available() && length < I2C_BENCH_BUFFER) { // Read all bytes
+            frame[length++] = Wire.read();
         }
-        Serial.println(); 
+        instance->_responder.receive(frame, length);
     }
 }
 
-
 void I2CSlave::requestEvent() {
     if (instance) {
-        for (int i = 0; i < 4; i++) {
-            Wire.write((instance->_receivedData[i]) + 5);
-        }
+        uint8_t reply[I2C_BENCH_BUFFER];
+        Wire.write(reply, instance->_responder.reply(reply)); // One write, the AVR buffers it
     }
 }
-
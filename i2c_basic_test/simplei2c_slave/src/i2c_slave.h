@@ -3,7 +3,14 @@
 
 #include <Wire.h>
 #include <Arduino.h>
+#include <I2CBench.h>
 
+/**
+ * @brief Benchmark slave: answers the master's frames (I2CBench.h) from the Wire callbacks.
+ *
+ * Nothing is printed in the callbacks, they run in the TWI interrupt and every microsecond
+ * there stretches the clock and shows up in the master's latency.
+ */
 class I2CSlave {
 public:
     I2CSlave(uint8_t address);
@@ -11,9 +18,7 @@ public:
 
 private:
     uint8_t _address;
-    uint8_t _receivedValue;
-    uint8_t _receivedData[4]; 
-
+    I2CBenchResponder _responder;
 
     static void receiveEvent(int bytes);
     static void requestEvent();
@@ -1,15 +1,14 @@
 #include <Arduino.h>
 #include "i2c_slave.h"
 
-I2CSlave i2cSlave(0x08); 
+I2CSlave i2cSlave(I2C_BENCH_ADDRESS);
 
 void setup() {
     Serial.begin(115200);
     i2cSlave.begin();
-    Serial.println("I2C Slave initialized");
+    Serial.println("I2C benchmark slave initialized");
 }
 
 void loop() {
     delay(1000);
-    Serial.println("Looping...");
 }
@@ -0,0 +1,508 @@
+/*!
+ * @file BMX160.h
+ * @brief BMX160 driver shared by the CCU and the IMU test sketches.
+ * @n     Derived from DFRobot_BMX160 (https://github.com/DFRobot/DFRobot_BMX160),
+ * @n     Copyright (c) 2010 DFRobot Co.Ltd, The MIT License (MIT).
+ * @n
+ * @n     BMX160<Bus, Config> talks to the sensor over any Wire-like bus (TwoWire on the boards,
+ * @n     a simulated register file on the host). Ranges and output data rates are template
+ * @n     parameters, written to the sensor during begin(), and the scale factors follow from them
+ * @n     at compile time. The driver allocates nothing; every transfer reports its result.
+ */
+#ifndef BMX160_H
+#define BMX160_H
+
+#include <Arduino.h>
+
+/** Registers */
+#define BMX160_CHIP_ID_ADDR                      0x00
+#define BMX160_ERROR_REG_ADDR                    0x02
+#define BMX160_MAG_DATA_ADDR                     0x04
+#define BMX160_GYRO_DATA_ADDR                    0x0C
+#define BMX160_ACCEL_DATA_ADDR                   0x12
+#define BMX160_SENSORTIME_ADDR                   0x18
+#define BMX160_STATUS_ADDR                       0x1B
+#define BMX160_ACCEL_CONFIG_ADDR                 0x40
+#define BMX160_ACCEL_RANGE_ADDR                  0x41
+#define BMX160_GYRO_CONFIG_ADDR                  0x42
+#define BMX160_GYRO_RANGE_ADDR                   0x43
+#define BMX160_MAGN_CONFIG_ADDR                  0x44
+#define BMX160_MAGN_IF_0_ADDR                    0x4C
+#define BMX160_MAGN_IF_1_ADDR                    0x4D
+#define BMX160_MAGN_IF_2_ADDR                    0x4E
+#define BMX160_MAGN_IF_3_ADDR                    0x4F
+#define BMX160_INT_ENABLE_1_ADDR                 0x51
+#define BMX160_INT_OUT_CTRL_ADDR                 0x53
+#define BMX160_INT_LATCH_ADDR                    0x54
+#define BMX160_INT_MAP_1_ADDR                    0x56
+#define BMX160_FOC_CONF_ADDR                     0x69
+#define BMX160_OFFSET_ADDR                       0x71
+#define BMX160_OFFSET_CONF_ADDR                  0x77
+#define BMX160_COMMAND_REG_ADDR                  0x7E
+
+/** Error codes */
+#define BMX160_OK                                0
+#define BMX160_E_COM_FAIL                        -2
+#define BMX160_E_DEV_NOT_FOUND                   -3
+
+#define BMX160_CHIP_ID                           0xD8
+#define BMX160_I2C_ADDR                          0x68
+
+/** Commands */
+#define BMX160_SOFT_RESET_CMD                    0xB6
+#define BMX160_SOFT_RESET_DELAY_MS               15
+#define BMX160_START_FOC_CMD                     0x03
+#define BMX160_ACCEL_NORMAL_MODE                 0x11
+#define BMX160_GYRO_NORMAL_MODE                  0x15
+#define BMX160_MAGN_NORMAL_MODE                  0x19
+
+/** Output data rates */
+#define BMX160_ACCEL_ODR_12_5HZ                  0x05
+#define BMX160_ACCEL_ODR_25HZ                    0x06
+#define BMX160_ACCEL_ODR_50HZ                    0x07
+#define BMX160_ACCEL_ODR_100HZ                   0x08
+#define BMX160_ACCEL_ODR_200HZ                   0x09
+#define BMX160_ACCEL_ODR_400HZ                   0x0A
+#define BMX160_ACCEL_ODR_800HZ                   0x0B
+#define BMX160_ACCEL_ODR_1600HZ                  0x0C
+#define BMX160_GYRO_ODR_25HZ                     0x06
+#define BMX160_GYRO_ODR_50HZ                     0x07
+#define BMX160_GYRO_ODR_100HZ                    0x08
+#define BMX160_GYRO_ODR_200HZ                    0x09
+#define BMX160_GYRO_ODR_400HZ                    0x0A
+#define BMX160_GYRO_ODR_800HZ                    0x0B
+#define BMX160_GYRO_ODR_1600HZ                   0x0C
+#define BMX160_GYRO_ODR_3200HZ                   0x0D
+#define BMX160_ACCEL_BW_NORMAL_AVG4              0x02
+#define BMX160_GYRO_BW_NORMAL_MODE               0x02
+
+/** Interrupt masks */
+#define BMX160_DATA_RDY_INT_EN_MASK              0x10
+#define BMX160_INT1_EDGE_CTRL_MASK               0x01
+#define BMX160_INT1_OUTPUT_TYPE_MASK             0x02
+#define BMX160_INT1_OUTPUT_EN_MASK               0x08
+#define BMX160_INT2_EDGE_CTRL_MASK               0x10
+#define BMX160_INT2_OUTPUT_TYPE_MASK             0x20
+#define BMX160_INT2_OUTPUT_EN_MASK               0x80
+#define BMX160_INT1_DATA_READY_MASK              0x80
+#define BMX160_INT2_DATA_READY_MASK              0x08
+
+/** Fast offset compensation */
+#define BMX160_FOC_ACCEL_DISABLED                0x00
+#define BMX160_FOC_ACCEL_POSITIVE_G              0x01
+#define BMX160_FOC_ACCEL_NEGATIVE_G              0x02
+#define BMX160_FOC_ACCEL_0G                      0x03
+#define BMX160_GYRO_FOC_EN_MASK                  0x40
+#define BMX160_FOC_STATUS_MASK                   0x08
+#define BMX160_GYRO_OFFSET_EN_MASK               0x80
+#define BMX160_ACCEL_OFFSET_EN_MASK              0x40
+
+#define BMX160_MAGN_UT_LSB                       (0.3F)   ///< uT per LSB
+#define BMX160_GRAVITY                           (9.80665F)
+#define BMX160_SENSORTIME_WRAP                   0x1000000 ///< SENSORTIME counts 39.0625 us ticks in 24 bit
+
+/**
+ * @struct sBmx160SensorData_t
+ * @brief One sample of a sensor, in uT, dps or m/s²
+ */
+typedef struct {
+  float x;
+  float y;
+  float z;
+}sBmx160SensorData_t;
+
+/**
+ * @enum eGyroRange_t
+ * @brief Gyro ranges, the value is the GYR_RANGE register code
+ */
+typedef enum{
+    eGyroRange_2000DPS,
+    eGyroRange_1000DPS,
+    eGyroRange_500DPS,
+    eGyroRange_250DPS,
+    eGyroRange_125DPS
+}eGyroRange_t;
+
+/**
+ * @enum eAccelRange_t
+ * @brief Accel ranges
+ */
+typedef enum{
+    eAccelRange_2G,
+    eAccelRange_4G,
+    eAccelRange_8G,
+    eAccelRange_16G
+}eAccelRange_t;
+
+/**
+ * @enum eBmx160Channel_t
+ * @brief Sensor channels of getData(), combine with |
+ */
+typedef enum{
+    eBmx160ChannelMagn  = 0x01,  /**< Magnetometer, registers 0x04-0x09 */
+    eBmx160ChannelGyro  = 0x02,  /**< Gyroscope, registers 0x0C-0x11 */
+    eBmx160ChannelAccel = 0x04,  /**< Accelerometer, registers 0x12-0x17 */
+    eBmx160ChannelTime  = 0x08   /**< SENSORTIME, registers 0x18-0x1A, latched with the data of the same burst */
+}eBmx160Channel_t;
+
+/**
+ * @enum eBmx160IntPin_t
+ * @brief Interrupt output pins of the sensor
+ */
+typedef enum{
+    eBmx160Int1 = 1,  /**< INT1 */
+    eBmx160Int2 = 2   /**< INT2 */
+}eBmx160IntPin_t;
+
+/** ACC_RANGE register code of a range */
+constexpr uint8_t bmx160AccelRangeReg(eAccelRange_t range) {
+    return range == eAccelRange_2G ? 0x03 : range == eAccelRange_4G ? 0x05 : range == eAccelRange_8G ? 0x08 : 0x0C;
+}
+/** m/s² per LSB, 16384 LSB/g at +-2 g */
+constexpr float bmx160AccelScale(eAccelRange_t range) {
+    return BMX160_GRAVITY / (16384 >> (int)range);
+}
+/** dps per LSB, 16.4 LSB/dps at +-2000 dps */
+constexpr float bmx160GyroScale(eGyroRange_t range) {
+    return 1.0f / (16.4f * (1 << (int)range));
+}
+
+/**
+ * @struct BMX160Config
+ * @brief Compile-time sensor configuration, written to the sensor by begin()/pollBegin()
+ */
+template <eAccelRange_t AccelRange, eGyroRange_t GyroRange,
+          uint8_t AccelOdr = BMX160_ACCEL_ODR_100HZ, uint8_t GyroOdr = BMX160_GYRO_ODR_100HZ>
+struct BMX160Config {
+    static_assert(AccelOdr >= BMX160_ACCEL_ODR_12_5HZ && AccelOdr <= BMX160_ACCEL_ODR_1600HZ, "accel ODR out of range");
+    static_assert(GyroOdr >= BMX160_GYRO_ODR_25HZ && GyroOdr <= BMX160_GYRO_ODR_3200HZ, "gyro ODR out of range");
+
+    static constexpr uint8_t accelRangeReg = bmx160AccelRangeReg(AccelRange);
+    static constexpr uint8_t gyroRangeReg = (uint8_t)GyroRange;
+    // acc_bwp and gyr_bwp in bits 4-6, normal filter mode
+    static constexpr uint8_t accelConf = (BMX160_ACCEL_BW_NORMAL_AVG4 << 4) | AccelOdr;
+    static constexpr uint8_t gyroConf = (BMX160_GYRO_BW_NORMAL_MODE << 4) | GyroOdr;
+    static constexpr float accelScale = bmx160AccelScale(AccelRange);
+    static constexpr float gyroScale = bmx160GyroScale(GyroRange);
+};
+
+template <class Bus, class Config>
+class BMX160 {
+public:
+    typedef Config config;
+
+    explicit BMX160(Bus &bus, uint8_t addr = BMX160_I2C_ADDR) : _bus(bus), _addr(addr) {}
+
+    /**
+     * @fn begin
+     * @brief initialize the sensor and apply Config, waits about 0.3 s
+     * @return false if the sensor does not answer or is not a BMX160
+     */
+    bool begin() {
+        if (!beginAsync()) return false;
+        while (!pollBegin()) delay(1);
+        return _lastError == BMX160_OK;
+    }
+
+    /**
+     * @fn beginAsync
+     * @brief start the initialization of begin() without waiting, finish it with pollBegin().
+     * @return false if the sensor does not answer or is not a BMX160
+     */
+    bool beginAsync() {
+        _bus.begin();
+        _bus.setClock(400000);
+        if (!scan()) return false;
+        writeReg(BMX160_COMMAND_REG_ADDR, BMX160_SOFT_RESET_CMD);
+        _beginDue = millis() + BMX160_SOFT_RESET_DELAY_MS;
+        _beginStep = 1;
+        _timeStarted = false;
+        return true;
+    }
+
+    /**
+     * @fn pollBegin
+     * @brief run the next initialization step once the start-up time of the previous one has passed.
+     * @return true when the sensor is initialized, false while steps are pending
+     */
+    bool pollBegin() {
+        if (_beginStep == 0) return true;
+        if ((long)(millis() - _beginDue) < 0) return false;
+
+        // The accel wait is its 3.8 ms start-up time, the gyro needs 80 ms
+        switch (_beginStep) {
+        case 1:
+            writeReg(BMX160_COMMAND_REG_ADDR, BMX160_ACCEL_NORMAL_MODE);
+            _beginDue = millis() + 5;
+            break;
+        case 2:
+            writeReg(BMX160_COMMAND_REG_ADDR, BMX160_GYRO_NORMAL_MODE);
+            _beginDue = millis() + 100;
+            break;
+        case 3:
+            writeReg(BMX160_COMMAND_REG_ADDR, BMX160_MAGN_NORMAL_MODE);
+            _beginDue = millis() + 10;
+            break;
+        case 4:
+            writeReg(BMX160_MAGN_IF_0_ADDR, 0x80); // Magnetometer interface setup mode
+            _beginDue = millis() + 50;
+            break;
+        case 5:
+            // BMM150: sleep mode, regular preset (REPXY, REPZ), then data mode at 100 Hz
+            writeReg(BMX160_MAGN_IF_3_ADDR, 0x01);
+            writeReg(BMX160_MAGN_IF_2_ADDR, 0x4B);
+            writeReg(BMX160_MAGN_IF_3_ADDR, 0x04);
+            writeReg(BMX160_MAGN_IF_2_ADDR, 0x51);
+            writeReg(BMX160_MAGN_IF_3_ADDR, 0x0E);
+            writeReg(BMX160_MAGN_IF_2_ADDR, 0x52);
+            writeReg(BMX160_MAGN_IF_3_ADDR, 0x02);
+            writeReg(BMX160_MAGN_IF_2_ADDR, 0x4C);
+            writeReg(BMX160_MAGN_IF_1_ADDR, 0x42);
+            writeReg(BMX160_MAGN_CONFIG_ADDR, 0x08);
+            writeReg(BMX160_MAGN_IF_0_ADDR, 0x03);
+            _beginDue = millis() + 50;
+            break;
+        case 6:
+            writeReg(BMX160_ACCEL_RANGE_ADDR, Config::accelRangeReg);
+            writeReg(BMX160_GYRO_RANGE_ADDR, Config::gyroRangeReg);
+            writeReg(BMX160_ACCEL_CONFIG_ADDR, Config::accelConf);
+            writeReg(BMX160_GYRO_CONFIG_ADDR, Config::gyroConf);
+            _beginDue = millis();
+            break;
+        default:
+            _beginStep = 0;
+            return true;
+        }
+        _beginStep++;
+        return false;
+    }
+
+    /**
+     * @fn getData
+     * @brief read only the selected channels, in one burst over the contiguous register span
+     * @n     they cover (gyro + accel: 12 bytes, magn: 6 bytes, all three: 20 bytes,
+     * @n     gyro + accel + time: 15 bytes). eBmx160ChannelTime advances getSensorTime().
+     * @param channels eBmx160Channel_t values combined with |
+     * @return false if the transfer failed, the outputs are left unchanged then
+     */
+    bool getData(uint8_t channels, sBmx160SensorData_t *magn, sBmx160SensorData_t *gyro, sBmx160SensorData_t *accel) {
+        // Span from the first to the last selected channel, 6 bytes each except the 2 RHALL
+        // bytes between magn and gyro, SENSORTIME (3 bytes) follows the accel data
+        uint8_t first, last;
+        if (channels & eBmx160ChannelMagn) first = BMX160_MAG_DATA_ADDR;
+        else if (channels & eBmx160ChannelGyro) first = BMX160_GYRO_DATA_ADDR;
+        else if (channels & eBmx160ChannelAccel) first = BMX160_ACCEL_DATA_ADDR;
+        else if (channels & eBmx160ChannelTime) first = BMX160_SENSORTIME_ADDR;
+        else return true;
+        if (channels & eBmx160ChannelTime) last = BMX160_SENSORTIME_ADDR + 3;
+        else if (channels & eBmx160ChannelAccel) last = BMX160_ACCEL_DATA_ADDR + 6;
+        else if (channels & eBmx160ChannelGyro) last = BMX160_GYRO_DATA_ADDR + 6;
+        else last = BMX160_MAG_DATA_ADDR + 6;
+
+        uint8_t data[23];
+        if (readReg(first, data, last - first) != BMX160_OK) return false;
+        if ((channels & eBmx160ChannelMagn) && magn) {
+            decode(data + (BMX160_MAG_DATA_ADDR - first), BMX160_MAGN_UT_LSB, magn);
+        }
+        if ((channels & eBmx160ChannelGyro) && gyro) {
+            decode(data + (BMX160_GYRO_DATA_ADDR - first), Config::gyroScale, gyro);
+        }
+        if ((channels & eBmx160ChannelAccel) && accel) {
+            decode(data + (BMX160_ACCEL_DATA_ADDR - first), Config::accelScale, accel);
+        }
+        if (channels & eBmx160ChannelTime) {
+            const uint8_t *d = data + (BMX160_SENSORTIME_ADDR - first);
+            extendSensorTime(((uint32_t)d[2] << 16) | ((uint32_t)d[1] << 8) | d[0]);
+        }
+        return true;
+    }
+
+    /**
+     * @fn getAllData
+     * @brief get the magn, gyro and accel data, NULL skips a sensor
+     */
+    bool getAllData(sBmx160SensorData_t *magn, sBmx160SensorData_t *gyro, sBmx160SensorData_t *accel) {
+        return getData(eBmx160ChannelMagn | eBmx160ChannelGyro | eBmx160ChannelAccel, magn, gyro, accel);
+    }
+    bool getGyroACC(sBmx160SensorData_t *gyro, sBmx160SensorData_t *accel) {
+        return getData(eBmx160ChannelGyro | eBmx160ChannelAccel, NULL, gyro, accel);
+    }
+
+    /**
+     * @fn getSensorTime
+     * @brief sensor clock in us at the last read with eBmx160ChannelTime.
+     * @n     The 24 bit SENSORTIME (39.0625 us per LSB) wraps every 655 s, it is extended
+     * @n     to 64 bit. Wraps between two reads are counted with micros(), so reads may be
+     * @n     up to 71 min apart (e.g. a long stop between runs).
+     * @return microseconds since the first timed read
+     */
+    uint64_t getSensorTime() const {
+        return (_timeTicks * 625) >> 4; // 39.0625 us = 625/16 us per tick
+    }
+
+    /**
+     * @fn enableDataReadyInterrupt
+     * @brief route the data ready interrupt to a pin: push-pull, active high, edge output.
+     * @n     The pin pulses once per new accel/gyro sample, at the output data rate.
+     */
+    bool enableDataReadyInterrupt(eBmx160IntPin_t pin) {
+        uint8_t outCtrl, map, enable;
+        if (readReg(BMX160_INT_OUT_CTRL_ADDR, &outCtrl, 1) != BMX160_OK ||
+            readReg(BMX160_INT_MAP_1_ADDR, &map, 1) != BMX160_OK ||
+            readReg(BMX160_INT_ENABLE_1_ADDR, &enable, 1) != BMX160_OK) {
+            return false;
+        }
+        if (pin == eBmx160Int1) {
+            // INT1 is the low nibble, INT2 the high nibble
+            outCtrl = (outCtrl & 0xF0) | BMX160_INT1_OUTPUT_EN_MASK | BMX160_INT1_OUTPUT_TYPE_MASK | BMX160_INT1_EDGE_CTRL_MASK;
+            map |= BMX160_INT1_DATA_READY_MASK;
+        } else {
+            outCtrl = (outCtrl & 0x0F) | BMX160_INT2_OUTPUT_EN_MASK | BMX160_INT2_OUTPUT_TYPE_MASK | BMX160_INT2_EDGE_CTRL_MASK;
+            map |= BMX160_INT2_DATA_READY_MASK;
+        }
+        return writeReg(BMX160_INT_OUT_CTRL_ADDR, outCtrl) == BMX160_OK &&
+               writeReg(BMX160_INT_LATCH_ADDR, 0x00) == BMX160_OK && // Non-latched, no status read needed
+               writeReg(BMX160_INT_MAP_1_ADDR, map) == BMX160_OK &&
+               writeReg(BMX160_INT_ENABLE_1_ADDR, enable | BMX160_DATA_RDY_INT_EN_MASK) == BMX160_OK;
+    }
+
+    /**
+     * @fn disableDataReadyInterrupt
+     * @brief stop the data ready interrupt and disable both interrupt outputs
+     */
+    bool disableDataReadyInterrupt() {
+        uint8_t enable;
+        if (readReg(BMX160_INT_ENABLE_1_ADDR, &enable, 1) != BMX160_OK) return false;
+        return writeReg(BMX160_INT_ENABLE_1_ADDR, enable & ~BMX160_DATA_RDY_INT_EN_MASK) == BMX160_OK &&
+               writeReg(BMX160_INT_MAP_1_ADDR, 0x00) == BMX160_OK &&
+               writeReg(BMX160_INT_OUT_CTRL_ADDR, 0x00) == BMX160_OK;
+    }
+
+    /**
+     * @fn startFOC
+     * @brief start the on-chip fast offset compensation, the sensor has to lie still.
+     * @n     Takes up to 250 ms, poll focReady(). The offsets are written to registers
+     * @n     0x71-0x77, enableOffsets() makes the sensor subtract them from its data.
+     * @param gyro   compensate the gyro towards 0 dps
+     * @param accelX BMX160_FOC_ACCEL_xxx target of the x axis (0g, +1g, -1g or disabled)
+     */
+    bool startFOC(bool gyro, uint8_t accelX, uint8_t accelY, uint8_t accelZ) {
+        uint8_t conf = (gyro ? BMX160_GYRO_FOC_EN_MASK : 0) | ((accelX & 0x03) << 4) |
+                       ((accelY & 0x03) << 2) | (accelZ & 0x03);
+        return writeReg(BMX160_FOC_CONF_ADDR, conf) == BMX160_OK &&
+               writeReg(BMX160_COMMAND_REG_ADDR, BMX160_START_FOC_CMD) == BMX160_OK;
+    }
+
+    /**
+     * @fn focReady
+     * @brief whether the fast offset compensation started by startFOC() has finished
+     */
+    bool focReady() {
+        uint8_t status = 0;
+        return readReg(BMX160_STATUS_ADDR, &status, 1) == BMX160_OK && (status & BMX160_FOC_STATUS_MASK);
+    }
+
+    /**
+     * @fn enableOffsets
+     * @brief let the sensor subtract the offset registers from the gyro and accel data
+     */
+    bool enableOffsets(bool gyro, bool accel) {
+        uint8_t conf = 0;
+        if (readReg(BMX160_OFFSET_CONF_ADDR, &conf, 1) != BMX160_OK) return false;
+        conf &= ~(BMX160_GYRO_OFFSET_EN_MASK | BMX160_ACCEL_OFFSET_EN_MASK);
+        if (gyro) conf |= BMX160_GYRO_OFFSET_EN_MASK;
+        if (accel) conf |= BMX160_ACCEL_OFFSET_EN_MASK;
+        return writeReg(BMX160_OFFSET_CONF_ADDR, conf) == BMX160_OK;
+    }
+
+    /**
+     * @fn getOffsets
+     * @brief raw offset registers, accel 3.9 mg per LSB, gyro 0.061 dps per LSB (10 bit)
+     */
+    bool getOffsets(int8_t accel[3], int16_t gyro[3]) {
+        uint8_t data[7];
+        if (readReg(BMX160_OFFSET_ADDR, data, 7) != BMX160_OK) return false;
+        for (int i = 0; i < 3; i++) {
+            accel[i] = (int8_t)data[i];
+            // 8 low bits in 0x74-0x76, bits 8-9 of x, y, z in 0x77 bits 0-1, 2-3, 4-5
+            gyro[i] = data[3 + i] | (((data[6] >> (2 * i)) & 0x03) << 8);
+            if (gyro[i] & 0x200) gyro[i] -= 0x400; // 10 bit two's complement
+        }
+        return true;
+    }
+
+    /// @brief Result of the last transfer, BMX160_OK or BMX160_E_xxx
+    int8_t lastError() const { return _lastError; }
+    /// @brief Failed transfers since construction
+    uint32_t errorCount() const { return _errors; }
+
+private:
+    static void decode(const uint8_t *d, float scale, sBmx160SensorData_t *out) {
+        out->x = (int16_t)(((uint16_t)d[1] << 8) | d[0]) * scale;
+        out->y = (int16_t)(((uint16_t)d[3] << 8) | d[2]) * scale;
+        out->z = (int16_t)(((uint16_t)d[5] << 8) | d[4]) * scale;
+    }
+
+    void extendSensorTime(uint32_t raw) {
+        uint32_t now = micros();
+        if (_timeStarted) {
+            uint32_t delta = (raw - _timeRaw) & (BMX160_SENSORTIME_WRAP - 1); // Correct across one wrap
+            // Whole wraps since the last read, from the MCU clock (its drift is far below 655 s)
+            uint64_t expected = (uint64_t)(now - _timeMicros) * 16 / 625;
+            uint64_t wraps = expected > delta ? (expected - delta + BMX160_SENSORTIME_WRAP / 2) >> 24 : 0;
+            _timeTicks += (wraps << 24) + delta;
+        }
+        _timeRaw = raw;
+        _timeMicros = now;
+        _timeStarted = true;
+    }
+
+    bool scan() {
+        uint8_t id = 0;
+        if (readReg(BMX160_CHIP_ID_ADDR, &id, 1) != BMX160_OK) return false;
+        if (id != BMX160_CHIP_ID) {
+            fail(BMX160_E_DEV_NOT_FOUND);
+            return false;
+        }
+        return true;
+    }
+
+    int8_t fail(int8_t error) {
+        _lastError = error;
+        _errors++;
+        return error;
+    }
+
+    int8_t writeReg(uint8_t reg, uint8_t value) {
+        _bus.beginTransmission(_addr);
+        _bus.write(reg);
+        _bus.write(value);
+        if (_bus.endTransmission() != 0) return fail(BMX160_E_COM_FAIL);
+        return _lastError = BMX160_OK;
+    }
+
+    int8_t readReg(uint8_t reg, uint8_t *buf, uint8_t len) {
+        _bus.beginTransmission(_addr);
+        _bus.write(reg);
+        if (_bus.endTransmission() != 0) return fail(BMX160_E_COM_FAIL);
+        if (_bus.requestFrom(_addr, len) != len) return fail(BMX160_E_COM_FAIL);
+        for (uint8_t i = 0; i < len; i++) {
+            if (!_bus.available()) return fail(BMX160_E_COM_FAIL);
+            buf[i] = _bus.read();
+        }
+        return _lastError = BMX160_OK;
+    }
+
+    Bus &_bus;
+    const uint8_t _addr;
+    int8_t _lastError = BMX160_OK;
+    uint32_t _errors = 0;
+    uint8_t _beginStep = 0;       // Next step of beginAsync(), 0 when idle
+    unsigned long _beginDue = 0;  // millis() when the next step may run
+    uint32_t _timeRaw = 0;        // Last SENSORTIME value (24 bit)
+    uint32_t _timeMicros = 0;     // micros() at that read
+    uint64_t _timeTicks = 0;      // SENSORTIME ticks since the first timed read
+    bool _timeStarted = false;
+};
+
+#endif // BMX160_H
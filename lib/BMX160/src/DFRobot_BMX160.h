@@ -0,0 +1,18 @@
+/*!
+ * @file DFRobot_BMX160.h
+ * @brief The BMX160 on Wire as the sketches use it: +-2 g, +-500 dps, 100 Hz
+ */
+#ifndef DFROBOT_BMX160_H
+#define DFROBOT_BMX160_H
+
+#include <Wire.h>
+#include "BMX160.h"
+
+typedef BMX160Config<eAccelRange_2G, eGyroRange_500DPS, BMX160_ACCEL_ODR_100HZ, BMX160_GYRO_ODR_100HZ> DFRobot_BMX160_Config;
+
+class DFRobot_BMX160 : public BMX160<TwoWire, DFRobot_BMX160_Config> {
+public:
+    explicit DFRobot_BMX160(TwoWire *pWire = &Wire) : BMX160<TwoWire, DFRobot_BMX160_Config>(*pWire) {}
+};
+
+#endif // DFROBOT_BMX160_H
@@ -0,0 +1,20 @@
+/*
+ * Arduino stand-in for the BMX160 host test. Time is simulated: it only advances
+ * through delay() and sim_advance_us(), so start-up waits and wraps run instantly.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+extern uint64_t sim_now_us;
+
+inline unsigned long micros() { return (unsigned long)(uint32_t)sim_now_us; }
+inline unsigned long millis() { return (unsigned long)(uint32_t)(sim_now_us / 1000); }
+inline void delay(unsigned long ms) { sim_now_us += (uint64_t)ms * 1000; }
+inline void sim_advance_us(uint64_t us) { sim_now_us += us; }
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,244 @@
+// Host test of BMX160<Bus, Config> against a simulated BMX160 register file.
+// Build and run: make test
+
+#include <math.h>
+#include <stdio.h>
+
+#include "BMX160.h"
+
+uint64_t sim_now_us = 0;
+
+// Wire-like bus with one BMX160 behind it: the first written byte sets the register
+// pointer, further bytes and reads auto-increment it. Faults are injected per test.
+class SimBus {
+public:
+    uint8_t regs[128];
+    uint8_t addr = BMX160_I2C_ADDR;
+    bool nack = false;           // endTransmission() fails
+    uint8_t shortRead = 0;       // requestFrom() returns this many bytes less
+    uint32_t writes = 0;
+
+    SimBus() { reset(); }
+
+    void reset() {
+        memset(regs, 0, sizeof(regs));
+        regs[BMX160_CHIP_ID_ADDR] = BMX160_CHIP_ID;
+        regs[BMX160_ACCEL_RANGE_ADDR] = 0x03; // Power-on defaults: +-2 g, +-2000 dps
+        regs[BMX160_GYRO_RANGE_ADDR] = 0x00;
+    }
+
+    void begin() {}
+    void setClock(uint32_t) {}
+    void beginTransmission(uint8_t address) { _target = address; _count = 0; }
+    size_t write(uint8_t value) {
+        if (_count++ == 0) {
+            _ptr = value;
+        } else {
+            store(_ptr++, value);
+        }
+        return 1;
+    }
+    uint8_t endTransmission() { return (nack || _target != addr) ? 2 : 0; }
+    uint8_t requestFrom(uint8_t address, uint8_t len) {
+        if (address != addr) return 0;
+        _available = len > shortRead ? len - shortRead : 0;
+        return _available;
+    }
+    int available() { return _available; }
+    int read() {
+        if (_available == 0) return -1;
+        _available--;
+        return regs[_ptr++ & 0x7F];
+    }
+
+private:
+    void store(uint8_t reg, uint8_t value) {
+        writes++;
+        if (reg == BMX160_COMMAND_REG_ADDR) {
+            if (value == BMX160_SOFT_RESET_CMD) reset();
+            if (value == BMX160_START_FOC_CMD) regs[BMX160_STATUS_ADDR] |= BMX160_FOC_STATUS_MASK;
+            return;
+        }
+        regs[reg & 0x7F] = value;
+    }
+
+    uint8_t _target = 0;
+    uint8_t _ptr = 0;
+    uint8_t _count = 0;
+    uint8_t _available = 0;
+};
+
+typedef BMX160Config<eAccelRange_2G, eGyroRange_500DPS> DefaultConfig;
+typedef BMX160Config<eAccelRange_8G, eGyroRange_2000DPS, BMX160_ACCEL_ODR_200HZ, BMX160_GYRO_ODR_400HZ> FastConfig;
+
+// Scale factors are constants of the configuration
+static_assert(DefaultConfig::accelRangeReg == 0x03 && FastConfig::accelRangeReg == 0x08, "accel range code");
+static_assert(DefaultConfig::gyroRangeReg == 0x02 && FastConfig::gyroRangeReg == 0x00, "gyro range code");
+static_assert(DefaultConfig::accelScale * 16384 > 9.806f && DefaultConfig::accelScale * 16384 < 9.807f, "accel scale");
+static_assert(FastConfig::gyroScale * 16.4f > 0.9999f && FastConfig::gyroScale * 16.4f < 1.0001f, "gyro scale");
+static_assert(FastConfig::accelConf == 0x29 && FastConfig::gyroConf == 0x2A, "ODR config");
+
+static int failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+static bool near(float a, float b, float tol) { return fabsf(a - b) <= tol; }
+
+static void setRaw(SimBus &bus, uint8_t reg, int16_t x, int16_t y, int16_t z) {
+    const int16_t v[3] = {x, y, z};
+    for (int i = 0; i < 3; i++) {
+        bus.regs[reg + 2 * i] = (uint8_t)(v[i] & 0xFF);
+        bus.regs[reg + 2 * i + 1] = (uint8_t)((uint16_t)v[i] >> 8);
+    }
+}
+
+static void setSensorTime(SimBus &bus, uint32_t ticks) {
+    bus.regs[BMX160_SENSORTIME_ADDR] = ticks & 0xFF;
+    bus.regs[BMX160_SENSORTIME_ADDR + 1] = (ticks >> 8) & 0xFF;
+    bus.regs[BMX160_SENSORTIME_ADDR + 2] = (ticks >> 16) & 0xFF;
+}
+
+static void testBeginAppliesConfig() {
+    SimBus bus;
+    BMX160<SimBus, DefaultConfig> imu(bus);
+    CHECK(imu.begin());
+    CHECK(bus.regs[BMX160_ACCEL_RANGE_ADDR] == 0x03);
+    CHECK(bus.regs[BMX160_GYRO_RANGE_ADDR] == 0x02);
+    CHECK(bus.regs[BMX160_ACCEL_CONFIG_ADDR] == 0x28);
+    CHECK(bus.regs[BMX160_GYRO_CONFIG_ADDR] == 0x28);
+    CHECK(imu.errorCount() == 0);
+
+    SimBus fastBus;
+    BMX160<SimBus, FastConfig> fast(fastBus);
+    CHECK(fast.begin());
+    CHECK(fastBus.regs[BMX160_ACCEL_RANGE_ADDR] == 0x08);
+    CHECK(fastBus.regs[BMX160_GYRO_RANGE_ADDR] == 0x00);
+    CHECK(fastBus.regs[BMX160_ACCEL_CONFIG_ADDR] == 0x29);
+    CHECK(fastBus.regs[BMX160_GYRO_CONFIG_ADDR] == 0x2A);
+}
+
+static void testBeginReportsMissingSensor() {
+    SimBus bus;
+    bus.nack = true;
+    BMX160<SimBus, DefaultConfig> imu(bus);
+    CHECK(!imu.begin());
+    CHECK(imu.lastError() == BMX160_E_COM_FAIL);
+
+    SimBus other;
+    other.regs[BMX160_CHIP_ID_ADDR] = 0xD1; // BMI160
+    BMX160<SimBus, DefaultConfig> wrong(other);
+    CHECK(!wrong.begin());
+    CHECK(wrong.lastError() == BMX160_E_DEV_NOT_FOUND);
+    CHECK(other.writes == 0);
+}
+
+static void testConversion() {
+    SimBus bus;
+    BMX160<SimBus, DefaultConfig> imu(bus);
+    CHECK(imu.begin());
+    setRaw(bus, BMX160_GYRO_DATA_ADDR, 3280, -3280, 0);   // 65.6 LSB/dps at +-500 dps
+    setRaw(bus, BMX160_ACCEL_DATA_ADDR, 0, -8192, 16384); // 16384 LSB/g at +-2 g
+    setRaw(bus, BMX160_MAG_DATA_ADDR, 100, 0, -100);
+
+    sBmx160SensorData_t magn, gyro, accel;
+    CHECK(imu.getAllData(&magn, &gyro, &accel));
+    CHECK(near(gyro.x, 50.0f, 1e-3f) && near(gyro.y, -50.0f, 1e-3f) && gyro.z == 0);
+    CHECK(near(accel.y, -4.903325f, 1e-4f) && near(accel.z, 9.80665f, 1e-4f));
+    CHECK(near(magn.x, 30.0f, 1e-4f) && near(magn.z, -30.0f, 1e-4f));
+}
+
+static void testErrorsLeaveOutputs() {
+    SimBus bus;
+    BMX160<SimBus, DefaultConfig> imu(bus);
+    CHECK(imu.begin());
+    setRaw(bus, BMX160_GYRO_DATA_ADDR, 1000, 1000, 1000);
+
+    sBmx160SensorData_t gyro = {1, 2, 3}, accel = {4, 5, 6};
+    bus.shortRead = 1;
+    CHECK(!imu.getGyroACC(&gyro, &accel));
+    CHECK(gyro.x == 1 && gyro.z == 3 && accel.x == 4 && accel.z == 6);
+    CHECK(imu.lastError() == BMX160_E_COM_FAIL && imu.errorCount() == 1);
+
+    bus.shortRead = 0;
+    bus.nack = true;
+    CHECK(!imu.getGyroACC(&gyro, &accel));
+    CHECK(!imu.focReady());
+    CHECK(gyro.x == 1 && imu.errorCount() == 3);
+
+    bus.nack = false;
+    CHECK(imu.getGyroACC(&gyro, &accel));
+    CHECK(gyro.x != 1 && imu.lastError() == BMX160_OK);
+}
+
+static void testSensorTime() {
+    SimBus bus;
+    BMX160<SimBus, DefaultConfig> imu(bus);
+    CHECK(imu.begin());
+    sBmx160SensorData_t gyro, accel;
+
+    uint32_t ticks = 0xFFFF00; // Just before a wrap
+    setSensorTime(bus, ticks);
+    CHECK(imu.getData(eBmx160ChannelGyro | eBmx160ChannelAccel | eBmx160ChannelTime, NULL, &gyro, &accel));
+    CHECK(imu.getSensorTime() == 0);
+
+    // 10 ms later, across the wrap
+    sim_advance_us(10000);
+    ticks += 256;
+    setSensorTime(bus, ticks);
+    CHECK(imu.getData(eBmx160ChannelTime, NULL, NULL, NULL));
+    CHECK(imu.getSensorTime() == 10000);
+
+    // 30 min later, several wraps of 655 s in between
+    const uint64_t gap_us = 1800000000ULL;
+    sim_advance_us(gap_us);
+    ticks += (uint32_t)(gap_us * 16 / 625);
+    setSensorTime(bus, ticks);
+    CHECK(imu.getData(eBmx160ChannelTime, NULL, NULL, NULL));
+    CHECK(imu.getSensorTime() == 10000 + gap_us);
+}
+
+static void testInterruptAndOffsets() {
+    SimBus bus;
+    BMX160<SimBus, DefaultConfig> imu(bus);
+    CHECK(imu.begin());
+
+    CHECK(imu.enableDataReadyInterrupt(eBmx160Int1));
+    CHECK(bus.regs[BMX160_INT_OUT_CTRL_ADDR] == 0x0B);
+    CHECK(bus.regs[BMX160_INT_MAP_1_ADDR] == BMX160_INT1_DATA_READY_MASK);
+    CHECK(bus.regs[BMX160_INT_ENABLE_1_ADDR] == BMX160_DATA_RDY_INT_EN_MASK);
+    CHECK(imu.disableDataReadyInterrupt());
+    CHECK(bus.regs[BMX160_INT_OUT_CTRL_ADDR] == 0 && bus.regs[BMX160_INT_ENABLE_1_ADDR] == 0);
+
+    CHECK(!imu.focReady());
+    CHECK(imu.startFOC(true, BMX160_FOC_ACCEL_0G, BMX160_FOC_ACCEL_0G, BMX160_FOC_ACCEL_POSITIVE_G));
+    CHECK(bus.regs[BMX160_FOC_CONF_ADDR] == 0x7D);
+    CHECK(imu.focReady());
+
+    bus.regs[BMX160_OFFSET_ADDR] = 0xFE;         // accel x -2
+    bus.regs[BMX160_OFFSET_ADDR + 3] = 0x05;     // gyro x low byte
+    bus.regs[BMX160_OFFSET_ADDR + 4] = 0xFF;     // gyro y low byte
+    bus.regs[BMX160_OFFSET_CONF_ADDR] = 0x0C;    // gyro y bits 8-9 set: -1
+    CHECK(imu.enableOffsets(true, true));
+    CHECK(bus.regs[BMX160_OFFSET_CONF_ADDR] == 0xCC);
+
+    int8_t accel[3];
+    int16_t gyro[3];
+    CHECK(imu.getOffsets(accel, gyro));
+    CHECK(accel[0] == -2 && gyro[0] == 5 && gyro[1] == -1 && gyro[2] == 0);
+}
+
+int main() {
+    testBeginAppliesConfig();
+    testBeginReportsMissingSensor();
+    testConversion();
+    testErrorsLeaveOutputs();
+    testSensorTime();
+    testInterruptAndOffsets();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("bmx160_sim_test: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * I2C bus benchmark protocol, shared by i2c_basic_test/simplei2c_master (R4), simplei2c_slave
+ * (Nano) and the host simulation. Free of Wire, so the slave's onReceive/onRequest and the
+ * host's virtual device answer with the same bytes.
+ *
+ * Frame layouts, the first byte of every master write is the command:
+ *   MU_PARAM     0x10 mode kp(2) ki(2) kd(2)       as the MU, nothing to read back
+ *   MU_SETPOINT  0x20 setpoint                     as the MU, read setpoint seq ~seq
+ *   BURST        0x21 setpoint(2) crc              read setpoint(2) value(2) current(2) crc
+ *   SINK         0x30 seq payload... crc           any length, checked by the slave
+ *   STREAM       0x31 length                       every following read: seq payload... crc
+ *   STATS        0x3F                              read frames(2) bad(2), then both restart
+ * Multi-byte values are big endian as in the MU's PID parameters, CRC-8 with polynomial 0x07.
+ */
+
+#ifndef I2C_BENCH_H
+#define I2C_BENCH_H
+
+#include <stdint.h>
+
+#define I2C_BENCH_ADDRESS 0x08      // MU0's address, the slave stands in for one MU
+#define I2C_BENCH_BUFFER 32         // Wire buffer of the AVR and of the R4
+
+#define I2C_BENCH_CMD_MU_PARAM 0x10
+#define I2C_BENCH_CMD_MU_SETPOINT 0x20
+#define I2C_BENCH_CMD_BURST 0x21
+#define I2C_BENCH_CMD_SINK 0x30
+#define I2C_BENCH_CMD_STREAM 0x31
+#define I2C_BENCH_CMD_STATS 0x3F
+
+#define I2C_BENCH_MU_PARAM_WRITE 8
+#define I2C_BENCH_MU_SETPOINT_WRITE 2
+#define I2C_BENCH_MU_REPLY 3
+#define I2C_BENCH_BURST_WRITE 4
+#define I2C_BENCH_BURST_REPLY 7
+#define I2C_BENCH_STATS_REPLY 4
+
+inline uint8_t i2cBenchCrc8(const uint8_t *data, uint8_t length) {
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/// @brief Payload byte i of a SINK or STREAM frame with sequence number seq
+inline uint8_t i2cBenchPattern(uint8_t seq, uint8_t i) {
+    return (uint8_t)(seq * 7 + i);
+}
+
+/// @brief Fill a SINK (after the command byte) or STREAM frame of length bytes: seq, payload, crc
+inline void i2cBenchFrame(uint8_t *frame, uint8_t length, uint8_t seq) {
+    if (length == 0) return;
+    frame[0] = seq;
+    for (uint8_t i = 1; i + 1 < length; i++) {
+        frame[i] = i2cBenchPattern(seq, i);
+    }
+    if (length > 1) frame[length - 1] = i2cBenchCrc8(frame, length - 1);
+}
+
+/// @brief True if a frame of i2cBenchFrame() arrived intact, its seq is frame[0]
+inline bool i2cBenchCheck(const uint8_t *frame, uint8_t length) {
+    if (length < 2) return true;
+    for (uint8_t i = 1; i + 1 < length; i++) {
+        if (frame[i] != i2cBenchPattern(frame[0], i)) return false;
+    }
+    return frame[length - 1] == i2cBenchCrc8(frame, length - 1);
+}
+
+/**
+ * @brief The slave's side: decodes master writes and prepares the reply to the next read.
+ *
+ * receive() and reply() are called from the slave's Wire callbacks, both in the TWI interrupt
+ * on the AVR, so no state is shared with loop(). The reply does not depend on the length the
+ * master asks for (the AVR's onRequest does not know it), a shorter read drops the tail.
+ */
+class I2CBenchResponder {
+public:
+    void receive(const uint8_t *data, uint8_t length) {
+        if (length == 0) return; // Address probe
+        _command = data[0];
+        bool good = true;
+        switch (_command) {
+            case I2C_BENCH_CMD_MU_PARAM:
+                good = length == I2C_BENCH_MU_PARAM_WRITE;
+                break;
+            case I2C_BENCH_CMD_MU_SETPOINT:
+                good = length == I2C_BENCH_MU_SETPOINT_WRITE;
+                if (good) _setpoint[0] = data[1];
+                break;
+            case I2C_BENCH_CMD_BURST:
+                good = length == I2C_BENCH_BURST_WRITE && data[3] == i2cBenchCrc8(data + 1, 2);
+                if (good) {
+                    _setpoint[0] = data[1];
+                    _setpoint[1] = data[2];
+                }
+                break;
+            case I2C_BENCH_CMD_SINK:
+                good = i2cBenchCheck(data + 1, length - 1);
+                break;
+            case I2C_BENCH_CMD_STREAM:
+                good = length == 2 && data[1] <= I2C_BENCH_BUFFER;
+                if (good) _streamLength = data[1];
+                break;
+            case I2C_BENCH_CMD_STATS:
+                return; // Not counted, it reads the counters
+            default:
+                good = false;
+                break;
+        }
+        _frames++;
+        if (!good) _bad++;
+    }
+
+    /// @brief Bytes for the master's read, returns how many (at most I2C_BENCH_BUFFER)
+    uint8_t reply(uint8_t *data) {
+        switch (_command) {
+            case I2C_BENCH_CMD_MU_PARAM:
+            case I2C_BENCH_CMD_MU_SETPOINT:
+                data[0] = _setpoint[0];
+                data[1] = _seq;
+                data[2] = (uint8_t)~_seq;
+                _seq++;
+                return I2C_BENCH_MU_REPLY;
+            case I2C_BENCH_CMD_BURST:
+                data[0] = _setpoint[0];
+                data[1] = _setpoint[1];
+                data[2] = (uint8_t)(_count >> 8);
+                data[3] = (uint8_t)_count;
+                data[4] = (uint8_t)(~_count >> 8);
+                data[5] = (uint8_t)~_count;
+                data[6] = i2cBenchCrc8(data, 6);
+                _count++;
+                return I2C_BENCH_BURST_REPLY;
+            case I2C_BENCH_CMD_STREAM:
+                i2cBenchFrame(data, _streamLength, _seq++);
+                return _streamLength;
+            case I2C_BENCH_CMD_STATS:
+                data[0] = (uint8_t)(_frames >> 8);
+                data[1] = (uint8_t)_frames;
+                data[2] = (uint8_t)(_bad >> 8);
+                data[3] = (uint8_t)_bad;
+                _frames = 0;
+                _bad = 0;
+                return I2C_BENCH_STATS_REPLY;
+            default:
+                data[0] = 0xFF; // As the MU in an unknown mode
+                return 1;
+        }
+    }
+
+private:
+    uint8_t _command = 0;
+    uint8_t _setpoint[2] = {0, 0};
+    uint8_t _streamLength = 0;
+    uint8_t _seq = 0;
+    uint16_t _count = 0;
+    uint16_t _frames = 0;
+    uint16_t _bad = 0;
+};
+
+#endif // I2C_BENCH_H